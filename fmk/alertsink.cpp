@@ -0,0 +1,243 @@
+/******************************************************************************
+ * File:    alertsink.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.AlertSink
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement AlertSink class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   Alert, DBHdlPostgreSQL
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "alertsink.h"
+
+#include "dbhdlpostgre.h"
+#include "except.h"
+#include "log.h"
+#include "str.h"
+
+#include <sstream>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+// Max. number of alerts waiting to be processed by the writer
+const size_t ALERT_QUEUE_SIZE         = 4096;
+
+// Period of the writer loop, and window in which identical alerts are
+// merged into one row
+const int    ALERT_FLUSH_PERIOD_MS    = 250;
+const int    ALERT_COALESCE_WINDOW_MS = 2000;
+
+// Max. number of rows per INSERT, and max. number of pending alerts
+// (when exceeded, all of them are flushed regardless of their window)
+const size_t ALERT_MAX_BATCH_SIZE     = 256;
+const size_t ALERT_MAX_PENDING        = 1024;
+
+//----------------------------------------------------------------------
+// Method: instance
+// Return the sink of the process, starting its writer on first use
+//----------------------------------------------------------------------
+AlertSink & AlertSink::instance()
+{
+    static AlertSink sink;
+    return sink;
+}
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+AlertSink::AlertSink()
+    : queue(ALERT_QUEUE_SIZE), dropped(0), uniqueId(0)
+{
+    thrId = std::thread(&AlertSink::run, this);
+    thrId.detach();
+}
+
+//----------------------------------------------------------------------
+// Method: store
+// Queue the alert for storage
+//----------------------------------------------------------------------
+bool AlertSink::store(const Alert & a)
+{
+    if (queue.push(a)) { return true; }
+    dropped++;
+    return false;
+}
+
+//----------------------------------------------------------------------
+// Method: run
+// Writer loop
+//----------------------------------------------------------------------
+void AlertSink::run()
+{
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ALERT_FLUSH_PERIOD_MS));
+        collect();
+        flush();
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: collect
+// Move the queued alerts to the pending set, coalescing them
+//----------------------------------------------------------------------
+void AlertSink::collect()
+{
+    Alert a;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    while (queue.pop(a)) {
+        std::string key = signature(a);
+        if (key.empty()) {
+            // Alerts with variables are always stored separately
+            key = "#" + std::to_string(uniqueId++);
+        }
+        std::map<std::string, Entry>::iterator it = pending.find(key);
+        if (it != pending.end()) {
+            it->second.repeats++;
+        } else {
+            pending[key] = {a, 1, now};
+        }
+    }
+
+    unsigned int numDropped = dropped.exchange(0);
+    if (numDropped > 0) {
+        Log::log(Log::System, Log::WARNING,
+                 std::to_string(numDropped) +
+                 " alerts discarded (alert queue is full)");
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: flush
+// Store the pending alerts whose coalescing window has expired
+//----------------------------------------------------------------------
+void AlertSink::flush()
+{
+    if (pending.empty()) { return; }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::milliseconds window(ALERT_COALESCE_WINDOW_MS);
+    bool flushAll = (pending.size() > ALERT_MAX_PENDING);
+
+    std::vector<Entry> batch;
+    std::map<std::string, Entry>::iterator it = pending.begin();
+    while (it != pending.end()) {
+        if (flushAll || ((now - it->second.first) >= window)) {
+            batch.push_back(it->second);
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::vector<Entry>::iterator from = batch.begin();
+    while (from != batch.end()) {
+        std::vector<Entry>::iterator to = from;
+        std::advance(to, std::min(ALERT_MAX_BATCH_SIZE,
+                                  (size_t)(std::distance(from, batch.end()))));
+        if (! writeBatch(from, to)) {
+            Log::log(Log::System, Log::ERROR,
+                     std::to_string(std::distance(from, to)) +
+                     " alerts could not be stored in the DB");
+        }
+        from = to;
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: writeBatch
+// Insert a set of alerts with a single multi-row INSERT
+//----------------------------------------------------------------------
+bool AlertSink::writeBatch(std::vector<Entry>::iterator from,
+                           std::vector<Entry>::iterator to)
+{
+    std::stringstream ss;
+    ss << "INSERT INTO alerts "
+       << "(alert_id, creation, grp, sev, typ, origin, msgs, file, var, repeats) "
+       << "VALUES ";
+    for (std::vector<Entry>::iterator it = from; it != to; ++it) {
+        Alert & a = it->alert;
+        if (it != from) { ss << ", "; }
+        ss << "( nextval('alerts_alert_id_seq'), "
+           << str::quoted(a.timeStampString()) << ", "
+           << str::quoted(Alert::GroupName[a.getGroup()]) << ", "
+           << str::quoted(Alert::SeverityName[a.getSeverity()]) << ", "
+           << str::quoted(Alert::TypeName[a.getType()]) << ", "
+           << str::quoted(a.getOrigin()) << ", "
+           << str::quoted(a.allMessages()) << ", "
+           << str::quoted(str::getBaseName(a.getFile())) << ", ";
+        if (a.getVar() != 0) { ss << a.varAsTuple(); } else { ss << "NULL"; }
+        ss << ", " << it->repeats << ")";
+    }
+    ss << ";";
+
+    // The connection is kept open between batches, and re-opened in the
+    // next batch after a failure
+    try {
+        if (! db) {
+            db.reset(new DBHdlPostgreSQL);
+            db->openConnection();
+        }
+        db->runCmd(ss.str());
+    } catch (RuntimeException & e) {
+        Log::log(Log::System, Log::ERROR, e.what());
+        // The handler already finished the connection on failure
+        db.reset();
+        return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: signature
+// Key used to identify identical alerts (empty if the alert holds a
+// variable, since these are never merged)
+//----------------------------------------------------------------------
+std::string AlertSink::signature(const Alert & a)
+{
+    if (a.getVar() != 0) { return std::string(); }
+    return (std::to_string(a.getGroup()) + "|" +
+            std::to_string(a.getSeverity()) + "|" +
+            std::to_string(a.getType()) + "|" +
+            a.getOrigin() + "|" + a.getFile() + "|" +
+            a.allMessages());
+}
+
+//}
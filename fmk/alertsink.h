@@ -0,0 +1,166 @@
+/******************************************************************************
+ * File:    alertsink.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.AlertSink
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare AlertSink class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   Alert, DBHdlPostgreSQL
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef ALERTSINK_H
+#define ALERTSINK_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - map
+//   - vector
+//   - memory
+//   - thread
+//   - atomic
+//   - chrono
+//------------------------------------------------------------
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - alert.h
+//   - bndqueue.h
+//   - dbhdl.h
+//------------------------------------------------------------
+#include "alert.h"
+#include "bndqueue.h"
+#include "dbhdl.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: AlertSink
+// Per-process store of alerts into the database.  Components only push
+// the alerts into a bounded queue; a background writer coalesces the
+// identical alerts raised within a time window into a single row (with
+// a repeat count) and stores them in batches, through one connection
+//==========================================================================
+class AlertSink {
+
+public:
+    //----------------------------------------------------------------------
+    // Method: instance
+    // Return the sink of the process, starting its writer on first use
+    //----------------------------------------------------------------------
+    static AlertSink & instance();
+
+    //----------------------------------------------------------------------
+    // Method: store
+    // Queue the alert for storage; returns false (and the alert is
+    // discarded) if the queue is full
+    //----------------------------------------------------------------------
+    bool store(const Alert & a);
+
+private:
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    AlertSink();
+
+    struct Entry {
+        Alert                                 alert;
+        int                                   repeats;
+        std::chrono::steady_clock::time_point first;
+    };
+
+    //----------------------------------------------------------------------
+    // Method: run
+    // Writer loop
+    //----------------------------------------------------------------------
+    void run();
+
+    //----------------------------------------------------------------------
+    // Method: collect
+    // Move the queued alerts to the pending set, coalescing them
+    //----------------------------------------------------------------------
+    void collect();
+
+    //----------------------------------------------------------------------
+    // Method: flush
+    // Store the pending alerts whose coalescing window has expired
+    //----------------------------------------------------------------------
+    void flush();
+
+    //----------------------------------------------------------------------
+    // Method: writeBatch
+    // Insert a set of alerts with a single multi-row INSERT
+    //----------------------------------------------------------------------
+    bool writeBatch(std::vector<Entry>::iterator from,
+                    std::vector<Entry>::iterator to);
+
+    //----------------------------------------------------------------------
+    // Method: signature
+    // Key used to identify identical alerts
+    //----------------------------------------------------------------------
+    static std::string signature(const Alert & a);
+
+private:
+    BoundedQueue<Alert>          queue;
+    std::map<std::string, Entry> pending;
+    std::unique_ptr<DBHandler>   db;
+    std::atomic<unsigned int>    dropped;
+    unsigned int                 uniqueId;
+    std::thread                  thrId;
+};
+
+//}
+
+#endif  /* ALERTSINK_H */
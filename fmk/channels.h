@@ -5,7 +5,10 @@
 
 #include "nncomm.h"
 
-#define CHNLS_IF_VERSION  "1.0"
+#define CHNLS_IF_VERSION  "1.1"
+
+// Lowest interface version able to exchange binary encoded messages
+#define CHNLS_IF_VERSION_BINARY  "1.1"
 
 #undef T
 
@@ -38,7 +41,7 @@ const ChannelDescriptor ChnlInData     (ChannelAcronym[TX_ID_INDATA]);
 const ChannelDescriptor ChnlTskSched   (ChannelAcronym[TX_ID_TSKSCHED]);
 const ChannelDescriptor ChnlTskProc    (ChannelAcronym[TX_ID_TSKPROC]);
 //const ChannelDescriptor ChnlTskRqst    (ChannelAcronym[TX_ID_TSKRQST]);
-//const ChannelDescriptor ChnlTskRep     (ChannelAcronym[TX_ID_TSKREP]);
+const ChannelDescriptor ChnlTskRep     (ChannelAcronym[TX_ID_TSKREP]);
 const ChannelDescriptor ChnlTskReg     (ChannelAcronym[TX_ID_TSKREG]);
 const ChannelDescriptor ChnlFmkMon     (ChannelAcronym[TX_ID_FMKMON]);
 
@@ -0,0 +1,192 @@
+/******************************************************************************
+ * File:    chnlreg.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.ChnlReg
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement ChannelRegistry class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   nncomm, channels
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "chnlreg.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+const ChannelId ChannelRegistry::InvalidChannel;
+
+//----------------------------------------------------------------------
+// Constructor: Table
+// The predefined channels take the ids given by TxId
+//----------------------------------------------------------------------
+ChannelRegistry::Table::Table()
+{
+    for (int i = 0; i <= TX_ID_UNKNOWN; ++i) {
+        names.push_back(ChannelAcronym[i]);
+        bases.push_back(static_cast<TxId>(i));
+        ids[ChannelAcronym[i]] = i;
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: table
+//----------------------------------------------------------------------
+ChannelRegistry::Table & ChannelRegistry::table()
+{
+    static Table t;
+    return t;
+}
+
+//----------------------------------------------------------------------
+// Method: intern
+// Return the id of the channel, registering it if needed
+//----------------------------------------------------------------------
+ChannelId ChannelRegistry::intern(const ChannelDescriptor & chnl)
+{
+    Table & t = table();
+    std::lock_guard<std::mutex> lock(t.mtx);
+
+    std::map<ChannelDescriptor, ChannelId>::iterator it = t.ids.find(chnl);
+    if (it != t.ids.end()) { return it->second; }
+
+    // Derived channels are named <chnl>_<suffix>
+    TxId base = TX_ID_UNKNOWN;
+    size_t pos = chnl.find('_');
+    if (pos != std::string::npos) {
+        it = t.ids.find(chnl.substr(0, pos));
+        if ((it != t.ids.end()) && (it->second < TX_ID_UNKNOWN)) {
+            base = static_cast<TxId>(it->second);
+        }
+    }
+
+    ChannelId id = static_cast<ChannelId>(t.names.size());
+    t.names.push_back(chnl);
+    t.bases.push_back(base);
+    t.ids[chnl] = id;
+    return id;
+}
+
+//----------------------------------------------------------------------
+// Method: find
+// Return the id of the channel, or InvalidChannel if not registered
+//----------------------------------------------------------------------
+ChannelId ChannelRegistry::find(const ChannelDescriptor & chnl)
+{
+    Table & t = table();
+    std::lock_guard<std::mutex> lock(t.mtx);
+
+    std::map<ChannelDescriptor, ChannelId>::iterator it = t.ids.find(chnl);
+    return (it != t.ids.end()) ? it->second : InvalidChannel;
+}
+
+//----------------------------------------------------------------------
+// Method: name
+//----------------------------------------------------------------------
+ChannelDescriptor ChannelRegistry::name(ChannelId id)
+{
+    Table & t = table();
+    std::lock_guard<std::mutex> lock(t.mtx);
+
+    if ((id < 0) || (id >= static_cast<ChannelId>(t.names.size()))) {
+        return ChannelAcronym[TX_ID_UNKNOWN];
+    }
+    return t.names[id];
+}
+
+//----------------------------------------------------------------------
+// Method: baseOf
+// Return the predefined channel a channel is derived from
+//----------------------------------------------------------------------
+TxId ChannelRegistry::baseOf(ChannelId id)
+{
+    Table & t = table();
+    std::lock_guard<std::mutex> lock(t.mtx);
+
+    if ((id < 0) || (id >= static_cast<ChannelId>(t.bases.size()))) {
+        return TX_ID_UNKNOWN;
+    }
+    return t.bases[id];
+}
+
+//----------------------------------------------------------------------
+// Method: msgTypeId
+// Return the TxId for a message type name, TX_ID_UNKNOWN if not valid
+//----------------------------------------------------------------------
+TxId ChannelRegistry::msgTypeId(const std::string & type)
+{
+    // Only a handful of constant names: a linear search avoids locking
+    for (int i = 0; i < TX_ID_UNKNOWN; ++i) {
+        if (type == ChannelAcronym[i]) { return static_cast<TxId>(i); }
+    }
+    return TX_ID_UNKNOWN;
+}
+
+//----------------------------------------------------------------------
+// Method: msgTag
+// Return the Message_Tag (used in masks) for a TxId
+//----------------------------------------------------------------------
+Message_Tag ChannelRegistry::msgTag(TxId id)
+{
+    static const Message_Tag tags[] = {
+        Tag_ChnlCmd,      // CMD
+        Tag_ChnlEvtMng,   // EVTMNG
+        Tag_ChnlHMICmd,   // HMICMD
+        Tag_ChnlInData,   // INDATA
+        Tag_ChnlTskSched, // TSKSCHED
+        Tag_ChnlTskReg,   // TSKREG
+        Tag_MsgTskRqst,   // TSKRQST
+        Tag_MsgTskProc,   // TSKPROC
+        Tag_MsgTskRep,    // TSKREP
+        Tag_ChnlFmkMon,   // FMKMON
+        Tag_MsgHostMon,   // HOSTMON
+        Tag_UNKNOWN };    // UNKNOWN
+    return ((id >= 0) && (id <= TX_ID_UNKNOWN)) ? tags[id] : Tag_UNKNOWN;
+}
+
+//----------------------------------------------------------------------
+// Method: size
+// Return the number of registered channels
+//----------------------------------------------------------------------
+int ChannelRegistry::size()
+{
+    Table & t = table();
+    std::lock_guard<std::mutex> lock(t.mtx);
+    return static_cast<int>(t.names.size());
+}
+
+//}
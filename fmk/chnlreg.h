@@ -0,0 +1,154 @@
+/******************************************************************************
+ * File:    chnlreg.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.ChnlReg
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare ChannelRegistry class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   nncomm, channels
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef CHNLREG_H
+#define CHNLREG_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - vector
+//   - map
+//   - mutex
+//------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - channels.h
+//------------------------------------------------------------
+#include "channels.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+// Small integer identifier of a channel.  The identifiers of the
+// predefined channels are the values of TxId; derived channels (such
+// as the per-agent <chnl>_<agent> channels) get the following ones
+typedef int ChannelId;
+
+//==========================================================================
+// Class: ChannelRegistry
+// Interns channel names into ChannelIds.  Channels are registered while
+// the elements network is created, so that components can refer to
+// them afterwards without building or comparing strings
+//==========================================================================
+class ChannelRegistry {
+
+public:
+    static const ChannelId InvalidChannel = -1;
+
+    //----------------------------------------------------------------------
+    // Method: intern
+    // Return the id of the channel, registering it if needed
+    //----------------------------------------------------------------------
+    static ChannelId intern(const ChannelDescriptor & chnl);
+
+    //----------------------------------------------------------------------
+    // Method: find
+    // Return the id of the channel, or InvalidChannel if not registered
+    //----------------------------------------------------------------------
+    static ChannelId find(const ChannelDescriptor & chnl);
+
+    //----------------------------------------------------------------------
+    // Method: name
+    //----------------------------------------------------------------------
+    static ChannelDescriptor name(ChannelId id);
+
+    //----------------------------------------------------------------------
+    // Method: baseOf
+    // Return the predefined channel a channel is derived from
+    // (TX_ID_TSKPROC for TSKPROC_<agent>), TX_ID_UNKNOWN if none
+    //----------------------------------------------------------------------
+    static TxId baseOf(ChannelId id);
+
+    //----------------------------------------------------------------------
+    // Method: msgTypeId
+    // Return the TxId for a message type name, TX_ID_UNKNOWN if not valid
+    //----------------------------------------------------------------------
+    static TxId msgTypeId(const std::string & type);
+
+    //----------------------------------------------------------------------
+    // Method: msgTag
+    // Return the Message_Tag (used in masks) for a TxId
+    //----------------------------------------------------------------------
+    static Message_Tag msgTag(TxId id);
+
+    //----------------------------------------------------------------------
+    // Method: size
+    // Return the number of registered channels (ids are below this value)
+    //----------------------------------------------------------------------
+    static int size();
+
+private:
+    struct Table {
+        Table();
+        std::mutex                           mtx;
+        std::vector<ChannelDescriptor>       names;
+        std::vector<TxId>                    bases;
+        std::map<ChannelDescriptor, ChannelId> ids;
+    };
+
+    //----------------------------------------------------------------------
+    // Method: table
+    //----------------------------------------------------------------------
+    static Table & table();
+};
+
+//}
+
+#endif  /* CHNLREG_H */
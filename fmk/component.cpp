@@ -40,8 +40,11 @@
 
 #include "component.h"
 #include "message.h"
+#include "msgscan.h"
+#include "msgcodec.h"
 
-#include "dbhdlpostgre.h"
+#include "alertsink.h"
+#include "tracer.h"
 #include "except.h"
 
 //#include "tools.h"
@@ -57,8 +60,26 @@ using Configuration::cfg;
 
 const int HEART_BEAT_STEP_SIZE = 250;
 
+// Period of the check of the queues overflows (ms)
+const int QUEUE_STATS_PERIOD = 10000;
+
+// Period of the main loop profile summary (ms)
+const int LOOP_PROFILE_PERIOD = 60000;
+
 #include <csignal>
 
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Wall clock time stamp (us since epoch), comparable between hosts
+static std::string timeStampMicros()
+{
+    return std::to_string(std::chrono::duration_cast<std::chrono::microseconds>
+                          (std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
 void signalHandler( int signum ) {
     std::cout << "Interrupt signal (" << signum << ") received.\n";
 
@@ -81,6 +102,25 @@ Component::Component(std::string name, std::string addr, Synchronizer * s)
     init(name, addr, s);
 }
 
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+Component::~Component()
+{
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().erase(this);
+    }
+
+    std::set<TimerWheel::TimerId> ids;
+    {
+        std::unique_lock<std::mutex> ulck(mtxPosted);
+        ids.swap(timers);
+    }
+    for (auto id : ids) { TimerWheel::instance().cancel(id); }
+    if (wakeUpFd >= 0) { close(wakeUpFd); }
+}
+
 //----------------------------------------------------------------------
 // Method: init
 // Initialize the component
@@ -97,6 +137,12 @@ void Component::init(std::string name, std::string addr, Synchronizer * s)
     iteration = 0;
     stepSize  = HEART_BEAT_STEP_SIZE;
 
+    wakeUpFd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    wakeUpRequested = false;
+    requestKept     = false;
+
+    defineMsgHandlers();
+
     // Define log system
     Log::defineLogSystem(compName);
 
@@ -107,6 +153,12 @@ void Component::init(std::string name, std::string addr, Synchronizer * s)
     transitTo(INITIALISED);
     InfoMsg("New state: " + getStateName(getState()));
 
+    // Make the channel statistics visible through allChannelStats
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().insert(this);
+    }
+
     if (! compAddress.empty()) {
         DbgMsg("Creating thread for " + compName + " in " + compAddress);
         thrId = std::thread(&Component::run, this);
@@ -121,7 +173,64 @@ void Component::addConnection(ChannelDescriptor & chnl,
                               ScalabilityProtocolRole * conct)
 {
     conct->setName(compName);
-    connections[chnl] = conct;
+
+    // Messages that the I/O thread of the connection fails to send are
+    // reported from the component thread
+    std::string chnlName(chnl);
+    conct->setSendErrorHandler([this, chnlName](const std::string & why) {
+            post([this, chnlName, why]() { sendFailed(chnlName, why); }); });
+
+    std::lock_guard<std::mutex> lock(mtxConnections);
+    ChannelId id = ChannelRegistry::intern(chnl);
+    if (id >= static_cast<ChannelId>(connIndex.size())) {
+        connIndex.resize(id + 1, -1);
+    }
+    if (connIndex[id] >= 0) {
+        connections[connIndex[id]].role = conct;
+        return;
+    }
+
+    // Messages in these channels are dispatched according to the
+    // channel, in the rest according to the message type
+    TxId dispatchId = TX_ID_UNKNOWN;
+    switch (id) {
+    case TX_ID_CMD:
+    case TX_ID_EVTMNG:
+    case TX_ID_HMICMD:
+    case TX_ID_INDATA:
+    case TX_ID_TSKSCHED:
+    case TX_ID_TSKREG:
+    case TX_ID_FMKMON:
+        dispatchId = static_cast<TxId>(id);
+        break;
+    default:
+        break;
+    }
+
+    Metrics & mtr = Metrics::instance();
+    std::string lbl(Metrics::labels({{"comp", compName}, {"chnl", chnl}}));
+    Counter * out = &mtr.counter("qpf_messages_sent_total",
+                                 "Messages sent, per component and channel", lbl);
+    Counter * in  = &mtr.counter("qpf_messages_received_total",
+                                 "Messages dispatched, per component and channel", lbl);
+
+    connIndex[id] = static_cast<int>(connections.size());
+    connections.push_back({id, chnl, conct, dispatchId, UseJSON,
+                           nullptr, 0, OverflowQueueBase::DropOldest, {},
+                           out, in});
+}
+
+//----------------------------------------------------------------------
+// Method: getConnection
+// Return the connection for the channel id, or 0 if none
+//----------------------------------------------------------------------
+Component::Connection * Component::getConnection(ChannelId chnl)
+{
+    if ((chnl < 0) || (chnl >= static_cast<ChannelId>(connIndex.size())) ||
+        (connIndex[chnl] < 0)) {
+        return 0;
+    }
+    return &connections[connIndex[chnl]];
 }
 
 //----------------------------------------------------------------------
@@ -129,7 +238,15 @@ void Component::addConnection(ChannelDescriptor & chnl,
 //----------------------------------------------------------------------
 void Component::periodicMsgInChannel(ChannelDescriptor chnl, int period, MessageString msg)
 {
-    periodicMsgs[chnl][period] = msg;
+    ChannelId id = ChannelRegistry::intern(chnl);
+    std::map<int, TimerWheel::TimerId> & chnlMsgs = periodicMsgs[id];
+    auto it = chnlMsgs.find(period);
+    if (it != chnlMsgs.end()) { stopTimer(it->second); }
+
+    int periodMs = period * stepSize;
+    chnlMsgs[period] = startTimer(periodMs,
+                                  [this, id, msg]() { this->send(id, msg); },
+                                  periodMs);
 }
 
 //----------------------------------------------------------------------
@@ -139,11 +256,9 @@ void Component::fromInitialisedToRunning()
 {
     transitTo(RUNNING);
     InfoMsg("New state: " + getStateName(getState()));
-    for (auto & kv: connections) {
-        const ChannelDescriptor & chnl = kv.first;
-        ScalabilityProtocolRole * conn = kv.second;
-        std::string ch(kv.first);
-        InfoMsg("Connection " + ch + " - " + conn->getName() + " @ " + conn->getAddress());
+    for (auto & cn: connections) {
+        ScalabilityProtocolRole * conn = cn.role;
+        InfoMsg("Connection " + cn.name + " - " + conn->getName() + " @ " + conn->getAddress());
     }
 }
 
@@ -180,7 +295,7 @@ void Component::fromRunningToOff()
 //----------------------------------------------------------------------
 void Component::updateConnections()
 {
-    for (auto & kv: connections) { kv.second->update(); }
+    for (auto & cn: connections) { cn.role->update(); }
 }
 
 //----------------------------------------------------------------------
@@ -188,77 +303,202 @@ void Component::updateConnections()
 //----------------------------------------------------------------------
 void Component::processIncommingMessages()
 {
-    MessageString m;
-    Message_Tag incommMsgTag;
-    
-    for (auto & kv: connections) {
-        const ChannelDescriptor & chnl = kv.first;
-        ScalabilityProtocolRole * conn = kv.second;
-        while (conn->next(m)) {
-            MessageBase msg(m);
-            std::string tgt(msg.header.target());
-            if ((tgt != "*") && (tgt != compName)) { continue; }
-            std::string type(msg.header.type());
-            DbgMsg("(FROM component.cpp:) "  + compName + " received the message [" + m + "]");
-
-            if      (chnl == ChnlCmd)      { incommMsgTag = Tag_ChnlCmd; }
-            else if (chnl == ChnlEvtMng)   { incommMsgTag = Tag_ChnlEvtMng; }
-            else if (chnl == ChnlHMICmd)   { incommMsgTag = Tag_ChnlHMICmd; }
-            else if (chnl == ChnlInData)   { incommMsgTag = Tag_ChnlInData; }
-            else if (chnl == ChnlTskSched) { incommMsgTag = Tag_ChnlTskSched; }
-            else if (chnl == ChnlTskReg)   { incommMsgTag = Tag_ChnlTskReg; }
-            else if (chnl == ChnlFmkMon)   { incommMsgTag = Tag_ChnlFmkMon; }
-            else if (type == MsgTskRqst)   { incommMsgTag = Tag_MsgTskRqst; }
-            else if (type == MsgTskProc)   { incommMsgTag = Tag_MsgTskProc; }
-            else if (type == MsgTskRep)    { incommMsgTag = Tag_MsgTskRep; }
-            else if (type == MsgHostMon)   { incommMsgTag = Tag_MsgHostMon; }
-            else                           { incommMsgTag = Tag_UNKNOWN; }
-
-            switch (incommMsgTag) {
-            case Tag_ChnlCmd:      processCmdMsg(conn, m);      break;
-            case Tag_ChnlEvtMng:   processEvtMngMsg(conn, m);   break;
-            case Tag_ChnlHMICmd:   processHMICmdMsg(conn, m);   break;
-            case Tag_ChnlInData:   processInDataMsg(conn, m);   break;
-            case Tag_ChnlTskSched: processTskSchedMsg(conn, m); break;
-            case Tag_ChnlTskReg:   processTskRegMsg(conn, m);   break;
-            case Tag_ChnlFmkMon:   processFmkMonMsg(conn, m);   break;
-            case Tag_MsgTskRqst:   processTskRqstMsg(conn, m);  break;
-            case Tag_MsgTskProc:   processTskProcMsg(conn, m);  break;
-            case Tag_MsgTskRep:    processTskRepMsg(conn, m);   break;
-            case Tag_MsgHostMon:   processHostMonMsg(conn, m);  break;
-            default:
-                WarnMsg("Message from unidentified channel " + chnl);
-                RaiseSysAlert(Alert(Alert::System,
-                                    Alert::Warning,
-                                    Alert::Comms,
-                                    std::string(__FILE__ ":" Stringify(__LINE__)),
-                                    "Message from unidentified channel " + chnl,
-                                    0));
+    MessageBuffer mb;
+    MsgRouting route;
+
+    for (auto & cn: connections) {
+        ScalabilityProtocolRole * conn = cn.role;
+        // A request not answered by its handler is released, so that
+        // the replier may take the next one, unless the handler keeps it
+        if (cn.staging) {
+            stageMessages(cn, route);
+            while (cn.staging->pop(mb)) {
+                dispatchMsg(cn, mb, route);
+                if (! requestKept) { conn->releaseRequest(); }
+                requestKept = false;
             }
-
-            if (cfg.writeMsgsToDisk &&
-                ((static_cast<int>(incommMsgTag) & cfg.writeMsgsMask) != 0)) {
-                writeMsgToFile(Recv, chnl, m);
+        } else {
+            while (conn->next(mb)) {
+                dispatchMsg(cn, mb, route);
+                if (! requestKept) { conn->releaseRequest(); }
+                requestKept = false;
             }
         }
     }
 }
 
 //----------------------------------------------------------------------
-// Method: sendPeriodicMsgs
+// Method: messagesPending
+//----------------------------------------------------------------------
+bool Component::messagesPending()
+{
+    for (auto & cn: connections) {
+        if ((cn.staging && (cn.staging->size() > 0)) ||
+            cn.role->hasMessages()) { return true; }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------
+// Method: keepRequest
 //----------------------------------------------------------------------
-void Component::sendPeriodicMsgs()
+void Component::keepRequest()
 {
-    for (auto & kv: periodicMsgs) {
-        ChannelDescriptor chnl = kv.first;
-        for (auto & kkv: kv.second) {
-            int period = kkv.first;
-            if (((iteration + 1) % period) == 0) {
-                MessageString & msg = kkv.second;
-                this->send(chnl, msg);
+    requestKept = true;
+}
+
+//----------------------------------------------------------------------
+// Method: stageMessages
+// Move the messages received in the connection to its staging queue,
+// where its overflow policy is applied
+//----------------------------------------------------------------------
+void Component::stageMessages(Connection & cn, MsgRouting & route)
+{
+    MessageBuffer mb;
+    bool blocking = ((cn.stagingPolicy == OverflowQueueBase::Block) &&
+                     (cn.stagingCapacity > 0));
+    while (((! blocking) || (cn.staging->size() < cn.stagingCapacity)) &&
+           cn.role->next(mb)) {
+        std::string key;
+        if ((! cn.coalesceTypes.empty()) &&
+            MsgHeaderScanner::scan(mb.data(), mb.size(), route) &&
+            (cn.coalesceTypes.count(route.type) > 0)) {
+            key = route.type + "/" + route.source;
+        }
+        cn.staging->push(std::move(mb), key);
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: dispatchMsg
+// Pass the message to its handler, if this component is the recipient
+//----------------------------------------------------------------------
+void Component::dispatchMsg(Connection & cn, MessageBuffer & mb, MsgRouting & route)
+{
+    // Only the routing fields are extracted at this point; the
+    // message is parsed only if this component is the recipient
+    if (! MsgHeaderScanner::scan(mb.data(), mb.size(), route)) {
+        WarnMsg("Malformed message received at channel " + cn.name);
+        return;
+    }
+    const std::string & tgt = route.target;
+    if ((tgt != "*") && (tgt != compName)) { return; }
+    cn.msgsIn->inc();
+
+    if ((cn.encoding == OfferBinary) &&
+        MsgCodec::supportsBinary(route.version)) {
+        cn.encoding = UseBinary;
+        DbgMsg("Using binary encoding in channel " + cn.name);
+    }
+    DbgMsg("(FROM component.cpp:) "  + compName + " received a " +
+           route.type + " message from " + route.source);
+
+    TxId msgId = cn.dispatchId;
+    if (msgId == TX_ID_UNKNOWN) {
+        msgId = ChannelRegistry::msgTypeId(route.type);
+        switch (msgId) {
+        case TX_ID_TSKRQST:
+        case TX_ID_TSKPROC:
+        case TX_ID_TSKREP:
+        case TX_ID_HOSTMON:
+            break;
+        default:
+            msgId = TX_ID_UNKNOWN;
+        }
+    }
+
+    MsgHandler handler = msgHandlers[msgId];
+    if (handler != 0) {
+        MessageBase m;
+        MsgCodec::decode(mb.data(), mb.size(), m.val());
+        std::string rcvStamp = timeStampMicros();
+        m.val()["header"]["dateReception"] = rcvStamp;
+        m.init();
+        if (! route.dateTransmission.empty()) {
+            long long dt = (std::atoll(rcvStamp.c_str()) -
+                            std::atoll(route.dateTransmission.c_str()));
+            if (dt >= 0) { cn.role->getStats().latency.record(dt); }
+            // Messages of a product trace add the transit as a span
+            if ((dt >= 0) && (! route.traceId.empty())) {
+                int64_t rcv = std::atoll(rcvStamp.c_str());
+                Tracer::instance().record(route.traceId, "transit:" + cn.name,
+                                          compName, rcv - dt, rcv);
             }
         }
+        uint64_t t0 = LoopProfiler::now();
+        (this->*handler)(cn.role, m);
+        loopProf.handler(msgId, LoopProfiler::now() - t0);
+    } else {
+        WarnMsg("Message from unidentified channel " + cn.name);
+        RaiseSysAlert(Alert(Alert::System,
+                            Alert::Warning,
+                            Alert::Comms,
+                            std::string(__FILE__ ":" Stringify(__LINE__)),
+                            "Message from unidentified channel " + cn.name,
+                            0));
+    }
+
+    if (journal) {
+        journalMsg(MsgJournal::Recv, cn.id, msgId, std::move(mb));
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: defineMsgHandlers
+// Fill in the handlers dispatch table
+//----------------------------------------------------------------------
+void Component::defineMsgHandlers()
+{
+    for (auto & h: msgHandlers) { h = 0; }
+    msgHandlers[TX_ID_CMD]      = &Component::processCmdMsg;
+    msgHandlers[TX_ID_EVTMNG]   = &Component::processEvtMngMsg;
+    msgHandlers[TX_ID_HMICMD]   = &Component::processHMICmdMsg;
+    msgHandlers[TX_ID_INDATA]   = &Component::processInDataMsg;
+    msgHandlers[TX_ID_TSKSCHED] = &Component::processTskSchedMsg;
+    msgHandlers[TX_ID_TSKREG]   = &Component::processTskRegMsg;
+    msgHandlers[TX_ID_FMKMON]   = &Component::processFmkMonMsg;
+    msgHandlers[TX_ID_TSKRQST]  = &Component::processTskRqstMsg;
+    msgHandlers[TX_ID_TSKPROC]  = &Component::processTskProcMsg;
+    msgHandlers[TX_ID_TSKREP]   = &Component::processTskRepMsg;
+    msgHandlers[TX_ID_HOSTMON]  = &Component::processHostMonMsg;
+}
+
+//----------------------------------------------------------------------
+// Method: runPostedTasks
+//----------------------------------------------------------------------
+void Component::runPostedTasks()
+{
+    std::vector<std::function<void()>> tasks;
+    {
+        std::unique_lock<std::mutex> ulck(mtxPosted);
+        tasks.swap(postedTasks);
     }
+    for (auto & task : tasks) { task(); }
+}
+
+//----------------------------------------------------------------------
+// Method: startTimer
+//----------------------------------------------------------------------
+TimerWheel::TimerId Component::startTimer(int afterMs, std::function<void()> cb,
+                                          int periodMs)
+{
+    TimerWheel::TimerId id =
+        TimerWheel::instance().schedule(afterMs,
+                                        [this, cb]() { this->post(cb); },
+                                        periodMs);
+    std::unique_lock<std::mutex> ulck(mtxPosted);
+    if (periodMs > 0) { timers.insert(id); }
+    return id;
+}
+
+//----------------------------------------------------------------------
+// Method: stopTimer
+//----------------------------------------------------------------------
+void Component::stopTimer(TimerWheel::TimerId id)
+{
+    TimerWheel::instance().cancel(id);
+    std::unique_lock<std::mutex> ulck(mtxPosted);
+    timers.erase(id);
 }
 
 //----------------------------------------------------------------------
@@ -268,6 +508,37 @@ void Component::runEachIteration()
 {
 }
 
+//----------------------------------------------------------------------
+// Method: runOnWakeUp
+//----------------------------------------------------------------------
+void Component::runOnWakeUp()
+{
+}
+
+//----------------------------------------------------------------------
+// Method: wakeUp
+// Request the component loop to call runOnWakeUp as soon as possible
+//----------------------------------------------------------------------
+void Component::wakeUp()
+{
+    wakeUpRequested = true;
+    uint64_t one = 1;
+    if (wakeUpFd >= 0) { (void)write(wakeUpFd, &one, sizeof(one)); }
+}
+
+//----------------------------------------------------------------------
+// Method: post
+//----------------------------------------------------------------------
+void Component::post(std::function<void()> task)
+{
+    {
+        std::unique_lock<std::mutex> ulck(mtxPosted);
+        postedTasks.push_back(task);
+    }
+    uint64_t one = 1;
+    if (wakeUpFd >= 0) { (void)write(wakeUpFd, &one, sizeof(one)); }
+}
+
 //----------------------------------------------------------------------
 // Method: step
 //----------------------------------------------------------------------
@@ -293,23 +564,84 @@ void Component::step()
 //----------------------------------------------------------------------
 // Method: send
 //----------------------------------------------------------------------
-void Component::send(ChannelDescriptor chnl, MessageString m)
+bool Component::send(ChannelDescriptor chnl, MessageString m)
 {
-    std::map<ChannelDescriptor, ScalabilityProtocolRole*>::iterator
-        it = connections.find(chnl);
-    if (it != connections.end()) {
-        ScalabilityProtocolRole * conn = it->second;
-        conn->setMsgOut(m);
-    } else {
-        WarnMsg("Couldn't send message via channel " + chnl);
-        RaiseSysAlert(Alert(Alert::System,
-                            Alert::Warning,
-                            Alert::Comms,
-                            std::string(__FILE__ ":" Stringify(__LINE__)),
-                            "Couldn't send message via channel: " + chnl,
-                            0));
+    ChannelId id = ChannelRegistry::find(chnl);
+    if (getConnection(id) != 0) {
+        return this->send(id, m);
+    }
+    sendFailed(chnl, "no such channel");
+    return false;
+}
 
+//----------------------------------------------------------------------
+// Method: send
+//----------------------------------------------------------------------
+bool Component::send(ChannelId chnl, MessageString m)
+{
+    Connection * cn = getConnection(chnl);
+    if (cn == 0) {
+        sendFailed(ChannelRegistry::name(chnl), "no such channel");
+        return false;
+    }
+    if (! cn->role->setMsgOut(m)) {
+        sendFailed(cn->name, "message not sent");
+        return false;
     }
+    cn->msgsOut->inc();
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: send
+// Serialize the message with the encoding agreed for the channel,
+// and send it
+//----------------------------------------------------------------------
+bool Component::send(ChannelDescriptor chnl, MessageBase & msg)
+{
+    return this->send(ChannelRegistry::find(chnl), msg);
+}
+
+//----------------------------------------------------------------------
+// Method: send
+// Serialize the message with the encoding agreed for the channel,
+// and send it
+//----------------------------------------------------------------------
+bool Component::send(ChannelId chnl, MessageBase & msg)
+{
+    Connection * cn = getConnection(chnl);
+    bool useBinary = ((cn != 0) && (cn->encoding == UseBinary));
+
+    // Transmission stamp, for the latency measured at the receiver
+    msg.val()["header"]["dateTransmission"] = timeStampMicros();
+
+    std::string m;
+    MsgCodec::encode(msg.val(), useBinary ? MsgCodec::BINARY : MsgCodec::JSON, m);
+
+    if (journal && (cn != 0)) {
+        TxId msgId = cn->dispatchId;
+        if (msgId == TX_ID_UNKNOWN) {
+            msgId = ChannelRegistry::msgTypeId(msg.val()["header"]["type"].asString());
+        }
+        journalMsg(MsgJournal::Send, chnl, msgId, MessageBuffer(m));
+    }
+
+    return this->send(chnl, m);
+}
+
+//----------------------------------------------------------------------
+// Method: sendFailed
+// Report a message that could not be sent
+//----------------------------------------------------------------------
+void Component::sendFailed(const std::string & chnl, const std::string & why)
+{
+    WarnMsg("Couldn't send message via channel " + chnl + ": " + why);
+    RaiseSysAlert(Alert(Alert::System,
+                        Alert::Warning,
+                        Alert::Comms,
+                        std::string(__FILE__ ":" Stringify(__LINE__)),
+                        "Couldn't send message via channel: " + chnl + " (" + why + ")",
+                        0));
 }
 
 //----------------------------------------------------------------------
@@ -317,13 +649,13 @@ void Component::send(ChannelDescriptor chnl, MessageString m)
 //----------------------------------------------------------------------
 template<class T>
 void Component::sendBodyElem(ChannelDescriptor chnl,
-                             ChannelDescriptor actualChnl, MessageDescriptor tag,
+                             ChannelId actualChnl, MessageDescriptor tag,
                              std::string from, std::string to,
                              std::string bodyElem, std::string elemContent,
-                             std::string initialMsgStr = std::string())
+                             const json & initialMsg)
 {
     // Prepare message and send it
-    Message<T> msg(initialMsgStr);
+    Message<T> msg(initialMsg);
     JValue jstrValue(elemContent);
 
     T & body = msg.body;
@@ -332,16 +664,16 @@ void Component::sendBodyElem(ChannelDescriptor chnl,
     msg.buildHdr(chnl, tag, CHNLS_IF_VERSION, from, to, "", "", "");
     msg.buildBody(body);
 
-    this->send(actualChnl, msg.str());
+    this->send(actualChnl, msg);
 }
 
 // explicit instantiation
 template
 void Component::sendBodyElem<MsgBodyTSK>(ChannelDescriptor chnl,
-                                         ChannelDescriptor actualChnl, MessageDescriptor tag,
+                                         ChannelId actualChnl, MessageDescriptor tag,
                                          std::string from, std::string to,
                                          std::string bodyElem, std::string elemContent,
-                                         std::string initialMsgStr);
+                                         const json & initialMsg);
 
 //----------------------------------------------------------------------
 // Method: run
@@ -352,13 +684,45 @@ void Component::run()
     synchro->wait();
 
     // Show connections
-    for (auto & kv: connections) {
-        ChannelDescriptor chnl = kv.first;
-        ScalabilityProtocolRole * role = kv.second;
-        TraceMsg(role->getName() + " in Channel " + chnl + " with address " +
+    for (auto & cn: connections) {
+        ScalabilityProtocolRole * role = cn.role;
+        TraceMsg(role->getName() + " in Channel " + cn.name + " with address " +
                  role->getAddress() + " - " + role->getClassName());
     }
 
+    // Read all pending messages of each connection in a single pass,
+    // up to the configured budget
+    int drainBudget = cfg.network.drainBudget();
+    if (drainBudget > 0) {
+        for (auto & cn: connections) { cn.role->setDrainBudget(drainBudget); }
+    }
+
+    // Set preferred encoding for each channel
+    setChannelEncodings();
+
+    // Apply the configured overflow policies to the channels
+    setChannelQueues();
+    startTimer(QUEUE_STATS_PERIOD, [this]() { reportQueueStats(); },
+               QUEUE_STATS_PERIOD);
+
+    // Time the phases of the main loop
+    loopProf.attach(compName);
+    startTimer(LOOP_PROFILE_PERIOD, [this]() { reportLoopProfile(); },
+               LOOP_PROFILE_PERIOD);
+
+    // Sockets are read and written by a thread per connection, so the
+    // component thread never blocks on them
+    if (cfg.network.ioThreads()) {
+        for (auto & cn: connections) { cn.role->startIoThread(); }
+    }
+
+    // Messages are stored in the journal by a background thread
+    if (cfg.writeMsgsToDisk) {
+        journal.reset(new MsgJournal(Config::PATHMsg, compName,
+                                     cfg.flags.journalSegmentSize() * 1024 * 1024,
+                                     cfg.flags.journalRotationPeriod()));
+    }
+
     // State: Initialised
     // Transition to: Running
     fromInitialisedToRunning();
@@ -367,14 +731,31 @@ void Component::run()
     // Transition to: Running
     fromRunningToOperational();
 
-    do {
-        ++iteration;
-        updateConnections();
-        processIncommingMessages();
-        sendPeriodicMsgs();
-        runEachIteration();
-        step();
-    } while (getState() == OPERATIONAL);
+    if (cfg.flags.eventDrivenLoop()) {
+        runEventLoop();
+    } else {
+        uint64_t t0, t1, t2, t3, t4, t5;
+        do {
+            ++iteration;
+            t0 = LoopProfiler::now();
+            updateConnections();
+            t1 = LoopProfiler::now();
+            processIncommingMessages();
+            t2 = LoopProfiler::now();
+            runPostedTasks();
+            t3 = LoopProfiler::now();
+            runEachIteration();
+            t4 = LoopProfiler::now();
+            step();
+            t5 = LoopProfiler::now();
+            loopProf.phase(LoopProfiler::UpdateConnections, t1 - t0);
+            loopProf.phase(LoopProfiler::ProcessMessages, t2 - t1);
+            loopProf.phase(LoopProfiler::PostedTasks, t3 - t2);
+            loopProf.phase(LoopProfiler::EachIteration, t4 - t3);
+            loopProf.phase(LoopProfiler::Sleep, t5 - t4);
+            loopProf.iteration(t4 - t0, uint64_t(stepSize) * 1000000);
+        } while (getState() == OPERATIONAL);
+    }
 
     // State: Initialised
     // Transition to: Running
@@ -385,6 +766,264 @@ void Component::run()
     fromRunningToOff();
 }
 
+//----------------------------------------------------------------------
+// Method: runEventLoop
+// Main loop driven by the connections file descriptors and a heart
+// beat timer, used instead of the step() based loop
+//----------------------------------------------------------------------
+void Component::runEventLoop()
+{
+    int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0) {
+        ErrMsg("Cannot create heart beat timer: " + std::string(strerror(errno)));
+        transitTo(RUNNING);
+        return;
+    }
+    int armedStepSize = 0;
+
+    // Messages are only read when the socket is already known to be
+    // readable, so there is no need to wait inside update()
+    for (auto & cn: connections) { cn.role->setPollTimeout(0); }
+
+    std::vector<struct pollfd> fds;
+    uint64_t expirations;
+
+    // Messages left after a pass are processed in the next one, without
+    // waiting in poll for the sockets: they may not signal them again
+    bool msgsPending = false;
+
+    do {
+        {
+            std::unique_lock<std::mutex> ulck(mtxStepSize);
+            if (stepSize != armedStepSize) {
+                armHeartBeat(timerFd, stepSize);
+                armedStepSize = stepSize;
+            }
+        }
+
+        // The set of readable roles may change (e.g. a surveyor waiting
+        // for answers), so the poll set is rebuilt on each pass
+        fds.clear();
+        fds.push_back({timerFd, POLLIN, 0});
+        fds.push_back({wakeUpFd, POLLIN, 0});
+        for (auto & cn: connections) {
+            int fd = cn.role->getRecvFd();
+            if (fd >= 0) { fds.push_back({fd, POLLIN, 0}); }
+        }
+
+        uint64_t t0 = LoopProfiler::now();
+        if (poll(fds.data(), fds.size(), msgsPending ? 0 : -1) < 0) {
+            if (errno == EINTR) { continue; }
+            ErrMsg("Error in component loop: " + std::string(strerror(errno)));
+            transitTo(RUNNING);
+            break;
+        }
+        uint64_t t1 = LoopProfiler::now();
+        loopProf.phase(LoopProfiler::Sleep, t1 - t0);
+        uint64_t t;
+
+        bool msgsReady = msgsPending;
+        for (size_t i = 2; (! msgsReady) && (i < fds.size()); ++i) {
+            if ((fds[i].revents & POLLIN) != 0) { msgsReady = true; break; }
+        }
+        if (msgsReady) {
+            updateConnections();
+            t = LoopProfiler::now();
+            loopProf.phase(LoopProfiler::UpdateConnections, t - t1);
+            processIncommingMessages();
+            loopProf.phase(LoopProfiler::ProcessMessages, LoopProfiler::now() - t);
+            msgsPending = messagesPending();
+        }
+
+        if ((fds[1].revents & POLLIN) != 0) {
+            (void)read(wakeUpFd, &expirations, sizeof(expirations));
+            t = LoopProfiler::now();
+            runPostedTasks();
+            if (wakeUpRequested.exchange(false)) { runOnWakeUp(); }
+            loopProf.phase(LoopProfiler::PostedTasks, LoopProfiler::now() - t);
+        }
+
+        if ((fds[0].revents & POLLIN) != 0) {
+            (void)read(timerFd, &expirations, sizeof(expirations));
+            ++iteration;
+            // Heart beats missed while busy are overruns
+            if (expirations > 1) { loopProf.overrun(expirations - 1); }
+            t = LoopProfiler::now();
+            runEachIteration();
+            loopProf.phase(LoopProfiler::EachIteration, LoopProfiler::now() - t);
+        }
+
+        loopProf.iteration(LoopProfiler::now() - t1,
+                           uint64_t(armedStepSize) * 1000000);
+    } while (getState() == OPERATIONAL);
+
+    close(timerFd);
+}
+
+//----------------------------------------------------------------------
+// Method: armHeartBeat
+//----------------------------------------------------------------------
+void Component::armHeartBeat(int fd, int ms)
+{
+    struct itimerspec its;
+    its.it_interval.tv_sec  = ms / 1000;
+    its.it_interval.tv_nsec = (ms % 1000) * 1000000L;
+    its.it_value            = its.it_interval;
+    if (timerfd_settime(fd, 0, &its, 0) != 0) {
+        ErrMsg("Cannot arm heart beat timer: " + std::string(strerror(errno)));
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: setChannelEncodings
+// Mark the channels configured for binary encoding
+//----------------------------------------------------------------------
+void Component::setChannelEncodings()
+{
+    std::vector<std::string> binChnls = cfg.network.binaryChannels();
+    for (auto & cn: connections) {
+        const ChannelDescriptor & chnl = cn.name;
+        ChnlEncoding enc = UseJSON;
+        for (auto & c: binChnls) {
+            // Per-agent channels are named <chnl>_<agent>
+            if ((chnl == c) || (chnl.compare(0, c.size() + 1, c + "_") == 0)) {
+                enc = OfferBinary;
+                break;
+            }
+        }
+        cn.encoding = enc;
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: queueSettings
+// Get the configured capacity and overflow policy of the queue or
+// channel (per-agent channels <chnl>_<agent> may be configured as
+// <chnl>); returns false if it is not configured
+//----------------------------------------------------------------------
+bool Component::queueSettings(const std::string & name, size_t & capacity,
+                              OverflowQueueBase::Policy & policy,
+                              std::vector<std::string> * coalesceTypes)
+{
+    std::map<std::string, CfgGrpQueue> queues = cfg.network.queues();
+    auto it = queues.find(name);
+    if (it == queues.end()) { it = queues.find(name.substr(0, name.find('_'))); }
+    if (it == queues.end()) { return false; }
+
+    CfgGrpQueue & q = it->second;
+    capacity = (q.capacity() > 0) ? q.capacity() : 0;
+    policy   = OverflowQueueBase::policyFromName(q.policy(),
+                                                OverflowQueueBase::DropOldest);
+    if (coalesceTypes != 0) { *coalesceTypes = q.coalesceTypes(); }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: setChannelQueues
+// Create the staging queues of the channels with an overflow policy
+//----------------------------------------------------------------------
+void Component::setChannelQueues()
+{
+    for (auto & cn: connections) {
+        size_t capacity;
+        OverflowQueueBase::Policy policy;
+        std::vector<std::string> types;
+        if (! queueSettings(cn.name, capacity, policy, &types)) { continue; }
+
+        cn.staging.reset(new OverflowQueue<MessageBuffer>(compName + "." + cn.name,
+                                                          capacity, policy));
+        cn.stagingCapacity = capacity;
+        cn.stagingPolicy   = policy;
+        cn.coalesceTypes   = std::set<std::string>(types.begin(), types.end());
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: reportQueueStats
+// Warn about the queues of this component that dropped elements
+//----------------------------------------------------------------------
+void Component::reportQueueStats()
+{
+    std::string prefix(compName + ".");
+    for (auto & st: OverflowQueueBase::allStats()) {
+        if (st.name.compare(0, prefix.size(), prefix) != 0) { continue; }
+        uint64_t & last = queueDrops[st.name];
+        if (st.dropped > last) {
+            WarnMsg("Queue " + st.name + " dropped " +
+                    std::to_string(st.dropped - last) + " elements (depth " +
+                    std::to_string(st.depth) + "/" + std::to_string(st.capacity) +
+                    ", high water " + std::to_string(st.highWater) + ")");
+            last = st.dropped;
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: reportLoopProfile
+// Close the loop profile window, and log its summary
+//----------------------------------------------------------------------
+void Component::reportLoopProfile()
+{
+    loopProf.rotate();
+    InfoMsg(loopProf.summary());
+}
+
+//----------------------------------------------------------------------
+// Method: getChannelStats
+// Traffic counters, and latency and round trip time percentiles (us),
+// for each channel of the component
+//----------------------------------------------------------------------
+void Component::getChannelStats(json & v)
+{
+    auto histo = [] (const LatencyHistogram & h) -> json {
+        json x(Json::objectValue);
+        x["count"] = Json::UInt64(h.count());
+        x["min"]   = Json::UInt64(h.min());
+        x["p50"]   = Json::UInt64(h.percentile(50.));
+        x["p90"]   = Json::UInt64(h.percentile(90.));
+        x["p99"]   = Json::UInt64(h.percentile(99.));
+        x["max"]   = Json::UInt64(h.max());
+        x["mean"]  = h.mean();
+        return x;
+    };
+
+    v = json(Json::objectValue);
+    std::lock_guard<std::mutex> lock(mtxConnections);
+    for (auto & cn: connections) {
+        ChannelStats & st = cn.role->getStats();
+        json & c = v[cn.name];
+        c["msgsIn"]   = Json::UInt64(st.msgsIn.load());
+        c["bytesIn"]  = Json::UInt64(st.bytesIn.load());
+        c["msgsOut"]  = Json::UInt64(st.msgsOut.load());
+        c["bytesOut"] = Json::UInt64(st.bytesOut.load());
+        c["latency"]  = histo(st.latency);
+        if (st.rtt.count() > 0) { c["rtt"] = histo(st.rtt); }
+    }
+}
+
+//----------------------------------------------------------------------
+// Static Method: allChannelStats
+// Channel statistics of all the components of the process, by name
+//----------------------------------------------------------------------
+void Component::allChannelStats(json & v)
+{
+    v = json(Json::objectValue);
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (auto c : registry()) { c->getChannelStats(v[c->compName]); }
+}
+
+std::set<Component*> & Component::registry()
+{
+    static std::set<Component*> r;
+    return r;
+}
+
+std::mutex & Component::registryMutex()
+{
+    static std::mutex m;
+    return m;
+}
+
 //----------------------------------------------------------------------
 // Method: setStep
 //----------------------------------------------------------------------
@@ -397,9 +1036,9 @@ void Component::setStep(int s)
 //----------------------------------------------------------------------
 // Method: processCmdMsg
 //----------------------------------------------------------------------
-void Component::processCmdMsg(ScalabilityProtocolRole * c, MessageString & m)
+void Component::processCmdMsg(ScalabilityProtocolRole * c, MessageBase & m)
 {
-    Message<MsgBodyCMD> msg(m);
+    Message<MsgBodyCMD> msg(std::move(m));
     std::string cmd = msg.body["cmd"].asString();
 
     if (cmd == CmdQuit) {
@@ -422,7 +1061,7 @@ void Component::processCmdMsg(ScalabilityProtocolRole * c, MessageString & m)
 
     } else if (cmd == CmdProcHdl) {
 
-        processSubcmdMsg(m);
+        processSubcmdMsg(msg);
 
     } else {
 
@@ -440,9 +1079,9 @@ void Component::processCmdMsg(ScalabilityProtocolRole * c, MessageString & m)
 //----------------------------------------------------------------------
 // Method: processEvtMngMsg
 //----------------------------------------------------------------------
-void Component::processEvtMngMsg(ScalabilityProtocolRole * c, MessageString & m)
+void Component::processEvtMngMsg(ScalabilityProtocolRole * c, MessageBase & m)
 {
-    Message<MsgBodyCMD> msg(m);
+    Message<MsgBodyCMD> msg(std::move(m));
     std::string cmd = msg.body["cmd"].asString();
 
     if (cmd == CmdPing) { // This is any component but EvtMng
@@ -458,7 +1097,7 @@ void Component::processEvtMngMsg(ScalabilityProtocolRole * c, MessageString & m)
         body["logs"]    = Config::PATHLog;
             
         msg.buildBody(body);
-        this->send(ChnlEvtMng, msg.str());
+        this->send(ChnlEvtMng, msg);
 
     } else if (cmd == CmdStates) { // This should be EvtMng
 
@@ -495,7 +1134,7 @@ void Component::sendAns(ChannelDescriptor chnl, MessageDescriptor msgd,
     MsgBodyTSK bodyAns;
     bodyAns["ans"] = ans;
     msgAns.buildBody(bodyAns);
-    this->send(chnl, msgAns.str());
+    this->send(chnl, msgAns);
 }
 
 //----------------------------------------------------------------------
@@ -559,38 +1198,8 @@ void Component::raise(Alert a, Alert::Group grp)
 
     std::string alertMsg = a.dump();
 
-    // Store alert in DB
-    std::unique_ptr<DBHandler> dbHdl(new DBHdlPostgreSQL);
-    DBHandler * db = dbHdl.get();
-
-    // Check that connection with the DB is possible
-    try {
-        db->openConnection();
-        
-        std::stringstream ss;
-        ss << "INSERT INTO alerts "
-           << "(alert_id, creation, grp, sev, typ, origin, msgs, file";
-        if (a.getVar() != 0) { ss << ", var"; }
-        ss << ") VALUES ( nextval('alerts_alert_id_seq'), "
-           << str::quoted(a.timeStampString()) << ", "
-           << str::quoted(Alert::GroupName[a.getGroup()]) << ", "
-           << str::quoted(Alert::SeverityName[a.getSeverity()]) << ", "
-           << str::quoted(Alert::TypeName[a.getType()]) << ", "
-           << str::quoted(a.getOrigin()) << ", "
-           << str::quoted(a.allMessages()) << ", "
-           << str::quoted(str::getBaseName(a.getFile()));
-        if (a.getVar() != 0) { ss << ", " << a.varAsTuple(); }
-        ss << ");";
-
-        db->runCmd(ss.str());
-    } catch (RuntimeException & e) {
-        ErrMsg(std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": " + e.what());
-        DBG(e.what());
-        return;
-    }
-
-    // Close connection
-    db->closeConnection();
+    // Store alert in DB (done asynchronously by the alert sink)
+    AlertSink::instance().store(a);
 
     //  Store alert msg in log file
     Log::LogLevel lvl = Log::WARNING;
@@ -609,25 +1218,21 @@ void Component::raise(Alert a, Alert::Group grp)
 }
 
 //----------------------------------------------------------------------
-// Method: step
+// Method: journalMsg
+// Store the message in the journal, if enabled for the message type
 //----------------------------------------------------------------------
-void Component::writeMsgToFile(SendOrRecv sor,
-                               ChannelDescriptor chnl, MessageString m)
+void Component::journalMsg(MsgJournal::Direction dir, ChannelId chnl, TxId msgId,
+                           MessageBuffer && buf)
 {
-    struct timespec timesp;
-    if (clock_gettime(CLOCK_REALTIME_COARSE, &timesp) != 0) {
-        perror("clock_gettime");
-        exit(1);
+    if ((static_cast<int>(ChannelRegistry::msgTag(msgId)) & cfg.writeMsgsMask) == 0) {
+        return;
+    }
+    if (journal->append(dir, chnl, std::move(buf))) {
+        unsigned int numDropped = journal->getDropped();
+        if (numDropped > 0) {
+            WarnMsg(std::to_string(numDropped) +
+                    " messages not stored (message journal queue is full)");
+        }
     }
-
-    char fileName[256];
-    sprintf(fileName, "%s/%lld.%09ld_%s_%c_%s.mson",
-            Config::PATHSession.c_str(),
-            (long long)timesp.tv_sec, timesp.tv_nsec,
-            compName.c_str(), 
-            (sor == Send ? 'S' : 'R'), chnl.c_str());
-    FILE * fHdl = fopen(fileName, "w");
-    fprintf(fHdl, m.c_str());
-    fclose(fHdl);
 }
 
@@ -52,12 +52,18 @@
 //   - mutex
 //   - chrono
 //   - ctime
+//   - functional
+//   - atomic
+//   - set
 //------------------------------------------------------------
 #include <map>
 #include <thread>
 #include <mutex>
 #include <chrono>
 #include <ctime>
+#include <functional>
+#include <atomic>
+#include <set>
 
 using std::chrono::system_clock;
 
@@ -71,18 +77,30 @@ using std::chrono::system_clock;
 //   - sm.h
 //   - config.h
 //   - channels.h
+//   - chnlreg.h
+//   - msgjournal.h
 //   - log.h
 //   - sync.h
 //   - alert.h
+//   - timer.h
+//   - ovfqueue.h
+//   - msgscan.h
 //------------------------------------------------------------
 #include "commnode.h"
 #include "sm.h"
 #include "config.h"
 #include "channels.h"
+#include "chnlreg.h"
+#include "msgjournal.h"
 #include "message.h"
 #include "log.h"
 #include "sync.h"
 #include "alert.h"
+#include "timer.h"
+#include "ovfqueue.h"
+#include "msgscan.h"
+#include "metrics.h"
+#include "loopprof.h"
 
 #ifdef LogMsg
 
@@ -158,6 +176,9 @@ using std::chrono::system_clock;
 //==========================================================================
 class Component : public CommNode, public StateMachine {
 
+    // The replay engine drives the component from its own loop
+    friend class ReplayEngine;
+
 protected:
     // Valid Manager states
     static const int ERROR        = -1;
@@ -177,6 +198,11 @@ public:
     //----------------------------------------------------------------------
     Component(std::string name, std::string addr = std::string(), Synchronizer * s = 0);
 
+    //----------------------------------------------------------------------
+    // Destructor
+    //----------------------------------------------------------------------
+    virtual ~Component();
+
     //----------------------------------------------------------------------
     // Method: run
     //----------------------------------------------------------------------
@@ -190,6 +216,7 @@ public:
 
     //----------------------------------------------------------------------
     // Method: periodicMsgInChannel
+    // Send msg through chnl every period heart beats
     //----------------------------------------------------------------------
     void periodicMsgInChannel(ChannelDescriptor chnl, int period, MessageString msg);
 
@@ -208,6 +235,18 @@ public:
     //----------------------------------------------------------------------
     virtual std::string getAddress() { return compAddress; }
 
+    //----------------------------------------------------------------------
+    // Method: wakeUp
+    // Request the component loop to call runOnWakeUp as soon as possible
+    //----------------------------------------------------------------------
+    void wakeUp();
+
+    //----------------------------------------------------------------------
+    // Method: post
+    // Queue a task to be run in the component thread
+    //----------------------------------------------------------------------
+    void post(std::function<void()> task);
+
     //----------------------------------------------------------------------
     // Method: setWriteMsgsToDisk
     //----------------------------------------------------------------------
@@ -228,21 +267,55 @@ public:
     //----------------------------------------------------------------------
     int getWriteMsgsMask();
 
+    //----------------------------------------------------------------------
+    // Method: getChannelStats
+    // Traffic counters, and latency and round trip time percentiles (us),
+    // for each channel of the component
+    //----------------------------------------------------------------------
+    void getChannelStats(json & v);
+
+    //----------------------------------------------------------------------
+    // Static Method: allChannelStats
+    // Channel statistics of all the components of the process, by name
+    //----------------------------------------------------------------------
+    static void allChannelStats(json & v);
+
 protected:
     //----------------------------------------------------------------------
     // Method: send
+    // Returns false if the message could not be sent
+    //----------------------------------------------------------------------
+    bool send(ChannelDescriptor chnl, MessageString m);
+
+    //----------------------------------------------------------------------
+    // Method: send
+    // Returns false if the message could not be sent
+    //----------------------------------------------------------------------
+    bool send(ChannelId chnl, MessageString m);
+
+    //----------------------------------------------------------------------
+    // Method: send
+    // Serialize the message with the encoding agreed for the channel,
+    // and send it.  Returns false if the message could not be sent
     //----------------------------------------------------------------------
-    void send(ChannelDescriptor chnl, MessageString m);
+    bool send(ChannelDescriptor chnl, MessageBase & msg);
+
+    //----------------------------------------------------------------------
+    // Method: send
+    // Serialize the message with the encoding agreed for the channel,
+    // and send it.  Returns false if the message could not be sent
+    //----------------------------------------------------------------------
+    bool send(ChannelId chnl, MessageBase & msg);
 
     //----------------------------------------------------------------------
     // Method: sendBodyElem<T>
     //----------------------------------------------------------------------
     template<class T>
     void sendBodyElem(ChannelDescriptor chnl,
-                      ChannelDescriptor actualChnl, MessageDescriptor tag,
+                      ChannelId actualChnl, MessageDescriptor tag,
                       std::string from, std::string to,
                       std::string bodyElem, std::string elemContent,
-                      std::string initialMsgStr);
+                      const json & initialMsg);
  
     //----------------------------------------------------------------------
     // Method: fromInitialisedToRunning
@@ -275,15 +348,43 @@ protected:
     virtual void processIncommingMessages();
 
     //----------------------------------------------------------------------
-    // Method: fromInitialisedToRunning
+    // Method: messagesPending
+    // Tell whether messages are left in the connections or their staging
+    // queues (e.g. held back by a full queue with policy "block"), to be
+    // processed without waiting for new ones to arrive
+    //----------------------------------------------------------------------
+    bool messagesPending();
+
+    //----------------------------------------------------------------------
+    // Method: runPostedTasks
+    // Run the tasks queued with post()
+    //----------------------------------------------------------------------
+    void runPostedTasks();
+
+    //----------------------------------------------------------------------
+    // Method: startTimer
+    // Arm a timer in the process timer wheel.  The callback is run in the
+    // component thread, every periodMs ms if periodMs > 0
+    //----------------------------------------------------------------------
+    TimerWheel::TimerId startTimer(int afterMs, std::function<void()> cb,
+                                   int periodMs = 0);
+
     //----------------------------------------------------------------------
-    virtual void sendPeriodicMsgs();
+    // Method: stopTimer
+    //----------------------------------------------------------------------
+    void stopTimer(TimerWheel::TimerId id);
 
     //----------------------------------------------------------------------
     // Method: runEachIteration
     //----------------------------------------------------------------------
     virtual void runEachIteration();
 
+    //----------------------------------------------------------------------
+    // Method: runOnWakeUp
+    // Called from the component loop after a wakeUp() request
+    //----------------------------------------------------------------------
+    virtual void runOnWakeUp();
+
     //----------------------------------------------------------------------
     // Method: defineValidTransitions
     // Define the valid state transitions for the node
@@ -296,20 +397,23 @@ protected:
     virtual void afterTransition(int fromState, int toState);
 
 protected:
-    virtual void processCmdMsg(ScalabilityProtocolRole* c, MessageString & m);
-    virtual void processEvtMngMsg(ScalabilityProtocolRole* c, MessageString & m);
-    virtual void processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m) {}
-    virtual void processInDataMsg(ScalabilityProtocolRole* c, MessageString & m) {}
-    virtual void processTskSchedMsg(ScalabilityProtocolRole* c, MessageString & m) {}
-    virtual void processTskRqstMsg(ScalabilityProtocolRole* c, MessageString & m) {}
-    virtual void processTskProcMsg(ScalabilityProtocolRole* c, MessageString & m) {}
-    virtual void processTskRepMsg(ScalabilityProtocolRole* c, MessageString & m) {}
-    virtual void processHostMonMsg(ScalabilityProtocolRole* c, MessageString & m) {}
+    virtual void processCmdMsg(ScalabilityProtocolRole* c, MessageBase & m);
+    virtual void processEvtMngMsg(ScalabilityProtocolRole* c, MessageBase & m);
+    virtual void processHMICmdMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
+    virtual void processInDataMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
+    virtual void processTskSchedMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
+    virtual void processTskRqstMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
+    virtual void processTskProcMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
+    virtual void processTskRepMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
+    virtual void processHostMonMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
+
+    virtual void processTskRegMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
+    virtual void processFmkMonMsg(ScalabilityProtocolRole* c, MessageBase & m) {}
 
-    virtual void processTskRegMsg(ScalabilityProtocolRole* c, MessageString & m) {}
-    virtual void processFmkMonMsg(ScalabilityProtocolRole* c, MessageString & m) {}
+    virtual void processSubcmdMsg(MessageBase & m) {}
 
-    virtual void processSubcmdMsg(MessageString & m) {}
+    // Message handlers, indexed by the TxId of the channel or message type
+    typedef void (Component::*MsgHandler)(ScalabilityProtocolRole* c, MessageBase & m);
 
 protected:
     //----------------------------------------------------------------------
@@ -336,17 +440,135 @@ private:
     //----------------------------------------------------------------------
     virtual void step();
 
-    enum SendOrRecv {Send, Recv};
+    //----------------------------------------------------------------------
+    // Method: runEventLoop
+    // Main loop driven by the connections file descriptors and a heart
+    // beat timer, used instead of the step() based loop
+    //----------------------------------------------------------------------
+    void runEventLoop();
+
+    //----------------------------------------------------------------------
+    // Method: armHeartBeat
+    //----------------------------------------------------------------------
+    void armHeartBeat(int fd, int ms);
 
     //----------------------------------------------------------------------
-    // Method: step
+    // Method: setChannelEncodings
+    // Mark the channels configured for binary encoding
+    //----------------------------------------------------------------------
+    void setChannelEncodings();
+
+    //----------------------------------------------------------------------
+    // Method: defineMsgHandlers
+    // Fill in the handlers dispatch table
+    //----------------------------------------------------------------------
+    void defineMsgHandlers();
+
     //----------------------------------------------------------------------
-    void writeMsgToFile(SendOrRecv sor,
-                        ChannelDescriptor chnl, MessageString m);
-    
+    // Method: journalMsg
+    // Store the message in the journal, if enabled for the message type
+    //----------------------------------------------------------------------
+    void journalMsg(MsgJournal::Direction dir, ChannelId chnl, TxId msgId,
+                    MessageBuffer && buf);
+
 protected:
-    std::map<ChannelDescriptor, ScalabilityProtocolRole*> connections;
-    std::map<ChannelDescriptor, std::map<int, MessageString>> periodicMsgs;
+    // Encoding of each channel: binary is only used once the peer has
+    // shown (through the interface version) that it can decode it
+    enum ChnlEncoding { UseJSON, OfferBinary, UseBinary };
+
+    struct Connection {
+        ChannelId                 id;
+        ChannelDescriptor         name;
+        ScalabilityProtocolRole * role;
+        TxId                      dispatchId; // TX_ID_UNKNOWN: by msg. type
+        ChnlEncoding              encoding;
+
+        // Staging queue, for channels with an overflow policy
+        std::shared_ptr<OverflowQueue<MessageBuffer>> staging;
+        size_t                    stagingCapacity;
+        OverflowQueueBase::Policy stagingPolicy;
+        std::set<std::string>     coalesceTypes;
+
+        // Messages sent and dispatched, in the metrics registry
+        Counter *                 msgsOut;
+        Counter *                 msgsIn;
+    };
+
+    // Connections, in order of addition; connIndex maps each ChannelId
+    // to its position in connections (or -1)
+    std::vector<Connection> connections;
+    // Connections are only added from the component thread, before it
+    // runs; readers from other threads (getChannelStats) take the lock
+    std::mutex              mtxConnections;
+    std::vector<int>        connIndex;
+
+    //----------------------------------------------------------------------
+    // Method: getConnection
+    // Return the connection for the channel id, or 0 if none
+    //----------------------------------------------------------------------
+    Connection * getConnection(ChannelId chnl);
+
+    //----------------------------------------------------------------------
+    // Method: stageMessages
+    //----------------------------------------------------------------------
+    void stageMessages(Connection & cn, MsgRouting & route);
+
+    //----------------------------------------------------------------------
+    // Method: sendFailed
+    // Report a message that could not be sent
+    //----------------------------------------------------------------------
+    void sendFailed(const std::string & chnl, const std::string & why);
+
+    //----------------------------------------------------------------------
+    // Method: dispatchMsg
+    //----------------------------------------------------------------------
+    void dispatchMsg(Connection & cn, MessageBuffer & mb, MsgRouting & route);
+
+    //----------------------------------------------------------------------
+    // Method: keepRequest
+    // Keep the request being dispatched unanswered, instead of releasing
+    // it when its handler returns.  The component must send the reply
+    // through the same channel later on
+    //----------------------------------------------------------------------
+    void keepRequest();
+
+    //----------------------------------------------------------------------
+    // Method: setChannelQueues
+    //----------------------------------------------------------------------
+    void setChannelQueues();
+
+    //----------------------------------------------------------------------
+    // Method: queueSettings
+    //----------------------------------------------------------------------
+    bool queueSettings(const std::string & name, size_t & capacity,
+                       OverflowQueueBase::Policy & policy,
+                       std::vector<std::string> * coalesceTypes = 0);
+
+    //----------------------------------------------------------------------
+    // Method: reportQueueStats
+    //----------------------------------------------------------------------
+    void reportQueueStats();
+
+    //----------------------------------------------------------------------
+    // Method: reportLoopProfile
+    // Close the loop profile window, and log its summary
+    //----------------------------------------------------------------------
+    void reportLoopProfile();
+
+    //----------------------------------------------------------------------
+    // Method: configureQueue
+    // Apply the configured capacity and policy, if any, to the queue
+    //----------------------------------------------------------------------
+    template<class Q>
+    void configureQueue(Q & q, const std::string & name) {
+        size_t capacity;
+        OverflowQueueBase::Policy policy;
+        if (queueSettings(name, capacity, policy)) { q.configure(capacity, policy); }
+    }
+
+    MsgHandler msgHandlers[TX_ID_UNKNOWN + 1];
+
+    std::map<ChannelId, std::map<int, TimerWheel::TimerId>> periodicMsgs;
 
     std::string compName;
     std::string compAddress;
@@ -359,7 +581,25 @@ protected:
     int iteration;
     int stepSize;
 
+    int wakeUpFd;
+    std::atomic<bool> wakeUpRequested;
+
+    bool requestKept;
+
+    std::mutex                         mtxPosted;
+    std::vector<std::function<void()>> postedTasks;
+    std::set<TimerWheel::TimerId>      timers;
+
+    std::map<std::string, uint64_t>    queueDrops;
+
+    LoopProfiler                       loopProf;
+
     std::map<std::string, std::string> logFolders;
+
+    std::unique_ptr<MsgJournal> journal;
+
+    static std::set<Component*> & registry();
+    static std::mutex & registryMutex();
 };
 
 #endif
@@ -113,6 +113,26 @@ public:
     JSTRVEC(args);
 };
 
+//==========================================================================
+// Class: CfgGrpQueue
+// Capacity (0: no limit) and overflow policy ("block", "dropOldest" or
+// "coalesce") of a channel or internal queue.  For channels, only the
+// message types in coalesceTypes are coalesced (by type and source)
+//==========================================================================
+class CfgGrpQueue : public JRecord {
+public:
+    CfgGrpQueue() {}
+    CfgGrpQueue(json v) : JRecord(v) {}
+    virtual void dump() {
+        DUMPJINT(capacity);
+        DUMPJSTR(policy);
+        DUMPJSTRVEC(coalesceTypes);
+    }
+    JINT(capacity);
+    JSTR(policy);
+    JSTRVEC(coalesceTypes);
+};
+
 //==========================================================================
 // Class: CfgGrpNetwork
 //==========================================================================
@@ -124,12 +144,22 @@ public:
         DUMPJSTR(masterNode);
         DUMPJINT(startingPort);
         DUMPJSTRINTMAP(processingNodes);
+        DUMPJINT(agentSlots);
         DUMPJSTRGRPMAP(CfgGrpSwarm, swarms);
+        DUMPJINT(drainBudget);
+        DUMPJSTRVEC(binaryChannels);
+        DUMPJBOOL(ioThreads);
+        DUMPJSTRGRPMAP(CfgGrpQueue, queues);
     }
     JSTR(masterNode);
     JINT(startingPort);
     JSTRINTMAP(processingNodes);
+    JINT(agentSlots);
     JSTRGRPMAP(CfgGrpSwarm, swarms);
+    JINT(drainBudget);
+    JSTRVEC(binaryChannels);
+    JBOOL(ioThreads);
+    JSTRGRPMAP(CfgGrpQueue, queues);
 };
 
 //==========================================================================
@@ -271,6 +301,30 @@ public:
     }
 };
 
+//==========================================================================
+// Class: CfgGrpTaskClass
+// Priority class of the tasks waiting for an agent: weight, and the
+// criteria to match (origin "nominal" or "reprocessing", rule names,
+// input product types and flags).  Empty criteria match any task
+//==========================================================================
+class CfgGrpTaskClass : public JRecord {
+public:
+    CfgGrpTaskClass() {}
+    CfgGrpTaskClass(json v) : JRecord(v) {}
+    virtual void dump() {
+        DUMPJINT(weight);
+        DUMPJSTR(origin);
+        DUMPJSTRVEC(rules);
+        DUMPJSTRVEC(productTypes);
+        DUMPJINT(flags);
+    }
+    JINT(weight);
+    JSTR(origin);
+    JSTRVEC(rules);
+    JSTRVEC(productTypes);
+    JINT(flags);
+};
+
 //==========================================================================
 // Class: CfgGrpOrchestration
 //==========================================================================
@@ -283,9 +337,23 @@ public:
     virtual void dump() {
         rules.dump();
         DUMPJSTRSTRMAP(processors);
+        DUMPJSTRGRPMAP(CfgGrpTaskClass, taskClasses);
+        DUMPJINT(taskAging);
+        DUMPJSTR(agentPlacement);
+        DUMPJINT(maxHostLoad);
+        DUMPJINT(minFreeMemory);
+        DUMPJINT(localityWait);
+        DUMPJINT(localCacheSize);
     }
     GRP(CfgGrpRulesList, rules);
     JSTRSTRMAP(processors);
+    JSTRGRPMAP(CfgGrpTaskClass, taskClasses);
+    JINT(taskAging);
+    JSTR(agentPlacement);
+    JINT(maxHostLoad);
+    JINT(minFreeMemory);
+    JINT(localityWait);
+    JINT(localCacheSize);
 };
 
 //==========================================================================
@@ -327,6 +395,11 @@ public:
         DUMPJBOOL(intermediateProducts);
         DUMPJBOOL(sendOutputsToMainArchive);
         DUMPJSTR(progressString);
+        DUMPJBOOL(eventDrivenLoop);
+        DUMPJBOOL(pushTaskDispatch);
+        DUMPJINT(journalSegmentSize);
+        DUMPJINT(journalRotationPeriod);
+        DUMPJINT(fmkMonKeyframePeriod);
     }
     JBOOL(writeMsgsToDisk);
     JSTRVEC(msgsToDisk);
@@ -336,6 +409,11 @@ public:
     JBOOL(intermediateProducts);
     JBOOL(sendOutputsToMainArchive);
     JSTR(progressString);
+    JBOOL(eventDrivenLoop);
+    JBOOL(pushTaskDispatch);
+    JINT(journalSegmentSize);
+    JINT(journalRotationPeriod);
+    JINT(fmkMonKeyframePeriod);
 };
 
 //==========================================================================
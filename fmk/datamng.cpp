@@ -62,6 +62,7 @@
 #include "message.h"
 #include "hostinfo.h"
 #include "launcher.h"
+#include "tracer.h"
 
 #include "config.h"
 
@@ -171,6 +172,7 @@ void DataMng::saveTaskToDB(TaskInfo & taskInfo, bool initialStore)
     if ((taskInfo.taskStatus() == TASK_FINISHED) || (taskInfo.taskStatus() == TASK_FAILED)) {
 
         DBG("TASK FINISHED : Storing outputs into local archive...");
+        Tracer::Scope span(taskInfo.traceId(), "archive.outputs", compName);
 
         URLHandler urlh;
 
@@ -327,7 +329,8 @@ void DataMng::saveProductsToDB(ProductList & productList)
 
 //----------------------------------------------------------------------
 // Method: storeTaskStatusSpectra
-// Store task agent spectra in DB
+// Store task agent spectra in DB.  The update may be a delta, carrying
+// only the agents whose spectra changed since the previous one
 //----------------------------------------------------------------------
 void DataMng::storeTaskStatusSpectra(json & fmkInfoValue)
 {
@@ -363,6 +366,8 @@ void DataMng::storeTaskStatusSpectra(json & fmkInfoValue)
                            sw["finished"].asInt());
         tssSet.push_back(std::make_pair(sw["name"].asString(), tss));
     }
+
+    if (tssSet.empty()) { return; }
     
     std::unique_ptr<DBHandler> dbHdl(new DBHdlPostgreSQL);
 
@@ -569,8 +574,12 @@ void DataMng::txInDataToLocalArch(ProductList & inData)
     for (auto & m : inData.products) {
         urlh.setProduct(m);
         m = urlh.fromInbox2LocalArch();
+        Tracer::instance().recordSinceMark(m.val(), "archive.inbox", compName);
     }
 
     // Save to DB
     saveProductsToDB(inData);
+    for (auto & m : inData.products) {
+        Tracer::instance().recordSinceMark(m.val(), "archive.inbox.db", compName);
+    }
 }
@@ -121,6 +121,12 @@ void JValue::fromStr(std::string content)
     reader.parse(content, value);
 }
 
+void JValue::fromBuffer(const char * data, size_t len)
+{
+    Json::Reader reader;
+    reader.parse(data, data + len, value);
+}
+
 json & JValue::val()
 {
     return value; 
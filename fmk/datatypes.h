@@ -213,6 +213,7 @@ public:
     std::string str(bool styled = false);
     std::string sortedStr(std::vector<std::string> sortKeys);
     void fromStr(std::string content = std::string());
+    void fromBuffer(const char * data, size_t len);
     json & val();
     int size();
     bool has(const char * key);
@@ -320,6 +321,7 @@ struct ProductMetadata : public JRecord {
         DUMPJINT(procTargetType);
         DUMPJSTR(procTarget);
         DUMPJBOOL(hadNoVersion);
+        DUMPJSTR(traceId);
     }
     JSTR(mission);        // %M
     JSTR(startTime);      // %f
@@ -351,6 +353,7 @@ struct ProductMetadata : public JRecord {
     JINT(procTargetType);
     JSTR(procTarget);
     JBOOL(hadNoVersion);
+    JSTR(traceId);
 };
 
 //typedef std::vector<ProductMetadata>           ProductList;
@@ -434,6 +437,9 @@ struct TaskInfo : public JRecord {
         DUMPJSTR(taskData);
         DUMPJSTR(taskSet);
         DUMPJSTR(taskSession);
+        DUMPJSTR(traceId);
+        DUMPJSTR(taskRule);
+        DUMPJSTR(taskOrigin);
     }
     JSTR(taskName);
     JSTR(taskPath);
@@ -450,6 +456,9 @@ struct TaskInfo : public JRecord {
     JSTR(taskData);
     JSTR(taskSet);
     JSTR(taskSession);
+    JSTR(traceId);
+    JSTR(taskRule);
+    JSTR(taskOrigin);
 };
 
 struct TaskAgentInfo : public JRecord {
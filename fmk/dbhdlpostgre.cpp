@@ -41,6 +41,9 @@
 #include <iterator>
 #include <arpa/inet.h>
 #include <fstream>
+#include <chrono>
+#include <mutex>
+#include <algorithm>
 
 #include "dbhdlpostgre.h"
 
@@ -51,6 +54,7 @@
 #include "dbg.h"
 #include "str.h"
 #include "message.h"
+#include "metrics.h"
 
 using Configuration::cfg;
 
@@ -109,9 +113,41 @@ bool DBHdlPostgreSQL::openConnection(const char * data)
         PQfinish(conn);
         throw RuntimeException(msg);
     }
+
+    // Databases created with an older qpfdb.sql are updated with the
+    // first connection of the process
+    static std::once_flag schemaMigrated;
+    std::call_once(schemaMigrated, [this] () { migrateSchema(); });
     return true;
 }
 
+//----------------------------------------------------------------------
+// Method: migrateSchema
+// Bring a database created with an older qpfdb.sql up to date.  Each
+// statement must do nothing if the change is already there.  If one of
+// them fails, the connection is closed, and the next one tries again
+//----------------------------------------------------------------------
+void DBHdlPostgreSQL::migrateSchema()
+{
+    static const char * migrations[] = {
+        // Identical alerts are stored once, with the number of repeats
+        "ALTER TABLE alerts ADD COLUMN IF NOT EXISTS repeats integer DEFAULT 1;"
+    };
+
+    for (auto m : migrations) {
+        PGresult * r = PQexec(conn, m);
+        if (PQresultStatus(r) != PGRES_COMMAND_OK) {
+            std::string msg = (std::string("Failed schema migration '") + m + "': " +
+                               std::string(PQerrorMessage(conn)));
+            PQclear(r);
+            PQfinish(conn);
+            conn = 0;
+            throw RuntimeException(msg);
+        }
+        PQclear(r);
+    }
+}
+
 //----------------------------------------------------------------------
 // Method: closeConnection
 // Closes the connection to the database
@@ -666,8 +702,29 @@ int DBHdlPostgreSQL::getNumRowsInTable(std::string tName)
 //----------------------------------------------------------------------
 bool DBHdlPostgreSQL::runCmd(std::string cmd)
 {
+    // Latency per kind of statement
+    static const char * ops[] = { "select", "insert", "update", "delete", "other" };
+    static Histogram * opLatency[5] = { 0, 0, 0, 0, 0 };
+    static std::once_flag once;
+    std::call_once(once, [] () {
+            for (int i = 0; i < 5; ++i) {
+                opLatency[i] = &Metrics::instance().histogram("qpf_db_op_seconds",
+                                                              "Latency of DB statements",
+                                                              Histogram::expBounds(0.0005, 2, 14),
+                                                              Metrics::labels({{"op", ops[i]}}));
+            }
+        });
+    size_t p = cmd.find_first_not_of(" \t\n(");
+    std::string kw(cmd.substr((p == std::string::npos) ? 0 : p, 6));
+    std::transform(kw.begin(), kw.end(), kw.begin(), ::tolower);
+    int op = 0;
+    while ((op < 4) && (kw != ops[op])) { ++op; }
+
     // Run the command
+    auto t0 = std::chrono::steady_clock::now();
     res = PQexec(conn, cmd.c_str());
+    opLatency[op]->observe(std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                                         - t0).count());
     if ((PQresultStatus(res) != PGRES_COMMAND_OK) &&
             (PQresultStatus(res) != PGRES_TUPLES_OK)) {
         std::string msg = (std::string("Failed cmd '" + cmd + "': ") +
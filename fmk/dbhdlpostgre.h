@@ -271,6 +271,12 @@ private:
     bool updateTable(std::string table, std::string cond,
                      std::vector<std::string> & newValues);
 
+    //----------------------------------------------------------------------
+    // Method: migrateSchema
+    // Bring a database created with an older qpfdb.sql up to date
+    //----------------------------------------------------------------------
+    void migrateSchema();
+
 private:
     PGconn     * conn;
     PGresult   * res;
@@ -43,6 +43,8 @@
 #include "filenamespec.h"
 #include "message.h"
 #include "hostinfo.h"
+#include "tracer.h"
+#include "metrics.h"
 
 #include "config.h"
 
@@ -52,7 +54,10 @@ using Configuration::cfg;
 // Constructor
 //----------------------------------------------------------------------
 EvtMng::EvtMng(const char * name, const char * addr, Synchronizer * s)
-    : Component(name, addr, s)
+    : Component(name, addr, s),
+      inboxProducts(std::string(name) + ".inboxProducts", 0, OverflowQueueBase::Coalesce),
+      events(std::string(name) + ".events", 0, OverflowQueueBase::Coalesce),
+      inDataListener(0)
 {
 }
 
@@ -60,7 +65,10 @@ EvtMng::EvtMng(const char * name, const char * addr, Synchronizer * s)
 // Constructor
 //----------------------------------------------------------------------
 EvtMng::EvtMng(std::string name, std::string addr, Synchronizer * s)
-    : Component(name, addr, s)
+    : Component(name, addr, s),
+      inboxProducts(name + ".inboxProducts", 0, OverflowQueueBase::Coalesce),
+      events(name + ".events", 0, OverflowQueueBase::Coalesce),
+      inDataListener(0)
 {
 }
 
@@ -71,6 +79,9 @@ void EvtMng::fromRunningToOperational()
 {
     requestQuit = false;
     hmiActive = false;
+
+    configureQueue(events,        "events");
+    configureQueue(inboxProducts, "inboxProducts");
     
     // Install DirWatcher at inbox folder
     dw = new DirWatcher(Config::PATHBase + "/data/inbox");
@@ -100,24 +111,27 @@ void EvtMng::runEachIteration()
 {
     
     // 1. Check DirWatcher events from inbox folder
+    // Repeated events on the same file are coalesced
     DirWatcher::DirWatchEvent ev;
-    while (dw->nextEvent(ev)) { events.push_back(ev); }
+    while (dw->nextEvent(ev)) { events.push(ev, ev.path + "/" + ev.name); }
 
     // Process all events, at most 5 per second
     int numMaxEventsPerIter = 5;
     int numEvents = 0;
-    while ((events.size() > 0) && (numEvents < numMaxEventsPerIter)) {
-        auto & e = events.front();
-        TRC("New DirWatchEvent: " + e.path + "/" + e.name
-            + (e.isDir ? " DIR " : " ") + std::to_string(e.mask));
+    bool newInData = false;
+    while ((numEvents < numMaxEventsPerIter) && events.pop(ev)) {
+        ++numEvents;
+        TRC("New DirWatchEvent: " + ev.path + "/" + ev.name
+            + (ev.isDir ? " DIR " : " ") + std::to_string(ev.mask));
 
         // Process only files
         // TODO: Process directories that appear at inbox
-        if (! e.isDir) {
+        if (! ev.isDir) {
             // Build full file name
-            std::string file(e.path + "/" + e.name);
+            std::string file(ev.path + "/" + ev.name);
 
             // Set new content for InData Message
+            int64_t detected = Tracer::now();
             FileNameSpec fs;
             ProductMetadata m;
             if (!fs.parseFileName(file, m)) {
@@ -125,16 +139,24 @@ void EvtMng::runEachIteration()
                 continue;
             }
 
-            {
-                std::lock_guard<std::mutex> lock(mtxInData);
-                m["urlSpace"] = InboxSpace;
-                inboxProducts.products.push_back(m);
-            }
+            m["urlSpace"] = InboxSpace;
+            static Counter & ingested =
+                Metrics::instance().counter("qpf_products_ingested_total",
+                                            "Products found in the inbox");
+            ingested.inc();
+
+            // The trace of the product starts here
+            m["traceId"] = Tracer::newTraceId();
+            Tracer::instance().record(m.traceId(), "ingest", compName,
+                                      detected, Tracer::now());
+            Tracer::mark(m.val());
+            inboxProducts.push(m, file);
+            newInData = true;
         }
-        events.erase(events.begin());
-        ++numEvents;
     }
 
+    if (newInData && (inDataListener != 0)) { inDataListener->wakeUp(); }
+
     bool sendInit = ((iteration + 1) == 100);
     if (sendInit) {
         Message<MsgBodyCMD> msg;
@@ -147,18 +169,18 @@ void EvtMng::runEachIteration()
         body["sessionId"] = cfg.sessionId;
 
         msg.buildBody(body);
-        this->send(ChnlCmd, msg.str());
+        this->send(ChnlCmd, msg);
     }
 }
 
 //----------------------------------------------------------------------
 // Method: processHMICmdMsg
 //----------------------------------------------------------------------
-void EvtMng::processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m)
+void EvtMng::processHMICmdMsg(ScalabilityProtocolRole* c, MessageBase & m)
 {
     hmiActive = true;
     
-    Message<MsgBodyCMD> msg(m);
+    Message<MsgBodyCMD> msg(std::move(m));
     MsgBodyCMD body;
     std::string cmd = msg.body["cmd"].asString();
 
@@ -194,11 +216,11 @@ void EvtMng::processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m)
     } else if (cmd == CmdConfig) { // Embedded is message to TskAgents
 
         // Send relay message
-        Message<MsgBodyCMD> relayMsg(m);
+        Message<MsgBodyCMD> relayMsg(msg.val());
         relayMsg.buildHdr(ChnlCmd, MsgCmd, CHNLS_IF_VERSION,
                           compName, "*",
                           "", "", "");
-        this->send(ChnlCmd, relayMsg.str());
+        this->send(ChnlCmd, relayMsg);
                     
         // Build HMICmd answer
         msg.buildHdr(ChnlHMICmd, MsgHMICmd, CHNLS_IF_VERSION,
@@ -209,11 +231,11 @@ void EvtMng::processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m)
     } else if (cmd == CmdProcHdl) { // Embedded is message to TskAgents
 
         // Send relay message
-        Message<MsgBodyCMD> relayMsg(m);
+        Message<MsgBodyCMD> relayMsg(msg.val());
         relayMsg.buildHdr(ChnlCmd, MsgCmd, CHNLS_IF_VERSION,
                           compName, "*",
                           "", "", "");
-        this->send(ChnlCmd, relayMsg.str());
+        this->send(ChnlCmd, relayMsg);
                     
         // Build HMICmd answer
         msg.buildHdr(ChnlHMICmd, MsgHMICmd, CHNLS_IF_VERSION,
@@ -226,9 +248,15 @@ void EvtMng::processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m)
         ProductList prodList(msg.body["products"]);
         TRC("Received CmdReproc with " +
             std::to_string(prodList.products.size()) + " products");
+        for (auto & p : prodList.products) {
+            // Each reprocessing is traced on its own
+            p["traceId"] = Tracer::newTraceId();
+            Tracer::mark(p.val());
+        }
         std::lock_guard<std::mutex> lock(mtxReproc);
         reprocProducts.products = std::move(prodList.products);
         reprocFlags = msg.body["flags"].asInt();
+        if (inDataListener != 0) { inDataListener->wakeUp(); }
         
     } else if (cmd == CmdQuit) { // Quit request
 
@@ -239,7 +267,7 @@ void EvtMng::processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m)
 
     msg.buildBody(body);
 
-    this->send(ChnlHMICmd, msg.str());
+    this->send(ChnlHMICmd, msg);
 }
 
 //----------------------------------------------------------------------
@@ -261,7 +289,7 @@ void EvtMng::sendStopAgentTasks()
     body["target"]      = "*";
     
     msg.buildBody(body);
-    this->send(ChnlCmd, msg.str()); 
+    this->send(ChnlCmd, msg); 
 }
 
 //----------------------------------------------------------------------
@@ -270,10 +298,15 @@ void EvtMng::sendStopAgentTasks()
 //----------------------------------------------------------------------
 bool EvtMng::getInData(ProductList & inData, std::string & space)
 {
-    bool retVal = inboxProducts.products.size() > 0;
+    std::list<std::pair<std::string, ProductMetadata>> prods;
+    inboxProducts.takeAll(prods);
+    bool retVal = ! prods.empty();
     if (retVal) {
-        std::lock_guard<std::mutex> lock(mtxInData);
-        inData.products = std::move(inboxProducts.products);
+        inData.products.clear();
+        for (auto & kv : prods) {
+            Tracer::instance().recordSinceMark(kv.second.val(), "inbox.wait", compName);
+            inData.products.push_back(kv.second);
+        }
         space = inData.products.at(0).urlSpace();
     }
     return (retVal);
@@ -326,7 +359,7 @@ void EvtMng::quit()
     body["cmd"] = CmdQuit;
 
     msg.buildBody(body);
-    this->send(ChnlCmd, msg.str());
+    this->send(ChnlCmd, msg);
 
     sleep(3);
 
@@ -356,6 +389,14 @@ void EvtMng::sendProcFmkInfoUpdate(json & fmkInfoValue)
                  compName, "HMIProxy", "", "", "");
 
     // Send msg
-    this->send(ChnlFmkMon, msg.str());        
+    this->send(ChnlFmkMon, msg);        
 }
 
+//----------------------------------------------------------------------
+// Method: setInDataListener
+// Set the component to wake up when new products are available
+//----------------------------------------------------------------------
+void EvtMng::setInDataListener(Component * c)
+{
+    inDataListener = c;
+}
@@ -131,29 +131,36 @@ public:
     // Store in argument variables the INDATA products
     //----------------------------------------------------------------------
     void sendStopAgentTasks();
+
+    //----------------------------------------------------------------------
+    // Method: setInDataListener
+    // Set the component to wake up when new products are available
+    //----------------------------------------------------------------------
+    void setInDataListener(Component * c);
     
 protected:
     //----------------------------------------------------------------------
     // Method: processHMICmdMsg
     //----------------------------------------------------------------------
-    virtual void processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m);
+    virtual void processHMICmdMsg(ScalabilityProtocolRole* c, MessageBase & m);
 
 private:
     DirWatcher * dw;
 
-    ProductList inboxProducts;
+    OverflowQueue<ProductMetadata> inboxProducts;
     ProductList reprocProducts;
     int         reprocFlags;
 
-    std::mutex mtxInData;
     std::mutex mtxReproc;
     std::mutex mtxHostInfo;
 
     std::map<std::string, json> elements;
 
-    std::vector<DirWatcher::DirWatchEvent> events;
+    OverflowQueue<DirWatcher::DirWatchEvent> events;
     
     bool requestQuit;
     bool hmiActive;
+
+    Component * inDataListener;
 };
 #endif
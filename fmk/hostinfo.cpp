@@ -88,6 +88,8 @@ HostInfo & HostInfo::operator=( const HostInfo & obj)
     loadAvg.totalProc  = obj.loadAvg.totalProc;
     loadAvg.lastPid    = obj.loadAvg.lastPid;
 
+    memInfo = obj.memInfo;
+
     cpuInfo.vendor            = obj.cpuInfo.vendor;
     cpuInfo.modelName         = obj.cpuInfo.modelName;
     cpuInfo.architecture      = obj.cpuInfo.architecture;
@@ -152,7 +154,9 @@ std::string HostInfo::dump()
       << l.load15min << "\n"
       << "Processes: " << l.runProc << " running of a total of "
       << l.totalProc << "\n"
-      << "Last PID: " << l.lastPid << "\n";
+      << "Last PID: " << l.lastPid << "\n"
+      << "Memory: " << memInfo.memAvailable << " kB available of "
+      << memInfo.memTotal << " kB\n";
     return s.str();
 }
 
@@ -208,7 +212,11 @@ std::string HostInfo::toJsonStr()
           << "\"computedLoad\":" << o.computedLoad << "}";
         if (i < (c.numCpus - 1)) { s << ","; }
     }
-    s << "]}}";
+    s << "]},";
+
+    s << "\"memInfo\":{"
+      << "\"memTotal\":" << memInfo.memTotal << ","
+      << "\"memAvailable\":" << memInfo.memAvailable << "}}";
 
     return s.str();
 }
@@ -232,6 +240,10 @@ void HostInfo::fromStr(std::string s)
     l.totalProc = hl["totalProc"].asUInt();
     l.lastPid   = hl["lastPid"].asUInt();
 
+    JValue hm(h["memInfo"]);
+    memInfo.memTotal     = hm["memTotal"].asUInt64();
+    memInfo.memAvailable = hm["memAvailable"].asUInt64();
+
     JValue hc(h["cpuInfo"]);
     c.vendor            = hc["vendor"].asString();
     c.modelName         = hc["modelName"].asString();
@@ -253,6 +265,7 @@ void HostInfo::fromStr(std::string s)
     co.timeInterval  = hco["timeInterval"].asUInt();
     co.computedLoad  = hco["computedLoad"].asFloat();
 
+    c.cpuLoad.clear();
     for (int i = 0; i < c.numCpus; ++i) {
         c.cpuLoad.push_back(CPULoad());
         CPULoad & co = c.cpuLoad[i];
@@ -279,6 +292,22 @@ void HostInfo::getLoadAvg(LoadAvg & l)
     }
 }
 
+void HostInfo::getMemInfo(MemInfo & m)
+{
+    std::ifstream inFile;
+    inFile.open("/proc/meminfo", std::ifstream::in);
+    std::string tag, unit;
+    unsigned long value;
+    while (inFile >> tag >> value) {
+        if (tag == "MemTotal:") {
+            m.memTotal = value;
+        } else if (tag == "MemAvailable:") {
+            m.memAvailable = value;
+        }
+        std::getline(inFile, unit);
+    }
+}
+
 void HostInfo::getCPULoad(CPULoad & c, int line)
 {
     std::string tag;
@@ -413,6 +442,7 @@ void HostInfo::getHostInfo()
 {
     getCPUInfo(cpuInfo);
     getLoadAvg(loadAvg);
+    getMemInfo(memInfo);
 }
 
 //}
@@ -123,9 +123,17 @@ public:
         std::vector<CPULoad> cpuLoad;
     };
 
+    // Memory sizes (kB); 0 if unknown
+    struct MemInfo {
+        MemInfo() : memTotal(0), memAvailable(0) {}
+        unsigned long memTotal;
+        unsigned long memAvailable;
+    };
+
 public:
     CPUInfo cpuInfo;
     LoadAvg loadAvg;
+    MemInfo memInfo;
     std::string hostIp;
 
 public:
@@ -138,6 +146,7 @@ private:
     void getLoadAvg(LoadAvg & l);
     void getCPULoad(CPULoad & c, int line = 0);
     void getCPUInfo(CPUInfo & info);
+    void getMemInfo(MemInfo & m);
     void getHostInfo();
 
     bool firstUpdate;
@@ -43,6 +43,8 @@
 #include "log.h"
 #include "tools.h"
 #include "str.h"
+#include "metrics.h"
+#include "loopprof.h"
 
 #include "config.h"
 
@@ -739,6 +741,45 @@ void HttpServer::stat(Request &request, StreamResponse &response)
     response << wc.getPage() << std::endl;
 }
 
+//----------------------------------------------------------------------
+// Method: metrics
+// Serve the metrics registry in Prometheus text format.  The registry is
+// read without locks, so that scrapes never hold the components
+//----------------------------------------------------------------------
+void HttpServer::metrics(Request &request, StreamResponse &response)
+{
+    response.setHeader("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+    response << Metrics::instance().exposition();
+}
+
+//----------------------------------------------------------------------
+// Method: profile
+// Serve the main loop profiles of the components of this process, as
+// JSON.  The profiles are read without locks
+//----------------------------------------------------------------------
+void HttpServer::profile(Request &request, StreamResponse &response)
+{
+    json v;
+    LoopProfiler::allToJson(v);
+    Json::StyledWriter writer;
+    response.setHeader("Content-Type", "application/json");
+    response << writer.write(v);
+}
+
+//----------------------------------------------------------------------
+// Method: channels
+// Serve the traffic counters and latency percentiles of the channels of
+// the components of this process, as JSON
+//----------------------------------------------------------------------
+void HttpServer::channels(Request &request, StreamResponse &response)
+{
+    json v;
+    Component::allChannelStats(v);
+    Json::StyledWriter writer;
+    response.setHeader("Content-Type", "application/json");
+    response << writer.write(v);
+}
+
 //----------------------------------------------------------------------
 // Method: genPageLeftColumn()
 //----------------------------------------------------------------------
@@ -883,6 +924,9 @@ void HttpServer::setup()
     addRoute("GET",  "/info",      HttpServer, info);
     addRoute("GET",  "/config",    HttpServer, config);
     addRoute("GET",  "/stat",      HttpServer, stat);
+    addRoute("GET",  "/metrics",   HttpServer, metrics);
+    addRoute("GET",  "/profile",   HttpServer, profile);
+    addRoute("GET",  "/channels",  HttpServer, channels);
 
     // Data server
     addRoute("GET",  "/get_task",      HttpServer, info);
@@ -117,6 +117,25 @@ public:
     //----------------------------------------------------------------------
     void stat(Request &request, StreamResponse &response);
         
+    //----------------------------------------------------------------------
+    // Method: metrics
+    // Serve the metrics registry in Prometheus text format
+    //----------------------------------------------------------------------
+    void metrics(Request &request, StreamResponse &response);
+
+    //----------------------------------------------------------------------
+    // Method: profile
+    // Serve the main loop profiles of the components, as JSON
+    //----------------------------------------------------------------------
+    void profile(Request &request, StreamResponse &response);
+
+    //----------------------------------------------------------------------
+    // Method: channels
+    // Serve the traffic and latency statistics of the channels of the
+    // components, as JSON
+    //----------------------------------------------------------------------
+    void channels(Request &request, StreamResponse &response);
+
     //----------------------------------------------------------------------
     // Method: form
     //----------------------------------------------------------------------
@@ -0,0 +1,235 @@
+/******************************************************************************
+ * File:    loopprof.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.LoopProfiler
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement LoopProfiler class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "loopprof.h"
+
+#include <cstdio>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+static json histoToJson(const LatencyHistogram & h)
+{
+    json x(Json::objectValue);
+    x["count"] = Json::UInt64(h.count());
+    x["p50"]   = h.percentile(50.) * 1.e-3;
+    x["p90"]   = h.percentile(90.) * 1.e-3;
+    x["p99"]   = h.percentile(99.) * 1.e-3;
+    x["max"]   = h.max() * 1.e-3;
+    x["mean"]  = h.mean() * 1.e-3;
+    return x;
+}
+
+//----------------------------------------------------------------------
+// Method: reset
+//----------------------------------------------------------------------
+void LoopProfiler::Window::reset()
+{
+    for (auto & h : phases)   { h.reset(); }
+    for (auto & h : handlers) { h.reset(); }
+    busy.reset();
+    iterations = 0;
+    overruns   = 0;
+}
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+LoopProfiler::LoopProfiler()
+    : active(0), totalOverruns(0), overrunCounter(0)
+{
+    win[0].reset();
+    win[1].reset();
+}
+
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+LoopProfiler::~LoopProfiler()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().erase(this);
+}
+
+//----------------------------------------------------------------------
+// Method: attach
+// Name the profiler after its component, and make it visible
+//----------------------------------------------------------------------
+void LoopProfiler::attach(const std::string & owner)
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    name = owner;
+    overrunCounter = &Metrics::instance().counter("qpf_loop_overruns_total",
+                                                  "Loop iterations longer than the step",
+                                                  Metrics::labels({{"comp", owner}}));
+    registry().insert(this);
+}
+
+//----------------------------------------------------------------------
+// Method: iteration
+// Record the busy time of an iteration
+//----------------------------------------------------------------------
+void LoopProfiler::iteration(uint64_t busyNs, uint64_t stepNs)
+{
+    Window & w = cur();
+    w.busy.record(busyNs);
+    w.iterations.fetch_add(1, std::memory_order_relaxed);
+    if (busyNs > stepNs) { overrun(); }
+}
+
+//----------------------------------------------------------------------
+// Method: overrun
+// Count overruns
+//----------------------------------------------------------------------
+void LoopProfiler::overrun(uint64_t n)
+{
+    cur().overruns.fetch_add(n, std::memory_order_relaxed);
+    totalOverruns.fetch_add(n, std::memory_order_relaxed);
+    if (overrunCounter != 0) { overrunCounter->inc(n); }
+}
+
+//----------------------------------------------------------------------
+// Method: rotate
+// Close the current window, which becomes the last one
+//----------------------------------------------------------------------
+void LoopProfiler::rotate()
+{
+    int next = 1 - active.load(std::memory_order_relaxed);
+    win[next].reset();
+    active.store(next, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------
+// Method: toJson
+// Percentiles (us) of the last window
+//----------------------------------------------------------------------
+void LoopProfiler::toJson(json & v)
+{
+    Window & w = last();
+    v = json(Json::objectValue);
+    v["iterations"]    = Json::UInt64(w.iterations.load());
+    v["overruns"]      = Json::UInt64(w.overruns.load());
+    v["totalOverruns"] = Json::UInt64(totalOverruns.load());
+    v["busy"]          = histoToJson(w.busy);
+    for (int p = 0; p < NumPhases; ++p) {
+        v["phases"][phaseName(Phase(p))] = histoToJson(w.phases[p]);
+    }
+    v["handlers"] = json(Json::objectValue);
+    for (int i = 0; i < NumHandlers; ++i) {
+        if (w.handlers[i].count() > 0) {
+            v["handlers"][ChannelAcronym[i]] = histoToJson(w.handlers[i]);
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: summary
+// One line summary of the last window
+//----------------------------------------------------------------------
+std::string LoopProfiler::summary()
+{
+    Window & w = last();
+    char buf[64];
+    auto us = [&buf] (uint64_t ns) -> std::string {
+        snprintf(buf, sizeof(buf), "%.1f", ns * 1.e-3);
+        return std::string(buf);
+    };
+
+    std::string s("Loop: " + std::to_string(w.iterations.load()) + " iter., " +
+                  std::to_string(w.overruns.load()) + " overruns; busy p50/p99 " +
+                  us(w.busy.percentile(50.)) + "/" + us(w.busy.percentile(99.)) +
+                  " us; p99 (us):");
+    for (int p = 0; p < NumPhases; ++p) {
+        s += std::string(" ") + phaseName(Phase(p)) + " " + us(w.phases[p].percentile(99.));
+    }
+    int slowest = -1;
+    for (int i = 0; i < NumHandlers; ++i) {
+        if ((w.handlers[i].count() > 0) &&
+            ((slowest < 0) ||
+             (w.handlers[i].percentile(99.) > w.handlers[slowest].percentile(99.)))) {
+            slowest = i;
+        }
+    }
+    if (slowest >= 0) {
+        s += "; slowest handler " + ChannelAcronym[slowest] + " " +
+            us(w.handlers[slowest].percentile(99.));
+    }
+    return s;
+}
+
+//----------------------------------------------------------------------
+// Static Method: allToJson
+// Profiles of all the attached profilers of the process
+//----------------------------------------------------------------------
+void LoopProfiler::allToJson(json & v)
+{
+    v = json(Json::objectValue);
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (auto p : registry()) { p->toJson(v[p->name]); }
+}
+
+//----------------------------------------------------------------------
+// Static Method: phaseName
+//----------------------------------------------------------------------
+const char * LoopProfiler::phaseName(Phase p)
+{
+    static const char * names[] = { "updateConnections", "processIncommingMessages",
+                                    "runPostedTasks", "runEachIteration", "sleep" };
+    return names[p];
+}
+
+std::set<LoopProfiler*> & LoopProfiler::registry()
+{
+    static std::set<LoopProfiler*> r;
+    return r;
+}
+
+std::mutex & LoopProfiler::registryMutex()
+{
+    static std::mutex m;
+    return m;
+}
+
+//}
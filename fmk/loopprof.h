@@ -0,0 +1,206 @@
+/******************************************************************************
+ * File:    loopprof.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.LoopProfiler
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare LoopProfiler class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef LOOPPROF_H
+#define LOOPPROF_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - atomic
+//   - chrono
+//   - mutex
+//   - set
+//------------------------------------------------------------
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - latency.h
+//   - channels.h
+//   - datatypes.h
+//   - metrics.h
+//------------------------------------------------------------
+#include "latency.h"
+#include "channels.h"
+#include "datatypes.h"
+#include "metrics.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: LoopProfiler
+// Always-on timing of the phases of the main loop of a component, and
+// of each message handler, in nanoseconds (steady clock).  The times
+// go to histograms of the current window; when the window is rotated
+// (periodically, by the owner thread) it becomes the last window, from
+// which the percentiles are reported.  An iteration whose busy time
+// exceeds the step counts as an overrun.  Only the owner thread records
+// and rotates; readers (e.g. the HTTP server) just load atomics
+//==========================================================================
+class LoopProfiler {
+
+public:
+    enum Phase {
+        UpdateConnections,
+        ProcessMessages,
+        PostedTasks,
+        EachIteration,
+        Sleep,
+        NumPhases
+    };
+
+    static const int NumHandlers = TX_ID_UNKNOWN + 1;
+
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    LoopProfiler();
+
+    //----------------------------------------------------------------------
+    // Destructor
+    //----------------------------------------------------------------------
+    ~LoopProfiler();
+
+    //----------------------------------------------------------------------
+    // Method: attach
+    // Name the profiler after its component, and make it visible through
+    // allToJson
+    //----------------------------------------------------------------------
+    void attach(const std::string & owner);
+
+    //----------------------------------------------------------------------
+    // Method: now
+    // Current time of the steady clock, in ns
+    //----------------------------------------------------------------------
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void phase(Phase p, uint64_t ns) { cur().phases[p].record(ns); }
+    void handler(int msgId, uint64_t ns) { cur().handlers[msgId].record(ns); }
+
+    //----------------------------------------------------------------------
+    // Method: iteration
+    // Record the busy time of an iteration, and count it as an overrun
+    // if it exceeds the step
+    //----------------------------------------------------------------------
+    void iteration(uint64_t busyNs, uint64_t stepNs);
+
+    //----------------------------------------------------------------------
+    // Method: overrun
+    // Count overruns detected otherwise (e.g. missed heart beats)
+    //----------------------------------------------------------------------
+    void overrun(uint64_t n = 1);
+
+    //----------------------------------------------------------------------
+    // Method: rotate
+    // Close the current window, which becomes the last one
+    //----------------------------------------------------------------------
+    void rotate();
+
+    //----------------------------------------------------------------------
+    // Method: toJson
+    // Percentiles (us) of each phase and handler in the last window, and
+    // iteration and overrun counts
+    //----------------------------------------------------------------------
+    void toJson(json & v);
+
+    //----------------------------------------------------------------------
+    // Method: summary
+    // One line summary of the last window, for the log
+    //----------------------------------------------------------------------
+    std::string summary();
+
+    //----------------------------------------------------------------------
+    // Static Method: allToJson
+    // Profiles of all the attached profilers of the process
+    //----------------------------------------------------------------------
+    static void allToJson(json & v);
+
+    static const char * phaseName(Phase p);
+
+private:
+    struct Window {
+        void reset();
+        LatencyHistogram      phases[NumPhases];
+        LatencyHistogram      handlers[NumHandlers];
+        LatencyHistogram      busy;
+        std::atomic<uint64_t> iterations;
+        std::atomic<uint64_t> overruns;
+    };
+
+    Window & cur()  { return win[active.load(std::memory_order_relaxed)]; }
+    Window & last() { return win[1 - active.load(std::memory_order_acquire)]; }
+
+    static std::set<LoopProfiler*> & registry();
+    static std::mutex & registryMutex();
+
+private:
+    std::string      name;
+    Window           win[2];
+    std::atomic<int> active;
+    std::atomic<uint64_t> totalOverruns;
+    Counter *        overrunCounter;
+};
+
+//}
+
+#endif // LOOPPROF_H
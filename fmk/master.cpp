@@ -43,6 +43,7 @@
 #include "filenamespec.h"
 #include "message.h"
 #include "hostinfo.h"
+#include "tracer.h"
 
 #include "config.h"
 
@@ -75,8 +76,12 @@ void Master::init()
     tskOrc = new TskOrc  ("TskOrc", compAddress, synchro);
 
     subComponents = {evtMng, datMng, logMng, tskOrc, tskMng};
+
+    // New input products should not wait for the next heart beat
+    evtMng->setInDataListener(this);
     
     requestQuit = false;
+    hmiWasActive = false;
 }
 
 //----------------------------------------------------------------------
@@ -126,6 +131,50 @@ void Master::fromOperationalToRunning()
 void Master::runEachIteration()
 {
     // 1. Check input products
+    processNewInputs();
+
+    // 2. Check QUIT request
+    if (evtMng->isQuitRequested()) {
+        doControlledQuit();
+    }
+
+    // 3. Retrieve and store Task reports
+    json tskRepData;
+    if (tskMng->getTskRepUpdate(tskRepData)) {
+        datMng->storeTskRegData(tskRepData);
+    }
+    
+    // 4. Retrieve and send FMK monitoring information (only the parts
+    //    changed since the last update, and a keyframe when the HMI
+    //    becomes active)
+    bool hmiActive = evtMng->isHMIActive();
+    if (hmiActive) {
+        json fmkInfoValue;
+        if (tskMng->getProcFmkInfoUpdate(fmkInfoValue, ! hmiWasActive)) {
+            evtMng->sendProcFmkInfoUpdate(fmkInfoValue);
+            datMng->storeTaskStatusSpectra(fmkInfoValue);
+        }
+    }
+    hmiWasActive = hmiActive;
+}
+
+//----------------------------------------------------------------------
+// Method: runOnWakeUp
+//----------------------------------------------------------------------
+void Master::runOnWakeUp()
+{
+    processNewInputs();
+}
+
+//----------------------------------------------------------------------
+// Method: processNewInputs
+// Create and schedule tasks for new inbox and reprocessing products
+//----------------------------------------------------------------------
+void Master::processNewInputs()
+{
+    // While the pool of tasks is full, new products wait in the inbox
+    if (! schedulePendingTasks()) { return; }
+
     std::vector<TaskInfo> tasks;
 
     ProductList inData;
@@ -143,7 +192,13 @@ void Master::runEachIteration()
         }
 
         // b. Generate tasks for processing these products
+        size_t first = tasks.size();
         tskOrc->createTasks(inData, 0, tasks);
+        if (space == ReprocessingSpace) {
+            for (size_t i = first; i < tasks.size(); ++i) {
+                tasks[i]["taskOrigin"] = "reprocessing";
+            }
+        }
 
     }
 
@@ -155,7 +210,11 @@ void Master::runEachIteration()
         TRC("There are products to be reprocessed!");
         
         // c. Generate tasks for re-processing these products
+        size_t first = tasks.size();
         tskOrc->createTasks(reprocData, reprocFlags, tasks);
+        for (size_t i = first; i < tasks.size(); ++i) {
+            tasks[i]["taskOrigin"] = "reprocessing";
+        }
 
     }
 
@@ -169,28 +228,27 @@ void Master::runEachIteration()
 
         // e. Schedule tasks (Task Manager will send them to requesters)
         TRC("Scheduling tasks");
-        for (auto & task: tasks) { tskMng->scheduleTask(task); }
+        pendingTasks.insert(pendingTasks.end(), tasks.begin(), tasks.end());
+        schedulePendingTasks();
         
     }
+}
 
-    // 2. Check QUIT request
-    if (evtMng->isQuitRequested()) {
-        doControlledQuit();
-    }
-
-    // 3. Retrieve and store Task reports
-    json tskRepData;
-    if (tskMng->getTskRepUpdate(tskRepData)) {
-        datMng->storeTskRegData(tskRepData);
+//----------------------------------------------------------------------
+// Method: schedulePendingTasks
+// Schedule the tasks the pool of tasks could not take yet, in order;
+// returns false if some of them are still pending
+//----------------------------------------------------------------------
+bool Master::schedulePendingTasks()
+{
+    while (! pendingTasks.empty()) {
+        if (! tskMng->scheduleTask(pendingTasks.front())) {
+            TRC(std::to_string(pendingTasks.size()) + " tasks waiting for the pool of tasks");
+            return false;
+        }
+        pendingTasks.pop_front();
     }
-    
-    // 4. Retrieve and send FMK monitoring information
-    if (evtMng->isHMIActive()) {
-        json fmkInfoValue;
-        tskMng->getProcFmkInfoUpdate(fmkInfoValue);
-        evtMng->sendProcFmkInfoUpdate(fmkInfoValue);
-        datMng->storeTaskStatusSpectra(fmkInfoValue);
-    }   
+    return true;
 }
 
 //----------------------------------------------------------------------
@@ -198,14 +256,22 @@ void Master::runEachIteration()
 //----------------------------------------------------------------------
 void Master::doControlledQuit()
 {
-    std::map<std::string, MessageString> runningTasks;
+    std::map<std::string, json> runningTasks;
     tskMng->getRunningTasks(runningTasks);
-    std::map<std::string, MessageString>::iterator it = runningTasks.begin();
+    std::map<std::string, json>::iterator it = runningTasks.begin();
     while (it != runningTasks.end()) {
-        TRC(it->first + " ==> " + it->second);
+        TRC(it->first + " ==> " + JValue(it->second).str());
         ++it;
     }
 
+    // Keep the product traces of the session
+    std::string traceFile(Config::PATHSession + "/trace.json");
+    if (Tracer::instance().exportChromeTrace(traceFile)) {
+        InfoMsg("Product traces exported to " + traceFile);
+    } else {
+        WarnMsg("Cannot export product traces to " + traceFile);
+    }
+
     evtMng->quit();
     transitTo(RUNNING);
 }
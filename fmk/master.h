@@ -47,7 +47,9 @@
 
 //------------------------------------------------------------
 // Topic: System headers
+//   - list
 //------------------------------------------------------------
+#include <list>
 
 //------------------------------------------------------------
 // Topic: External packages
@@ -110,10 +112,29 @@ public:
     //----------------------------------------------------------------------
     virtual void runEachIteration();
 
+    //----------------------------------------------------------------------
+    // Method: runOnWakeUp
+    //----------------------------------------------------------------------
+    virtual void runOnWakeUp();
+
     //----------------------------------------------------------------------
     // Method: runEachIteration
     //----------------------------------------------------------------------
     void doControlledQuit();
+
+private:
+    //----------------------------------------------------------------------
+    // Method: processNewInputs
+    // Create and schedule tasks for new inbox and reprocessing products
+    //----------------------------------------------------------------------
+    void processNewInputs();
+
+    //----------------------------------------------------------------------
+    // Method: schedulePendingTasks
+    // Schedule the tasks the pool of tasks could not take yet; returns
+    // false if some of them are still pending
+    //----------------------------------------------------------------------
+    bool schedulePendingTasks();
     
 private:
     EvtMng  * evtMng;
@@ -125,8 +146,13 @@ private:
     std::vector<Component*> subComponents;
 
     TskStatTable tssSet;
+
+    // Tasks created but not taken yet by the pool of tasks (full)
+    std::list<TaskInfo> pendingTasks;
     
     bool requestQuit;
+
+    bool hmiWasActive;
 };
 
 #endif
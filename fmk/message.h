@@ -29,6 +29,7 @@ public:
             DUMPJSTR(dateReception);
             DUMPJINT(rc);
             DUMPJSTRVEC(path);
+            DUMPJSTR(traceId);
     }
     JSTR(id);
     JSTR(type);
@@ -40,6 +41,7 @@ public:
     JSTR(dateReception);
     JINT(rc);
     JSTRVEC(path);
+    JSTR(traceId);
 };
 
 //==========================================================================
@@ -118,6 +120,7 @@ public:
     Message() {}
     Message(std::string s) : MessageBase(s) { init(); }
     Message(json v) : MessageBase(v) { init(); }
+    Message(MessageBase && b) { value.swap(b.val()); init(); }
     virtual void init() {
         header = MsgHeader(value["header"]);
         body   = T(value["body"]);
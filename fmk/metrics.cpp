@@ -0,0 +1,319 @@
+/******************************************************************************
+ * File:    metrics.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.Metrics
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement Metrics registry classes
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "metrics.h"
+
+#include <map>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+static std::string fmtDouble(double x)
+{
+    if (std::isinf(x)) { return (x > 0) ? "+Inf" : "-Inf"; }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", x);
+    return std::string(buf);
+}
+
+static void sample(std::string & out, const std::string & name,
+                   const std::string & labels, const std::string & value)
+{
+    out += name;
+    if (! labels.empty()) { out += "{" + labels + "}"; }
+    out += " " + value + "\n";
+}
+
+//----------------------------------------------------------------------
+// Method: shard
+// Shard of the calling thread
+//----------------------------------------------------------------------
+int Metric::shard()
+{
+    static std::atomic<int> nextShard(0);
+    static thread_local int idx = nextShard.fetch_add(1) % NumShards;
+    return idx;
+}
+
+//----------------------------------------------------------------------
+// Method: value
+//----------------------------------------------------------------------
+uint64_t Counter::value() const
+{
+    uint64_t n = 0;
+    for (auto & c : cells) { n += c.v.load(std::memory_order_relaxed); }
+    return n;
+}
+
+//----------------------------------------------------------------------
+// Method: render
+//----------------------------------------------------------------------
+void Counter::render(std::string & out) const
+{
+    sample(out, name, labels, std::to_string(value()));
+}
+
+//----------------------------------------------------------------------
+// Method: render
+//----------------------------------------------------------------------
+void Gauge::render(std::string & out) const
+{
+    sample(out, name, labels, std::to_string(value()));
+}
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+Histogram::Histogram(const std::string & n, const std::string & h,
+                     const std::string & l, const std::vector<double> & b)
+    : Metric(HistogramType, n, h, l), bounds(b),
+      numBuckets(b.size() + 1), counts(new Cell[NumShards * (b.size() + 1)])
+{
+    std::sort(bounds.begin(), bounds.end());
+}
+
+//----------------------------------------------------------------------
+// Method: observe
+//----------------------------------------------------------------------
+void Histogram::observe(double x)
+{
+    size_t i = std::lower_bound(bounds.begin(), bounds.end(), x) - bounds.begin();
+    int s = shard();
+    counts[s * numBuckets + i].v.fetch_add(1, std::memory_order_relaxed);
+    if (x > 0) {
+        sums[s].v.fetch_add(uint64_t(std::llround(x * 1.e6)),
+                            std::memory_order_relaxed);
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: count
+//----------------------------------------------------------------------
+uint64_t Histogram::count() const
+{
+    uint64_t n = 0;
+    for (size_t k = 0; k < NumShards * numBuckets; ++k) {
+        n += counts[k].v.load(std::memory_order_relaxed);
+    }
+    return n;
+}
+
+//----------------------------------------------------------------------
+// Method: sum
+//----------------------------------------------------------------------
+double Histogram::sum() const
+{
+    uint64_t n = 0;
+    for (auto & c : sums) { n += c.v.load(std::memory_order_relaxed); }
+    return n * 1.e-6;
+}
+
+//----------------------------------------------------------------------
+// Method: render
+//----------------------------------------------------------------------
+void Histogram::render(std::string & out) const
+{
+    std::string sep(labels.empty() ? "" : ",");
+    uint64_t acc = 0;
+    for (size_t i = 0; i < numBuckets; ++i) {
+        for (int s = 0; s < NumShards; ++s) {
+            acc += counts[s * numBuckets + i].v.load(std::memory_order_relaxed);
+        }
+        std::string le((i < bounds.size()) ? fmtDouble(bounds[i]) : "+Inf");
+        sample(out, name + "_bucket", labels + sep + "le=\"" + le + "\"",
+               std::to_string(acc));
+    }
+    sample(out, name + "_sum", labels, fmtDouble(sum()));
+    sample(out, name + "_count", labels, std::to_string(acc));
+}
+
+//----------------------------------------------------------------------
+// Method: expBounds
+// Bucket bounds start, start*factor, start*factor^2...
+//----------------------------------------------------------------------
+std::vector<double> Histogram::expBounds(double start, double factor, int n)
+{
+    std::vector<double> v;
+    for (int i = 0; i < n; ++i, start *= factor) { v.push_back(start); }
+    return v;
+}
+
+//----------------------------------------------------------------------
+// Method: instance
+// Return the registry of the process
+//----------------------------------------------------------------------
+Metrics & Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+//----------------------------------------------------------------------
+// Method: find
+//----------------------------------------------------------------------
+Metric * Metrics::find(Metric * from, const std::string & name,
+                       const std::string & labels)
+{
+    for (Metric * m = from; m != 0; m = m->next) {
+        if ((m->name == name) && (m->labels == labels)) { return m; }
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// Method: insert
+// Add the metric at the head of the list, unless another thread added
+// the same one meanwhile (then that one is returned)
+//----------------------------------------------------------------------
+Metric * Metrics::insert(Metric * m)
+{
+    Metric * h = head.load(std::memory_order_acquire);
+    for (;;) {
+        Metric * x = find(h, m->name, m->labels);
+        if (x != 0) {
+            delete m;
+            return x;
+        }
+        m->next = h;
+        if (head.compare_exchange_weak(h, m, std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+            return m;
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: counter
+//----------------------------------------------------------------------
+Counter & Metrics::counter(const std::string & name, const std::string & help,
+                           const std::string & labels)
+{
+    Metric * m = find(head.load(std::memory_order_acquire), name, labels);
+    if (m == 0) { m = insert(new Counter(name, help, labels)); }
+    return *static_cast<Counter*>(m);
+}
+
+//----------------------------------------------------------------------
+// Method: gauge
+//----------------------------------------------------------------------
+Gauge & Metrics::gauge(const std::string & name, const std::string & help,
+                       const std::string & labels)
+{
+    Metric * m = find(head.load(std::memory_order_acquire), name, labels);
+    if (m == 0) { m = insert(new Gauge(name, help, labels)); }
+    return *static_cast<Gauge*>(m);
+}
+
+//----------------------------------------------------------------------
+// Method: histogram
+//----------------------------------------------------------------------
+Histogram & Metrics::histogram(const std::string & name, const std::string & help,
+                               const std::vector<double> & bounds,
+                               const std::string & labels)
+{
+    Metric * m = find(head.load(std::memory_order_acquire), name, labels);
+    if (m == 0) { m = insert(new Histogram(name, help, labels, bounds)); }
+    return *static_cast<Histogram*>(m);
+}
+
+//----------------------------------------------------------------------
+// Method: exposition
+// Snapshot of all the metrics, in Prometheus text format
+//----------------------------------------------------------------------
+std::string Metrics::exposition()
+{
+    static const char * typeName[] = { "counter", "gauge", "histogram" };
+
+    // Metrics of the same family go together, in order of creation
+    std::vector<Metric*> all;
+    for (Metric * m = head.load(std::memory_order_acquire); m != 0; m = m->next) {
+        all.push_back(m);
+    }
+    std::reverse(all.begin(), all.end());
+
+    std::vector<std::string> names;
+    std::map<std::string, std::vector<Metric*>> families;
+    for (auto m : all) {
+        std::vector<Metric*> & f = families[m->name];
+        if (f.empty()) { names.push_back(m->name); }
+        f.push_back(m);
+    }
+
+    std::string out;
+    for (auto & n : names) {
+        Metric * first = families[n].front();
+        out += "# HELP " + n + " " + first->help + "\n";
+        out += "# TYPE " + n + " " + typeName[first->type] + "\n";
+        for (auto m : families[n]) { m->render(out); }
+    }
+    return out;
+}
+
+//----------------------------------------------------------------------
+// Method: labels
+// Build a label set
+//----------------------------------------------------------------------
+std::string Metrics::labels(std::initializer_list<std::pair<std::string,
+                                                            std::string>> kv)
+{
+    std::string s;
+    for (auto & p : kv) {
+        if (! s.empty()) { s += ","; }
+        s += p.first + "=\"";
+        for (char c : p.second) {
+            if      (c == '"')  { s += "\\\""; }
+            else if (c == '\\') { s += "\\\\"; }
+            else if (c == '\n') { s += "\\n"; }
+            else                { s += c; }
+        }
+        s += "\"";
+    }
+    return s;
+}
+
+//}
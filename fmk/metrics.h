@@ -0,0 +1,270 @@
+/******************************************************************************
+ * File:    metrics.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.Metrics
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare Metrics registry classes
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - vector
+//   - atomic
+//   - memory
+//   - cstdint
+//   - initializer_list
+//------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <initializer_list>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - spscq.h
+//------------------------------------------------------------
+#include "spscq.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: Metric
+// Base of the metrics kept in the registry.  Updates are spread over a
+// number of shards (each thread uses always the same one), so that
+// threads updating the same metric do not contend for a cache line
+// (metrics and cells are allocated aligned to it)
+//==========================================================================
+class Metric : public CacheAligned {
+
+public:
+    enum Type { CounterType, GaugeType, HistogramType };
+
+    static const int NumShards = 8;
+
+    Metric(Type t, const std::string & n, const std::string & h,
+           const std::string & l)
+        : type(t), name(n), help(h), labels(l), next(0) {}
+    virtual ~Metric() {}
+
+    //----------------------------------------------------------------------
+    // Method: render
+    // Append the samples of the metric in Prometheus text format
+    //----------------------------------------------------------------------
+    virtual void render(std::string & out) const = 0;
+
+    //----------------------------------------------------------------------
+    // Method: shard
+    // Shard of the calling thread
+    //----------------------------------------------------------------------
+    static int shard();
+
+    const Type        type;
+    const std::string name;
+    const std::string help;
+    const std::string labels;
+    Metric *          next;
+
+protected:
+    struct alignas(CACHE_LINE_SIZE) Cell : public CacheAligned {
+        Cell() : v(0) {}
+        std::atomic<uint64_t> v;
+    };
+};
+
+//==========================================================================
+// Class: Counter
+// Monotonic counter
+//==========================================================================
+class Counter : public Metric {
+
+public:
+    Counter(const std::string & n, const std::string & h, const std::string & l)
+        : Metric(CounterType, n, h, l) {}
+
+    void inc(uint64_t n = 1) {
+        cells[shard()].v.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+
+    virtual void render(std::string & out) const;
+
+private:
+    Cell cells[NumShards];
+};
+
+//==========================================================================
+// Class: Gauge
+// Value that goes up and down (usually set by its single owner)
+//==========================================================================
+class Gauge : public Metric {
+
+public:
+    Gauge(const std::string & n, const std::string & h, const std::string & l)
+        : Metric(GaugeType, n, h, l), val(0) {}
+
+    void set(int64_t x) { val.store(x, std::memory_order_relaxed); }
+    void add(int64_t x) { val.fetch_add(x, std::memory_order_relaxed); }
+
+    int64_t value() const { return val.load(std::memory_order_relaxed); }
+
+    virtual void render(std::string & out) const;
+
+private:
+    std::atomic<int64_t> val;
+};
+
+//==========================================================================
+// Class: Histogram
+// Distribution of observed values in buckets with fixed upper bounds.
+// The sum is kept with a resolution of 1e-6
+//==========================================================================
+class Histogram : public Metric {
+
+public:
+    Histogram(const std::string & n, const std::string & h, const std::string & l,
+              const std::vector<double> & bounds);
+
+    void observe(double x);
+
+    uint64_t count() const;
+    double   sum() const;
+
+    virtual void render(std::string & out) const;
+
+    //----------------------------------------------------------------------
+    // Method: expBounds
+    // Bucket bounds start, start*factor, start*factor^2...
+    //----------------------------------------------------------------------
+    static std::vector<double> expBounds(double start, double factor, int n);
+
+private:
+    std::vector<double>       bounds;
+    size_t                    numBuckets; // bounds plus +Inf
+    std::unique_ptr<Cell[]>   counts;     // NumShards x numBuckets
+    Cell                      sums[NumShards];
+};
+
+//==========================================================================
+// Class: Metrics
+// Process-wide registry of metrics.  Metrics are created on first use
+// and live as long as the process, in a list that grows with atomic
+// insertions only, so that neither the components updating them nor
+// the scrapes reading them take any lock
+//==========================================================================
+class Metrics {
+
+public:
+    //----------------------------------------------------------------------
+    // Method: instance
+    // Return the registry of the process
+    //----------------------------------------------------------------------
+    static Metrics & instance();
+
+    //----------------------------------------------------------------------
+    // Method: counter
+    // Return the counter with that name and labels, creating it if needed
+    //----------------------------------------------------------------------
+    Counter & counter(const std::string & name, const std::string & help,
+                      const std::string & labels = std::string());
+
+    //----------------------------------------------------------------------
+    // Method: gauge
+    // Return the gauge with that name and labels, creating it if needed
+    //----------------------------------------------------------------------
+    Gauge & gauge(const std::string & name, const std::string & help,
+                  const std::string & labels = std::string());
+
+    //----------------------------------------------------------------------
+    // Method: histogram
+    // Return the histogram with that name and labels, creating it if
+    // needed (with the given bucket bounds)
+    //----------------------------------------------------------------------
+    Histogram & histogram(const std::string & name, const std::string & help,
+                          const std::vector<double> & bounds,
+                          const std::string & labels = std::string());
+
+    //----------------------------------------------------------------------
+    // Method: exposition
+    // Snapshot of all the metrics, in Prometheus text format
+    //----------------------------------------------------------------------
+    std::string exposition();
+
+    //----------------------------------------------------------------------
+    // Method: labels
+    // Build a label set, as in: labels({{"chnl", "CMD"}, {"comp", "EvtMng"}})
+    //----------------------------------------------------------------------
+    static std::string labels(std::initializer_list<std::pair<std::string,
+                                                                std::string>> kv);
+
+private:
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    Metrics() : head(0) {}
+
+    Metric * find(Metric * from, const std::string & name,
+                  const std::string & labels);
+
+    Metric * insert(Metric * m);
+
+private:
+    std::atomic<Metric*> head;
+};
+
+//}
+
+#endif // METRICS_H
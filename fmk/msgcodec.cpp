@@ -0,0 +1,480 @@
+/******************************************************************************
+ * File:    msgcodec.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.MsgCodec
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement MsgCodec class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "msgcodec.h"
+#include "channels.h"
+
+#include <cstring>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+// Binary message prefix: a byte never used in MessagePack, a mark and
+// the format version
+static const uint8_t BinaryMagic          = 0xC1;
+static const uint8_t BinaryMark           = 'Q';
+static const uint8_t BinaryFormatVersion  = 1;
+static const size_t  BinaryPrefixSize     = 3;
+
+//----------------------------------------------------------------------
+// Method: isBinary
+// Check if the buffer holds a binary encoded message
+//----------------------------------------------------------------------
+bool MsgCodec::isBinary(const char * data, size_t len)
+{
+    return ((len >= BinaryPrefixSize) &&
+            (uint8_t(data[0]) == BinaryMagic) &&
+            (uint8_t(data[1]) == BinaryMark));
+}
+
+//----------------------------------------------------------------------
+// Method: supportsBinary
+// Check if a given interface version can handle binary messages
+//----------------------------------------------------------------------
+bool MsgCodec::supportsBinary(const std::string & ifVersion)
+{
+    static const std::string minVersion(CHNLS_IF_VERSION_BINARY);
+    char * next;
+    long major    = strtol(ifVersion.c_str(), &next, 10);
+    long minor    = (*next == '.') ? strtol(next + 1, 0, 10) : 0;
+    long minMajor = strtol(minVersion.c_str(), &next, 10);
+    long minMinor = (*next == '.') ? strtol(next + 1, 0, 10) : 0;
+    return ((major > minMajor) || ((major == minMajor) && (minor >= minMinor)));
+}
+
+//----------------------------------------------------------------------
+// Method: encode
+// Serialize the message value with the selected encoding
+//----------------------------------------------------------------------
+void MsgCodec::encode(json & v, Encoding enc, std::string & out)
+{
+    if (enc == JSON) {
+        Json::FastWriter w;
+        out = w.write(v);
+        return;
+    }
+
+    out.clear();
+    out.reserve(1024);
+    out.push_back(char(BinaryMagic));
+    out.push_back(char(BinaryMark));
+    out.push_back(char(BinaryFormatVersion));
+
+    if (! v.isObject()) {
+        packValue(v, out);
+        return;
+    }
+
+    // The header goes first, so that routing can be done without
+    // going through the body
+    std::vector<std::string> keys = v.getMemberNames();
+    size_t n = keys.size();
+    if      (n < 16)     { out.push_back(char(0x80 | n)); }
+    else if (n < 0x10000) { packUInt(0xde, n, 2, out); }
+    else                 { packUInt(0xdf, n, 4, out); }
+
+    if (v.isMember("header")) {
+        packString("header", out);
+        packValue(v["header"], out);
+    }
+    for (auto & k : keys) {
+        if (k == "header") { continue; }
+        packString(k, out);
+        packValue(v[k], out);
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: decode
+// Parse a message, either binary or JSON encoded
+//----------------------------------------------------------------------
+bool MsgCodec::decode(const char * data, size_t len, json & v)
+{
+    if (! isBinary(data, len)) {
+        Json::Reader reader;
+        return reader.parse(data, data + len, v);
+    }
+
+    const uint8_t * p   = (const uint8_t *)(data) + BinaryPrefixSize;
+    const uint8_t * end = (const uint8_t *)(data) + len;
+    return unpackValue(p, end, v);
+}
+
+//----------------------------------------------------------------------
+// Method: toJsonStr
+// Return the JSON representation of a message, whatever its encoding
+//----------------------------------------------------------------------
+std::string MsgCodec::toJsonStr(const char * data, size_t len)
+{
+    if (! isBinary(data, len)) { return std::string(data, len); }
+
+    json v;
+    decode(data, len, v);
+    Json::FastWriter w;
+    return w.write(v);
+}
+
+//----------------------------------------------------------------------
+// Method: scanRouting
+// Extract the routing fields of the header of a binary message
+//----------------------------------------------------------------------
+bool MsgCodec::scanRouting(const char * data, size_t len, MsgRouting & r)
+{
+    const uint8_t * p   = (const uint8_t *)(data) + BinaryPrefixSize;
+    const uint8_t * end = (const uint8_t *)(data) + len;
+
+    size_t n;
+    std::string key;
+    if ((p == end) || (! unpackSize(p, end, 0x80, n))) { return false; }
+    for (size_t i = 0; i < n; ++i) {
+        if (! unpackString(p, end, &key)) { return false; }
+        if (key != "header") {
+            if (! skipValue(p, end)) { return false; }
+            continue;
+        }
+        size_t nh;
+        if ((p == end) || (! unpackSize(p, end, 0x80, nh))) { return false; }
+        for (size_t j = 0; j < nh; ++j) {
+            if (! unpackString(p, end, &key)) { return false; }
+            std::string * field = 0;
+            if      (key == "id")      { field = &r.id; }
+            else if (key == "type")    { field = &r.type; }
+            else if (key == "version") { field = &r.version; }
+            else if (key == "source")  { field = &r.source; }
+            else if (key == "target")  { field = &r.target; }
+            else if (key == "dateTransmission") { field = &r.dateTransmission; }
+            else if (key == "traceId") { field = &r.traceId; }
+            bool isStr = ((p != end) &&
+                          (((*p & 0xe0) == 0xa0) || (*p == 0xd9) ||
+                           (*p == 0xda) || (*p == 0xdb)));
+            bool ok = (((field != 0) && isStr) ?
+                       unpackString(p, end, field) : skipValue(p, end));
+            if (! ok) { return false; }
+        }
+        return true;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------
+// Method: packValue
+//----------------------------------------------------------------------
+void MsgCodec::packValue(const json & v, std::string & out)
+{
+    switch (v.type()) {
+    case Json::nullValue:
+        out.push_back(char(0xc0));
+        break;
+    case Json::booleanValue:
+        out.push_back(char(v.asBool() ? 0xc3 : 0xc2));
+        break;
+    case Json::intValue: {
+        Json::Int64 n = v.asInt64();
+        if (n >= 0) {
+            if      (n < 0x80)        { out.push_back(char(n)); }
+            else if (n <= 0xff)       { packUInt(0xcc, n, 1, out); }
+            else if (n <= 0xffff)     { packUInt(0xcd, n, 2, out); }
+            else if (n <= 0xffffffff) { packUInt(0xce, n, 4, out); }
+            else                      { packUInt(0xcf, n, 8, out); }
+        } else {
+            if      (n >= -32)         { out.push_back(char(n)); }
+            else if (n >= -128)        { packUInt(0xd0, uint64_t(n), 1, out); }
+            else if (n >= -32768)      { packUInt(0xd1, uint64_t(n), 2, out); }
+            else if (n >= -2147483648LL) { packUInt(0xd2, uint64_t(n), 4, out); }
+            else                       { packUInt(0xd3, uint64_t(n), 8, out); }
+        }
+        break;
+    }
+    case Json::uintValue: {
+        Json::UInt64 n = v.asUInt64();
+        if      (n < 0x80)        { out.push_back(char(n)); }
+        else if (n <= 0xff)       { packUInt(0xcc, n, 1, out); }
+        else if (n <= 0xffff)     { packUInt(0xcd, n, 2, out); }
+        else if (n <= 0xffffffff) { packUInt(0xce, n, 4, out); }
+        else                      { packUInt(0xcf, n, 8, out); }
+        break;
+    }
+    case Json::realValue: {
+        double d = v.asDouble();
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        packUInt(0xcb, bits, 8, out);
+        break;
+    }
+    case Json::stringValue:
+        packString(v.asString(), out);
+        break;
+    case Json::arrayValue: {
+        size_t n = v.size();
+        if      (n < 16)      { out.push_back(char(0x90 | n)); }
+        else if (n < 0x10000) { packUInt(0xdc, n, 2, out); }
+        else                  { packUInt(0xdd, n, 4, out); }
+        for (Json::ArrayIndex i = 0; i < n; ++i) { packValue(v[i], out); }
+        break;
+    }
+    case Json::objectValue: {
+        size_t n = v.size();
+        if      (n < 16)      { out.push_back(char(0x80 | n)); }
+        else if (n < 0x10000) { packUInt(0xde, n, 2, out); }
+        else                  { packUInt(0xdf, n, 4, out); }
+        for (Json::Value::const_iterator it = v.begin(); it != v.end(); ++it) {
+            packString(it.name(), out);
+            packValue(*it, out);
+        }
+        break;
+    }
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: packString
+//----------------------------------------------------------------------
+void MsgCodec::packString(const std::string & s, std::string & out)
+{
+    size_t n = s.size();
+    if      (n < 32)          { out.push_back(char(0xa0 | n)); }
+    else if (n <= 0xff)       { packUInt(0xd9, n, 1, out); }
+    else if (n <= 0xffff)     { packUInt(0xda, n, 2, out); }
+    else                      { packUInt(0xdb, n, 4, out); }
+    out.append(s);
+}
+
+//----------------------------------------------------------------------
+// Method: packUInt
+// Append tag and the big endian representation of the value
+//----------------------------------------------------------------------
+void MsgCodec::packUInt(uint8_t tag, uint64_t n, int bytes, std::string & out)
+{
+    out.push_back(char(tag));
+    for (int i = bytes - 1; i >= 0; --i) {
+        out.push_back(char((n >> (8 * i)) & 0xff));
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: readUInt
+//----------------------------------------------------------------------
+uint64_t MsgCodec::readUInt(const uint8_t * & p, int bytes)
+{
+    uint64_t n = 0;
+    for (int i = 0; i < bytes; ++i) { n = (n << 8) | *p++; }
+    return n;
+}
+
+//----------------------------------------------------------------------
+// Method: unpackSize
+// Read the number of elements of a map (tag 0x80) or array (tag 0x90)
+//----------------------------------------------------------------------
+bool MsgCodec::unpackSize(const uint8_t * & p, const uint8_t * end,
+                          uint8_t tag, size_t & n)
+{
+    uint8_t c = *p;
+    uint8_t tag16 = (tag == 0x80) ? 0xde : 0xdc;
+    if ((c & 0xf0) == tag) {
+        ++p;
+        n = c & 0x0f;
+    } else if ((c == tag16) && (end - p > 2)) {
+        ++p;
+        n = readUInt(p, 2);
+    } else if ((c == tag16 + 1) && (end - p > 4)) {
+        ++p;
+        n = readUInt(p, 4);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: unpackString
+//----------------------------------------------------------------------
+bool MsgCodec::unpackString(const uint8_t * & p, const uint8_t * end,
+                            std::string * s)
+{
+    if (p == end) { return false; }
+    uint8_t c = *p++;
+    size_t n;
+    if      ((c & 0xe0) == 0xa0)               { n = c & 0x1f; }
+    else if (((c == 0xd9) || (c == 0xc4)) && (end - p >= 1)) { n = readUInt(p, 1); }
+    else if (((c == 0xda) || (c == 0xc5)) && (end - p >= 2)) { n = readUInt(p, 2); }
+    else if (((c == 0xdb) || (c == 0xc6)) && (end - p >= 4)) { n = readUInt(p, 4); }
+    else { return false; }
+    if (size_t(end - p) < n) { return false; }
+    if (s != 0) { s->assign((const char *)(p), n); }
+    p += n;
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: unpackValue
+//----------------------------------------------------------------------
+bool MsgCodec::unpackValue(const uint8_t * & p, const uint8_t * end, json & v)
+{
+    if (p == end) { return false; }
+    uint8_t c = *p;
+
+    if (c < 0x80) { ++p; v = json(Json::Int64(c)); return true; }
+    if (c >= 0xe0) { ++p; v = json(Json::Int64(int8_t(c))); return true; }
+
+    if (((c & 0xe0) == 0xa0) || (c == 0xd9) || (c == 0xda) || (c == 0xdb) ||
+        (c == 0xc4) || (c == 0xc5) || (c == 0xc6)) {
+        std::string s;
+        if (! unpackString(p, end, &s)) { return false; }
+        v = json(s);
+        return true;
+    }
+
+    size_t n;
+    if (((c & 0xf0) == 0x90) || (c == 0xdc) || (c == 0xdd)) {
+        if (! unpackSize(p, end, 0x90, n)) { return false; }
+        v = json(Json::arrayValue);
+        v.resize(Json::ArrayIndex(n));
+        for (size_t i = 0; i < n; ++i) {
+            if (! unpackValue(p, end, v[Json::ArrayIndex(i)])) { return false; }
+        }
+        return true;
+    }
+
+    if (((c & 0xf0) == 0x80) || (c == 0xde) || (c == 0xdf)) {
+        if (! unpackSize(p, end, 0x80, n)) { return false; }
+        v = json(Json::objectValue);
+        std::string key;
+        for (size_t i = 0; i < n; ++i) {
+            if (! unpackString(p, end, &key)) { return false; }
+            if (! unpackValue(p, end, v[key])) { return false; }
+        }
+        return true;
+    }
+
+    ++p;
+    int bytes = 0;
+    switch (c) {
+    case 0xc0: v = json(); return true;
+    case 0xc2: v = json(false); return true;
+    case 0xc3: v = json(true); return true;
+    case 0xcc: case 0xd0: bytes = 1; break;
+    case 0xcd: case 0xd1: bytes = 2; break;
+    case 0xce: case 0xd2: case 0xca: bytes = 4; break;
+    case 0xcf: case 0xd3: case 0xcb: bytes = 8; break;
+    default: return false;
+    }
+    if (end - p < bytes) { return false; }
+    uint64_t n64 = readUInt(p, bytes);
+
+    switch (c) {
+    case 0xcc: case 0xcd: case 0xce: case 0xcf:
+        if (n64 <= uint64_t(INT64_MAX)) { v = json(Json::Int64(n64)); }
+        else                           { v = json(Json::UInt64(n64)); }
+        break;
+    case 0xd0: v = json(Json::Int64(int8_t(n64)));  break;
+    case 0xd1: v = json(Json::Int64(int16_t(n64))); break;
+    case 0xd2: v = json(Json::Int64(int32_t(n64))); break;
+    case 0xd3: v = json(Json::Int64(int64_t(n64))); break;
+    case 0xca: {
+        uint32_t bits = uint32_t(n64);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        v = json(double(f));
+        break;
+    }
+    case 0xcb: {
+        double d;
+        memcpy(&d, &n64, sizeof(d));
+        v = json(d);
+        break;
+    }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: skipValue
+//----------------------------------------------------------------------
+bool MsgCodec::skipValue(const uint8_t * & p, const uint8_t * end)
+{
+    if (p == end) { return false; }
+    uint8_t c = *p;
+
+    if ((c < 0x80) || (c >= 0xe0)) { ++p; return true; }
+
+    if (((c & 0xe0) == 0xa0) || (c == 0xd9) || (c == 0xda) || (c == 0xdb) ||
+        (c == 0xc4) || (c == 0xc5) || (c == 0xc6)) {
+        return unpackString(p, end, 0);
+    }
+
+    size_t n;
+    if (((c & 0xf0) == 0x90) || (c == 0xdc) || (c == 0xdd)) {
+        if (! unpackSize(p, end, 0x90, n)) { return false; }
+        for (size_t i = 0; i < n; ++i) {
+            if (! skipValue(p, end)) { return false; }
+        }
+        return true;
+    }
+
+    if (((c & 0xf0) == 0x80) || (c == 0xde) || (c == 0xdf)) {
+        if (! unpackSize(p, end, 0x80, n)) { return false; }
+        for (size_t i = 0; i < 2 * n; ++i) {
+            if (! skipValue(p, end)) { return false; }
+        }
+        return true;
+    }
+
+    ++p;
+    int bytes = 0;
+    switch (c) {
+    case 0xc0: case 0xc2: case 0xc3: return true;
+    case 0xcc: case 0xd0: bytes = 1; break;
+    case 0xcd: case 0xd1: bytes = 2; break;
+    case 0xce: case 0xd2: case 0xca: bytes = 4; break;
+    case 0xcf: case 0xd3: case 0xcb: bytes = 8; break;
+    default: return false;
+    }
+    if (end - p < bytes) { return false; }
+    p += bytes;
+    return true;
+}
+
+//}
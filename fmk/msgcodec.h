@@ -0,0 +1,141 @@
+/******************************************************************************
+ * File:    msgcodec.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.MsgCodec
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare MsgCodec class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef MSGCODEC_H
+#define MSGCODEC_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//------------------------------------------------------------
+#include <string>
+#include <cstdint>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - datatypes.h
+//   - msgscan.h
+//------------------------------------------------------------
+#include "datatypes.h"
+#include "msgscan.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: MsgCodec
+// Compact binary encoding of messages.  A binary message is a 3 bytes
+// prefix (0xC1 'Q' <format>) followed by the message object encoded in
+// MessagePack, with the header always placed before the body, so that
+// the routing information can be extracted without decoding the body.
+// Text messages (JSON) are still accepted everywhere.
+//==========================================================================
+class MsgCodec {
+
+public:
+    enum Encoding { JSON, BINARY };
+
+    //----------------------------------------------------------------------
+    // Method: isBinary
+    // Check if the buffer holds a binary encoded message
+    //----------------------------------------------------------------------
+    static bool isBinary(const char * data, size_t len);
+
+    //----------------------------------------------------------------------
+    // Method: supportsBinary
+    // Check if a given interface version can handle binary messages
+    //----------------------------------------------------------------------
+    static bool supportsBinary(const std::string & ifVersion);
+
+    //----------------------------------------------------------------------
+    // Method: encode
+    // Serialize the message value with the selected encoding
+    //----------------------------------------------------------------------
+    static void encode(json & v, Encoding enc, std::string & out);
+
+    //----------------------------------------------------------------------
+    // Method: decode
+    // Parse a message, either binary or JSON encoded
+    //----------------------------------------------------------------------
+    static bool decode(const char * data, size_t len, json & v);
+
+    //----------------------------------------------------------------------
+    // Method: toJsonStr
+    // Return the JSON representation of a message, whatever its encoding
+    //----------------------------------------------------------------------
+    static std::string toJsonStr(const char * data, size_t len);
+
+    //----------------------------------------------------------------------
+    // Method: scanRouting
+    // Extract the routing fields of the header of a binary message
+    //----------------------------------------------------------------------
+    static bool scanRouting(const char * data, size_t len, MsgRouting & r);
+
+private:
+    static void packValue(const json & v, std::string & out);
+    static void packString(const std::string & s, std::string & out);
+    static void packUInt(uint8_t tag, uint64_t n, int bytes, std::string & out);
+
+    static bool unpackValue(const uint8_t * & p, const uint8_t * end, json & v);
+    static bool unpackString(const uint8_t * & p, const uint8_t * end,
+                             std::string * s);
+    static bool unpackSize(const uint8_t * & p, const uint8_t * end,
+                           uint8_t tag, size_t & n);
+    static bool skipValue(const uint8_t * & p, const uint8_t * end);
+    static uint64_t readUInt(const uint8_t * & p, int bytes);
+};
+
+//}
+
+#endif  /* MSGCODEC_H */
@@ -0,0 +1,453 @@
+/******************************************************************************
+ * File:    msgjournal.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.MsgJournal
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement MsgJournal and MsgJournalReader classes
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   nncomm, ChannelRegistry
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "msgjournal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+// Default segment size, and max. number of messages waiting to be written
+const size_t  JOURNAL_SEGMENT_SIZE   = 64 * 1024 * 1024;
+const size_t  JOURNAL_QUEUE_SIZE     = 8192;
+
+// Wait of the writer when there is nothing to write
+const int     JOURNAL_IDLE_WAIT_MS   = 50;
+
+// Min. time between index entries
+const int64_t JOURNAL_INDEX_STEP_NS  = 1000000000LL;
+
+static const char JournalMagic[4] = { 'Q', 'J', 'R', 'N' };
+
+const uint32_t MsgJournal::FormatVersion;
+const size_t   MsgJournal::SegmentHdrSize;
+
+//----------------------------------------------------------------------
+// Function: nowNs
+//----------------------------------------------------------------------
+static int64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+MsgJournal::MsgJournal(std::string d, std::string n,
+                       size_t sz, int period)
+    : dir(d), name(n),
+      segSize((sz > 0) ? sz : JOURNAL_SEGMENT_SIZE),
+      rotationPeriod(period),
+      queue(JOURNAL_QUEUE_SIZE), dropped(0), quit(false),
+      segNum(0), segFd(-1), segBase(0), segLen(0), segPos(0),
+      segOpenTimeNs(0), lastIdxTimeNs(0)
+{
+    // Continue the numbering of existing segments, if any
+    std::vector<uint32_t> segs = listSegments(dir, name);
+    if (! segs.empty()) { segNum = segs.back() + 1; }
+
+    idxFd = open(indexFileName(dir, name).c_str(),
+                 O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (idxFd < 0) { perror(("open " + indexFileName(dir, name)).c_str()); }
+
+    thrId = std::thread(&MsgJournal::run, this);
+}
+
+//----------------------------------------------------------------------
+// Destructor
+// Writes pending records and closes the current segment
+//----------------------------------------------------------------------
+MsgJournal::~MsgJournal()
+{
+    quit = true;
+    cv.notify_one();
+    if (thrId.joinable()) { thrId.join(); }
+    if (idxFd >= 0) { close(idxFd); }
+}
+
+//----------------------------------------------------------------------
+// Method: append
+// Queue a message to be written
+//----------------------------------------------------------------------
+bool MsgJournal::append(Direction dir, ChannelId chnl, MessageBuffer && buf)
+{
+    Record r;
+    r.timeNs = nowNs();
+    r.dir    = static_cast<char>(dir);
+    r.chnl   = chnl;
+    r.buf    = std::move(buf);
+    if (! queue.push(std::move(r))) {
+        dropped++;
+        return false;
+    }
+    cv.notify_one();
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: run
+// Writer loop
+//----------------------------------------------------------------------
+void MsgJournal::run()
+{
+    Record r;
+    for (;;) {
+        if (queue.pop(r)) {
+            write(r);
+            r.buf.reset();
+            continue;
+        }
+        if (quit) { break; }
+
+        // Segments are also rotated when the component is idle
+        if ((segBase != 0) && (rotationPeriod > 0) &&
+            ((nowNs() - segOpenTimeNs) >= rotationPeriod * 1000000000LL)) {
+            closeSegment();
+        }
+
+        std::unique_lock<std::mutex> lck(mtx);
+        cv.wait_for(lck, std::chrono::milliseconds(JOURNAL_IDLE_WAIT_MS));
+    }
+    closeSegment();
+}
+
+//----------------------------------------------------------------------
+// Method: write
+//----------------------------------------------------------------------
+void MsgJournal::write(Record & r)
+{
+    const std::string & chnl = channelName(r.chnl);
+    size_t len = r.buf.size();
+    size_t recSize = recordSize(chnl.size(), len);
+
+    if (segBase != 0) {
+        bool isFull = (segPos + recSize + sizeof(RecordHdr) > segLen);
+        bool isOld  = ((rotationPeriod > 0) &&
+                       ((r.timeNs - segOpenTimeNs) >= rotationPeriod * 1000000000LL));
+        if (isFull || isOld) { closeSegment(); }
+    }
+    if ((segBase == 0) && (! openSegment(recSize + sizeof(RecordHdr)))) { return; }
+
+    // Index entry at the start of the segment, and then every second
+    if ((segPos == SegmentHdrSize) ||
+        ((r.timeNs - lastIdxTimeNs) >= JOURNAL_INDEX_STEP_NS)) {
+        IndexEntry e = { r.timeNs, segNum, 0, segPos };
+        if ((idxFd >= 0) && (::write(idxFd, &e, sizeof(e)) == sizeof(e))) {
+            lastIdxTimeNs = r.timeNs;
+        }
+    }
+
+    RecordHdr hdr = { static_cast<uint32_t>(len),
+                      static_cast<uint16_t>(chnl.size()),
+                      static_cast<uint8_t>(r.dir), 0, r.timeNs };
+    char * p = segBase + segPos;
+    memcpy(p, &hdr, sizeof(hdr));
+    memcpy(p + sizeof(hdr), chnl.data(), chnl.size());
+    memcpy(p + sizeof(hdr) + chnl.size(), r.buf.data(), len);
+    segPos += recSize;
+}
+
+//----------------------------------------------------------------------
+// Method: openSegment
+// Create and map a new segment, with room at least for minSize bytes
+//----------------------------------------------------------------------
+bool MsgJournal::openSegment(size_t minSize)
+{
+    std::string fileName = segmentFileName(dir, name, segNum);
+    segLen = std::max(segSize, SegmentHdrSize + minSize);
+
+    segFd = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (segFd < 0) {
+        perror(("open " + fileName).c_str());
+        return false;
+    }
+    // Reserve the blocks now, so that writing to the map does not fail
+    // (or wait for the file system) later
+    if ((posix_fallocate(segFd, 0, segLen) != 0) &&
+        (ftruncate(segFd, segLen) != 0)) {
+        perror(("allocate " + fileName).c_str());
+        close(segFd);
+        segFd = -1;
+        return false;
+    }
+    void * addr = mmap(0, segLen, PROT_READ | PROT_WRITE, MAP_SHARED, segFd, 0);
+    if (addr == MAP_FAILED) {
+        perror(("mmap " + fileName).c_str());
+        close(segFd);
+        segFd = -1;
+        return false;
+    }
+    segBase = static_cast<char *>(addr);
+
+    uint32_t version = FormatVersion;
+    memcpy(segBase, JournalMagic, sizeof(JournalMagic));
+    memcpy(segBase + sizeof(JournalMagic), &version, sizeof(version));
+    segPos = SegmentHdrSize;
+    segOpenTimeNs = nowNs();
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: closeSegment
+// Unmap the current segment, and truncate it to the written size
+//----------------------------------------------------------------------
+void MsgJournal::closeSegment()
+{
+    if (segBase == 0) { return; }
+    munmap(segBase, segLen);
+    if (ftruncate(segFd, segPos) != 0) {
+        perror(("truncate " + segmentFileName(dir, name, segNum)).c_str());
+    }
+    close(segFd);
+    segBase = 0;
+    segFd   = -1;
+    ++segNum;
+}
+
+//----------------------------------------------------------------------
+// Method: channelName
+//----------------------------------------------------------------------
+const std::string & MsgJournal::channelName(ChannelId chnl)
+{
+    if (chnl < 0) { chnl = TX_ID_UNKNOWN; }
+    while (static_cast<ChannelId>(chnlNames.size()) <= chnl) {
+        chnlNames.push_back(ChannelRegistry::name(chnlNames.size()));
+    }
+    return chnlNames[chnl];
+}
+
+//----------------------------------------------------------------------
+// Method: segmentFileName
+//----------------------------------------------------------------------
+std::string MsgJournal::segmentFileName(std::string dir, std::string name,
+                                        uint32_t seg)
+{
+    char buf[16];
+    sprintf(buf, ".%06u.jrnl", seg);
+    return dir + "/" + name + buf;
+}
+
+//----------------------------------------------------------------------
+// Method: indexFileName
+//----------------------------------------------------------------------
+std::string MsgJournal::indexFileName(std::string dir, std::string name)
+{
+    return dir + "/" + name + ".jidx";
+}
+
+//----------------------------------------------------------------------
+// Method: listSegments
+// Return the sorted list of segment numbers found in dir
+//----------------------------------------------------------------------
+std::vector<uint32_t> MsgJournal::listSegments(std::string dir, std::string name)
+{
+    std::vector<uint32_t> segs;
+    DIR * d = opendir(dir.c_str());
+    if (d == 0) { return segs; }
+
+    std::string prefix(name + ".");
+    std::string suffix(".jrnl");
+    struct dirent * e;
+    while ((e = readdir(d)) != 0) {
+        std::string f(e->d_name);
+        if ((f.size() == prefix.size() + 6 + suffix.size()) &&
+            (f.compare(0, prefix.size(), prefix) == 0) &&
+            (f.compare(f.size() - suffix.size(), suffix.size(), suffix) == 0)) {
+            segs.push_back(static_cast<uint32_t>(atol(f.c_str() + prefix.size())));
+        }
+    }
+    closedir(d);
+
+    std::sort(segs.begin(), segs.end());
+    return segs;
+}
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+MsgJournalReader::MsgJournalReader(std::string d, std::string n)
+    : dir(d), name(n), segIdx(0), segBase(0), segLen(0), segPos(0),
+      fromTimeNs(0)
+{
+    segments = MsgJournal::listSegments(dir, name);
+}
+
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+MsgJournalReader::~MsgJournalReader()
+{
+    closeSegment();
+}
+
+//----------------------------------------------------------------------
+// Method: seek
+// Position the reader at the first record with time >= timeNs
+//----------------------------------------------------------------------
+void MsgJournalReader::seek(int64_t timeNs)
+{
+    closeSegment();
+    segIdx     = 0;
+    segPos     = 0;
+    fromTimeNs = timeNs;
+
+    // Look for the last index entry before the requested time
+    FILE * fIdx = fopen(MsgJournal::indexFileName(dir, name).c_str(), "rb");
+    if (fIdx == 0) { return; }
+
+    MsgJournal::IndexEntry e;
+    uint32_t seg = 0;
+    uint64_t offset = 0;
+    bool found = false;
+    while (fread(&e, sizeof(e), 1, fIdx) == 1) {
+        if (e.timeNs > timeNs) { break; }
+        seg    = e.segment;
+        offset = e.offset;
+        found  = true;
+    }
+    fclose(fIdx);
+
+    if (found) {
+        std::vector<uint32_t>::iterator it =
+            std::lower_bound(segments.begin(), segments.end(), seg);
+        if ((it != segments.end()) && (*it == seg)) {
+            segIdx = it - segments.begin();
+            segPos = offset;
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: next
+// Read next record, returns false at the end of the journal
+//----------------------------------------------------------------------
+bool MsgJournalReader::next(Record & r)
+{
+    MsgJournal::RecordHdr hdr;
+    for (;;) {
+        if (segBase == 0) {
+            if (segIdx >= segments.size()) { return false; }
+            if (! openSegment()) { ++segIdx; segPos = 0; continue; }
+        }
+
+        bool atEnd = (segPos + sizeof(hdr) > segLen);
+        if (! atEnd) {
+            memcpy(&hdr, segBase + segPos, sizeof(hdr));
+            atEnd = ((hdr.chnlLen == 0) ||
+                     (segPos + MsgJournal::recordSize(hdr.chnlLen, hdr.length) > segLen));
+        }
+        if (atEnd) {
+            closeSegment();
+            ++segIdx;
+            segPos = 0;
+            continue;
+        }
+
+        const char * p = segBase + segPos + sizeof(hdr);
+        segPos += MsgJournal::recordSize(hdr.chnlLen, hdr.length);
+        if (hdr.timeNs < fromTimeNs) { continue; }
+
+        r.timeNs = hdr.timeNs;
+        r.dir    = static_cast<char>(hdr.dir);
+        r.chnl.assign(p, hdr.chnlLen);
+        r.data   = p + hdr.chnlLen;
+        r.length = hdr.length;
+        return true;
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: openSegment
+//----------------------------------------------------------------------
+bool MsgJournalReader::openSegment()
+{
+    std::string fileName = MsgJournal::segmentFileName(dir, name, segments[segIdx]);
+    int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { return false; }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) ||
+        (st.st_size < (off_t)(MsgJournal::SegmentHdrSize))) {
+        close(fd);
+        return false;
+    }
+    void * addr = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) { return false; }
+
+    segBase = static_cast<const char *>(addr);
+    segLen  = st.st_size;
+    if (memcmp(segBase, JournalMagic, sizeof(JournalMagic)) != 0) {
+        closeSegment();
+        return false;
+    }
+    if (segPos < MsgJournal::SegmentHdrSize) { segPos = MsgJournal::SegmentHdrSize; }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: closeSegment
+//----------------------------------------------------------------------
+void MsgJournalReader::closeSegment()
+{
+    if (segBase == 0) { return; }
+    munmap(const_cast<char *>(segBase), segLen);
+    segBase = 0;
+    segLen  = 0;
+}
+
+//}
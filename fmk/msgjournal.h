@@ -0,0 +1,308 @@
+/******************************************************************************
+ * File:    msgjournal.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.MsgJournal
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare MsgJournal and MsgJournalReader classes
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   nncomm, ChannelRegistry
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef MSGJOURNAL_H
+#define MSGJOURNAL_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - vector
+//   - thread
+//   - mutex
+//   - condition_variable
+//   - atomic
+//------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - msgbuf.h
+//   - spscq.h
+//   - bndqueue.h
+//   - chnlreg.h
+//------------------------------------------------------------
+#include "msgbuf.h"
+#include "spscq.h"
+#include "bndqueue.h"
+#include "chnlreg.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: MsgJournal
+// Append-only journal of the messages sent and received by a component.
+// The journal is a sequence of segment files <name>.<NNNNNN>.jrnl,
+// preallocated and written through a memory map by a background thread.
+// Each segment starts with a small header followed by records:
+//
+//   RecordHdr | channel name | message (as transmitted) | padding to 8
+//
+// A zeroed header marks the end of the written area.  An index file
+// <name>.jidx holds (time, segment, offset) entries, added at the start
+// of each segment and about once per second, to seek by time.
+//==========================================================================
+class MsgJournal : public CacheAligned {
+
+public:
+    enum Direction { Send = 'S', Recv = 'R' };
+
+    struct RecordHdr {
+        uint32_t length;     // Message length
+        uint16_t chnlLen;    // Channel name length (never 0)
+        uint8_t  dir;        // Direction
+        uint8_t  reserved;
+        int64_t  timeNs;     // Time stamp (ns since the epoch)
+    };
+
+    struct IndexEntry {
+        int64_t  timeNs;
+        uint32_t segment;
+        uint32_t reserved;
+        uint64_t offset;
+    };
+
+    static const uint32_t FormatVersion = 1;
+    static const size_t   SegmentHdrSize = 16;
+
+    //----------------------------------------------------------------------
+    // Constructor
+    // Segments of segSize bytes are rotated when full, or after
+    // rotationPeriod seconds (if greater than 0)
+    //----------------------------------------------------------------------
+    MsgJournal(std::string dir, std::string name,
+               size_t segSize = 0, int rotationPeriod = 0);
+
+    //----------------------------------------------------------------------
+    // Destructor
+    // Writes pending records and closes the current segment
+    //----------------------------------------------------------------------
+    ~MsgJournal();
+
+    //----------------------------------------------------------------------
+    // Method: append
+    // Queue a message to be written; returns false (and the message is
+    // discarded) if the queue is full
+    //----------------------------------------------------------------------
+    bool append(Direction dir, ChannelId chnl, MessageBuffer && buf);
+
+    //----------------------------------------------------------------------
+    // Method: getDropped
+    // Number of messages discarded since last call
+    //----------------------------------------------------------------------
+    unsigned int getDropped() { return dropped.exchange(0); }
+
+    //----------------------------------------------------------------------
+    // Method: segmentFileName
+    //----------------------------------------------------------------------
+    static std::string segmentFileName(std::string dir, std::string name,
+                                       uint32_t seg);
+
+    //----------------------------------------------------------------------
+    // Method: indexFileName
+    //----------------------------------------------------------------------
+    static std::string indexFileName(std::string dir, std::string name);
+
+    //----------------------------------------------------------------------
+    // Method: listSegments
+    // Return the sorted list of segment numbers found in dir
+    //----------------------------------------------------------------------
+    static std::vector<uint32_t> listSegments(std::string dir, std::string name);
+
+    //----------------------------------------------------------------------
+    // Method: recordSize
+    // Size taken in the segment by a record
+    //----------------------------------------------------------------------
+    static size_t recordSize(size_t chnlLen, size_t len) {
+        return (sizeof(RecordHdr) + chnlLen + len + 7) & ~((size_t)(7));
+    }
+
+private:
+    MsgJournal(const MsgJournal &) = delete;
+    MsgJournal & operator=(const MsgJournal &) = delete;
+
+    struct Record {
+        int64_t       timeNs;
+        char          dir;
+        ChannelId     chnl;
+        MessageBuffer buf;
+    };
+
+    //----------------------------------------------------------------------
+    // Method: run
+    // Writer loop
+    //----------------------------------------------------------------------
+    void run();
+
+    //----------------------------------------------------------------------
+    // Method: write
+    //----------------------------------------------------------------------
+    void write(Record & r);
+
+    //----------------------------------------------------------------------
+    // Method: openSegment
+    // Create and map a new segment, with room at least for minSize bytes
+    //----------------------------------------------------------------------
+    bool openSegment(size_t minSize);
+
+    //----------------------------------------------------------------------
+    // Method: closeSegment
+    // Unmap the current segment, and truncate it to the written size
+    //----------------------------------------------------------------------
+    void closeSegment();
+
+    //----------------------------------------------------------------------
+    // Method: channelName
+    //----------------------------------------------------------------------
+    const std::string & channelName(ChannelId chnl);
+
+private:
+    std::string              dir;
+    std::string              name;
+    size_t                   segSize;
+    int                      rotationPeriod;
+
+    BoundedQueue<Record>     queue;
+    std::atomic<unsigned int> dropped;
+    std::atomic<bool>        quit;
+    std::mutex               mtx;
+    std::condition_variable  cv;
+
+    uint32_t                 segNum;
+    int                      segFd;
+    char *                   segBase;
+    size_t                   segLen;
+    size_t                   segPos;
+    int64_t                  segOpenTimeNs;
+
+    int                      idxFd;
+    int64_t                  lastIdxTimeNs;
+
+    std::vector<std::string> chnlNames;
+
+    std::thread              thrId;
+};
+
+//==========================================================================
+// Class: MsgJournalReader
+// Sequential reader of the records of a journal, from a given time on
+//==========================================================================
+class MsgJournalReader {
+
+public:
+    struct Record {
+        int64_t      timeNs;
+        char         dir;
+        std::string  chnl;
+        const char * data;    // Valid until next call to next()
+        size_t       length;
+    };
+
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    MsgJournalReader(std::string dir, std::string name);
+
+    //----------------------------------------------------------------------
+    // Destructor
+    //----------------------------------------------------------------------
+    ~MsgJournalReader();
+
+    //----------------------------------------------------------------------
+    // Method: seek
+    // Position the reader at the first record with time >= timeNs
+    //----------------------------------------------------------------------
+    void seek(int64_t timeNs);
+
+    //----------------------------------------------------------------------
+    // Method: next
+    // Read next record, returns false at the end of the journal
+    //----------------------------------------------------------------------
+    bool next(Record & r);
+
+private:
+    MsgJournalReader(const MsgJournalReader &) = delete;
+    MsgJournalReader & operator=(const MsgJournalReader &) = delete;
+
+    //----------------------------------------------------------------------
+    // Method: openSegment
+    //----------------------------------------------------------------------
+    bool openSegment();
+
+    //----------------------------------------------------------------------
+    // Method: closeSegment
+    //----------------------------------------------------------------------
+    void closeSegment();
+
+private:
+    std::string           dir;
+    std::string           name;
+    std::vector<uint32_t> segments;
+    size_t                segIdx;
+    const char *          segBase;
+    size_t                segLen;
+    size_t                segPos;
+    int64_t               fromTimeNs;
+};
+
+//}
+
+#endif  /* MSGJOURNAL_H */
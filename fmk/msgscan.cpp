@@ -0,0 +1,236 @@
+/******************************************************************************
+ * File:    msgscan.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.MsgHeaderScanner
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement MsgHeaderScanner class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "msgscan.h"
+#include "msgcodec.h"
+
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//----------------------------------------------------------------------
+// Method: scan
+// Fill the routing fields from the message header, returns false if
+// the header could not be found
+//----------------------------------------------------------------------
+bool MsgHeaderScanner::scan(const char * data, size_t len, MsgRouting & r)
+{
+    const char * p   = data;
+    const char * end = data + len;
+
+    r.id.clear();
+    r.type.clear();
+    r.version.clear();
+    r.source.clear();
+    r.target.clear();
+    r.dateTransmission.clear();
+    r.traceId.clear();
+
+    if (MsgCodec::isBinary(data, len)) { return MsgCodec::scanRouting(data, len, r); }
+
+    skipWhiteSpace(p, end);
+    if ((p == end) || (*p != '{')) { return false; }
+    ++p;
+
+    // Walk the top level keys, skipping the values (body is usually
+    // serialized before the header) until the header is found
+    std::string key;
+    while (true) {
+        skipWhiteSpace(p, end);
+        if ((p == end) || (*p == '}')) { return false; }
+        if (! readString(p, end, &key)) { return false; }
+        skipWhiteSpace(p, end);
+        if ((p == end) || (*p != ':')) { return false; }
+        ++p;
+        skipWhiteSpace(p, end);
+        if (key == "header") { return scanHeader(p, end, r); }
+        if (! skipValue(p, end)) { return false; }
+        skipWhiteSpace(p, end);
+        if ((p != end) && (*p == ',')) { ++p; }
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: skipWhiteSpace
+//----------------------------------------------------------------------
+void MsgHeaderScanner::skipWhiteSpace(const char * & p, const char * end)
+{
+    while ((p != end) &&
+           ((*p == ' ') || (*p == '\n') || (*p == '\r') || (*p == '\t'))) {
+        ++p;
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: readString
+// Read a JSON string (p must point to the opening quote)
+//----------------------------------------------------------------------
+bool MsgHeaderScanner::readString(const char * & p, const char * end,
+                                  std::string * s)
+{
+    if ((p == end) || (*p != '"')) { return false; }
+    ++p;
+    if (s != 0) { s->clear(); }
+    while (p != end) {
+        char c = *p++;
+        if (c == '"') { return true; }
+        if (c != '\\') {
+            if (s != 0) { s->push_back(c); }
+            continue;
+        }
+        if (p == end) { return false; }
+        c = *p++;
+        if (c == 'u') {
+            if (end - p < 4) { return false; }
+            unsigned int cp = 0;
+            for (int i = 0; i < 4; ++i, ++p) {
+                char h = *p;
+                cp <<= 4;
+                if      ((h >= '0') && (h <= '9')) { cp |= (h - '0'); }
+                else if ((h >= 'a') && (h <= 'f')) { cp |= (h - 'a' + 10); }
+                else if ((h >= 'A') && (h <= 'F')) { cp |= (h - 'A' + 10); }
+                else { return false; }
+            }
+            if (s == 0) { continue; }
+            if (cp < 0x80) {
+                s->push_back(char(cp));
+            } else if (cp < 0x800) {
+                s->push_back(char(0xC0 | (cp >> 6)));
+                s->push_back(char(0x80 | (cp & 0x3F)));
+            } else {
+                s->push_back(char(0xE0 | (cp >> 12)));
+                s->push_back(char(0x80 | ((cp >> 6) & 0x3F)));
+                s->push_back(char(0x80 | (cp & 0x3F)));
+            }
+            continue;
+        }
+        if (s == 0) { continue; }
+        switch (c) {
+        case 'b': s->push_back('\b'); break;
+        case 'f': s->push_back('\f'); break;
+        case 'n': s->push_back('\n'); break;
+        case 'r': s->push_back('\r'); break;
+        case 't': s->push_back('\t'); break;
+        default:  s->push_back(c);    break;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------
+// Method: skipValue
+// Skip any JSON value, including nested objects and arrays
+//----------------------------------------------------------------------
+bool MsgHeaderScanner::skipValue(const char * & p, const char * end)
+{
+    if (p == end) { return false; }
+
+    if (*p == '"') { return readString(p, end, 0); }
+
+    if ((*p == '{') || (*p == '[')) {
+        int depth = 0;
+        while (p != end) {
+            char c = *p;
+            if (c == '"') {
+                if (! readString(p, end, 0)) { return false; }
+                continue;
+            }
+            if ((c == '{') || (c == '[')) {
+                ++depth;
+            } else if ((c == '}') || (c == ']')) {
+                if (--depth == 0) { ++p; return true; }
+            }
+            ++p;
+        }
+        return false;
+    }
+
+    // Numbers, true, false and null
+    while ((p != end) && (*p != ',') && (*p != '}') && (*p != ']') &&
+           (*p != ' ') && (*p != '\n') && (*p != '\r') && (*p != '\t')) {
+        ++p;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: scanHeader
+//----------------------------------------------------------------------
+bool MsgHeaderScanner::scanHeader(const char * & p, const char * end,
+                                  MsgRouting & r)
+{
+    if ((p == end) || (*p != '{')) { return false; }
+    ++p;
+
+    std::string key;
+    while (true) {
+        skipWhiteSpace(p, end);
+        if (p == end) { return false; }
+        if (*p == '}') { return true; }
+        if (! readString(p, end, &key)) { return false; }
+        skipWhiteSpace(p, end);
+        if ((p == end) || (*p != ':')) { return false; }
+        ++p;
+        skipWhiteSpace(p, end);
+
+        std::string * field = 0;
+        if      (key == "id")      { field = &r.id; }
+        else if (key == "type")    { field = &r.type; }
+        else if (key == "version") { field = &r.version; }
+        else if (key == "source")  { field = &r.source; }
+        else if (key == "target")  { field = &r.target; }
+        else if (key == "dateTransmission") { field = &r.dateTransmission; }
+        else if (key == "traceId") { field = &r.traceId; }
+
+        bool ok = (((field != 0) && (*p == '"')) ?
+                   readString(p, end, field) : skipValue(p, end));
+        if (! ok) { return false; }
+        skipWhiteSpace(p, end);
+        if ((p != end) && (*p == ',')) { ++p; }
+    }
+}
+
+//}
@@ -0,0 +1,128 @@
+/******************************************************************************
+ * File:    msgscan.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.MsgHeaderScanner
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare MsgHeaderScanner class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef MSGSCAN_H
+#define MSGSCAN_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//------------------------------------------------------------
+#include <string>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   none
+//------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Struct: MsgRouting
+// Header fields needed to route a message to its handler
+//==========================================================================
+struct MsgRouting {
+    std::string id;
+    std::string type;
+    std::string version;
+    std::string source;
+    std::string target;
+    std::string dateTransmission;
+    std::string traceId;
+};
+
+//==========================================================================
+// Class: MsgHeaderScanner
+// Extracts the routing fields of the header of a serialized message,
+// without building the JSON document (binary messages are handled by
+// MsgCodec)
+//==========================================================================
+class MsgHeaderScanner {
+
+public:
+    //----------------------------------------------------------------------
+    // Method: scan
+    // Fill the routing fields from the message header, returns false if
+    // the header could not be found
+    //----------------------------------------------------------------------
+    static bool scan(const char * data, size_t len, MsgRouting & r);
+
+private:
+    //----------------------------------------------------------------------
+    // Method: skipWhiteSpace
+    //----------------------------------------------------------------------
+    static void skipWhiteSpace(const char * & p, const char * end);
+
+    //----------------------------------------------------------------------
+    // Method: readString
+    // Read a JSON string (p must point to the opening quote)
+    //----------------------------------------------------------------------
+    static bool readString(const char * & p, const char * end, std::string * s);
+
+    //----------------------------------------------------------------------
+    // Method: skipValue
+    // Skip any JSON value, including nested objects and arrays
+    //----------------------------------------------------------------------
+    static bool skipValue(const char * & p, const char * end);
+
+    //----------------------------------------------------------------------
+    // Method: scanHeader
+    //----------------------------------------------------------------------
+    static bool scanHeader(const char * & p, const char * end, MsgRouting & r);
+};
+
+//}
+
+#endif  /* MSGSCAN_H */
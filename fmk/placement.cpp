@@ -0,0 +1,160 @@
+/******************************************************************************
+ * File:    placement.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.AgentPlacement
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement AgentPlacement class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "placement.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+inline double weightFunc(double load, double tasks) {
+    return 100 * load + tasks;
+}
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+AgentPlacement::AgentPlacement(Policy p, double maxLd, double minMem)
+    : policy(p), maxLoad(maxLd), minFreeMem(minMem)
+{
+}
+
+//----------------------------------------------------------------------
+// Static Method: policyFromName
+//----------------------------------------------------------------------
+AgentPlacement::Policy AgentPlacement::policyFromName(const std::string & s)
+{
+    if (s == "binPacking") { return BinPacking; }
+    if (s == "spread")     { return Spread; }
+    return LeastLoaded;
+}
+
+//----------------------------------------------------------------------
+// Method: configure
+//----------------------------------------------------------------------
+void AgentPlacement::configure(Policy p, double maxLd, double minMem)
+{
+    policy     = p;
+    maxLoad    = maxLd;
+    minFreeMem = minMem;
+}
+
+//----------------------------------------------------------------------
+// Method: select
+// Name of the selected candidate, or empty if all the hosts are full
+//----------------------------------------------------------------------
+std::string AgentPlacement::select(const std::vector<Candidate> & candidates)
+{
+    const Candidate * best = 0;
+    double bestKey = 0.;
+    double bestTie = 0.;
+
+    for (auto & c : candidates) {
+        double util = utilisation(c);
+        if ((util >= maxLoad) || (freeMemory(c) < minFreeMem)) { continue; }
+
+        // Lowest key wins, and then lowest tie breaker
+        double key, tie;
+        switch (policy) {
+        case BinPacking:
+            key = -util;
+            tie = c.agentTasks;
+            break;
+        case Spread:
+            key = c.hostTasks;
+            tie = util;
+            break;
+        default:
+            key = weightFunc(util, c.agentTasks);
+            tie = c.hostTasks;
+            break;
+        }
+
+        if ((best == 0) || (key < bestKey) ||
+            ((key == bestKey) && (tie < bestTie))) {
+            best    = &c;
+            bestKey = key;
+            bestTie = tie;
+        }
+    }
+
+    return (best != 0) ? best->name : std::string();
+}
+
+//----------------------------------------------------------------------
+// Static Method: utilisation
+// Utilisation of the host of the candidate (1.0 is a busy CPU per CPU)
+//----------------------------------------------------------------------
+double AgentPlacement::utilisation(const Candidate & c)
+{
+    const HostInfo * h = c.hostInfo;
+    double numCpus = ((h != 0) && (h->cpuInfo.numCpus > 0)) ? h->cpuInfo.numCpus : 1.;
+    double util = c.hostTasks / numCpus;
+    if (h == 0) { return util; }
+
+    double load = h->loadAvg.load1min / numCpus;
+    if (load > util) { util = load; }
+
+    // Per-CPU loads are percentages over the last interval
+    if (! h->cpuInfo.cpuLoad.empty()) {
+        double cpu = 0.;
+        for (auto & l : h->cpuInfo.cpuLoad) { cpu += l.computedLoad; }
+        cpu /= (100. * h->cpuInfo.cpuLoad.size());
+        if (cpu > util) { util = cpu; }
+    }
+    return util;
+}
+
+//----------------------------------------------------------------------
+// Static Method: freeMemory
+// Fraction of the memory of the host available (1.0 if unknown)
+//----------------------------------------------------------------------
+double AgentPlacement::freeMemory(const Candidate & c)
+{
+    const HostInfo * h = c.hostInfo;
+    if ((h == 0) || (h->memInfo.memTotal == 0)) { return 1.; }
+    return double(h->memInfo.memAvailable) / h->memInfo.memTotal;
+}
+
+//}
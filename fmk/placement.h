@@ -0,0 +1,142 @@
+/******************************************************************************
+ * File:    placement.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.AgentPlacement
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare AgentPlacement class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - vector
+//------------------------------------------------------------
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------
+// Topic: External packages
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - hostinfo.h
+//------------------------------------------------------------
+#include "hostinfo.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: AgentPlacement
+// Selection of the agent to run a task, among the candidates (agents
+// ready to take it), from the latest information of their hosts and the
+// tasks they already run.  The utilisation of a host is the highest of
+// its 1 min. load average per CPU, its CPU load, and its tasks per CPU.
+// Hosts above maxLoad utilisation, or with less than minFreeMem of their
+// memory available, take no more tasks.  Among the others:
+//  - LeastLoaded: the agent with the lowest weighted utilisation and
+//    number of tasks
+//  - BinPacking: the agent on the busiest host, so that other hosts are
+//    kept free for large tasks (or switched off)
+//  - Spread: the agent on the host with the fewest tasks
+//==========================================================================
+class AgentPlacement {
+public:
+    enum Policy { LeastLoaded, BinPacking, Spread };
+
+    struct Candidate {
+        Candidate() : hostInfo(0), agentTasks(0), hostTasks(0) {}
+        std::string      name;
+        const HostInfo * hostInfo;
+        int              agentTasks;
+        int              hostTasks;
+    };
+
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    AgentPlacement(Policy p = LeastLoaded, double maxLd = 1.5, double minMem = 0.05);
+
+    //----------------------------------------------------------------------
+    // Static Method: policyFromName
+    // "leastLoaded", "binPacking" or "spread" (default: LeastLoaded)
+    //----------------------------------------------------------------------
+    static Policy policyFromName(const std::string & s);
+
+    //----------------------------------------------------------------------
+    // Method: configure
+    //----------------------------------------------------------------------
+    void configure(Policy p, double maxLd, double minMem);
+
+    //----------------------------------------------------------------------
+    // Method: select
+    // Name of the selected candidate, or empty if all the hosts are full
+    //----------------------------------------------------------------------
+    std::string select(const std::vector<Candidate> & candidates);
+
+    //----------------------------------------------------------------------
+    // Static Method: utilisation
+    // Utilisation of the host of the candidate (1.0 is a busy CPU per CPU)
+    //----------------------------------------------------------------------
+    static double utilisation(const Candidate & c);
+
+    //----------------------------------------------------------------------
+    // Static Method: freeMemory
+    // Fraction of the memory of the host available (1.0 if unknown)
+    //----------------------------------------------------------------------
+    static double freeMemory(const Candidate & c);
+
+private:
+    Policy policy;
+    double maxLoad;
+    double minFreeMem;
+};
+
+//}
+
+#endif // PLACEMENT_H
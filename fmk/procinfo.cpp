@@ -244,3 +244,134 @@ void ProcessingFrameworkInfo::fromStr(std::string s)
         //}
     }
 }
+
+void ProcessingFrameworkInfo::touchHost(std::string key)
+{
+    dirtyHosts.insert(key);
+}
+
+void ProcessingFrameworkInfo::touchAgent(std::string key, std::string agName)
+{
+    dirtyAgents[key].insert(agName);
+}
+
+void ProcessingFrameworkInfo::touchSwarm(std::string key)
+{
+    dirtySwarms.insert(key);
+}
+
+bool ProcessingFrameworkInfo::isDirty()
+{
+    return ((! dirtyHosts.empty()) ||
+            (! dirtyAgents.empty()) ||
+            (! dirtySwarms.empty()));
+}
+
+std::string ProcessingFrameworkInfo::toDeltaJsonStr(bool keyframe)
+{
+    unsigned long base = version++;
+    std::string hdr = (std::string("{") +
+                       FIELDNUM(version) + COMMA +
+                       FIELDNUM(base) + COMMA +
+                       "\"keyframe\": " + (keyframe ? "true" : "false"));
+    std::string body;
+
+    if (keyframe) {
+        std::string full = toJsonStr();
+        body = COMMA + full.substr(1, full.size() - 2);
+    } else {
+        // Hosts with new host info are sent entirely; for the rest, only
+        // the agents with new task status spectra are sent
+        std::string as, ass;
+        for (auto & key : dirtyHosts) {
+            auto it = hostsInfo.find(key);
+            if (it == hostsInfo.end()) { continue; }
+            if (! as.empty()) { as += COMMA; }
+            as += "\"" + key + "\": " + it->second->toJsonStr();
+        }
+        for (auto & kv : dirtyAgents) {
+            if (dirtyHosts.find(kv.first) != dirtyHosts.end()) { continue; }
+            auto it = hostsInfo.find(kv.first);
+            if (it == hostsInfo.end()) { continue; }
+            std::string ags;
+            for (auto & ag : it->second->agInfo) {
+                if (kv.second.find(ag.name) == kv.second.end()) { continue; }
+                if (! ags.empty()) { ags += COMMA; }
+                ags += "\"" + ag.name + "\": " + ag.toJsonStr();
+            }
+            if (! as.empty()) { as += COMMA; }
+            as += "\"" + kv.first + "\": {\"agentsInfo\": {" + ags + "}}";
+        }
+        for (auto & key : dirtySwarms) {
+            auto it = swarmInfo.find(key);
+            if (it == swarmInfo.end()) { continue; }
+            if (! ass.empty()) { ass += COMMA; }
+            ass += "\"" + key + "\": " + it->second->toJsonStr();
+        }
+        body = (COMMA +
+                "\"hostsInfo\": {" + as + "}" + COMMA +
+                "\"swarmInfo\": {" + ass + "}" + COMMA +
+                FIELDNUM(numSrvTasks) + COMMA +
+                FIELDNUM(numContTasks));
+    }
+
+    dirtyHosts.clear();
+    dirtyAgents.clear();
+    dirtySwarms.clear();
+
+    return hdr + body + std::string("}");
+}
+
+bool ProcessingFrameworkInfo::applyDelta(std::string s)
+{
+    Json::FastWriter fastWriter;
+    JValue d(s);
+    bool keyframe = d["keyframe"].asBool();
+
+    // A delta only applies on top of the version it was computed from;
+    // otherwise an update was lost, and we wait for the next keyframe
+    if ((! keyframe) && (d["base"].asUInt64() != version)) { return false; }
+
+    version      = d["version"].asUInt64();
+    numSrvTasks  = d["numSrvTasks"].asInt();
+    numContTasks = d["numContTasks"].asInt();
+    if (keyframe) {
+        masterInfo.fromStr(fastWriter.write(d["masterInfo"]));
+    }
+
+    // Entries are updated in place, so that pointers to them are kept valid
+    for (Json::ValueIterator itr = d["hostsInfo"].begin();
+         itr != d["hostsInfo"].end(); ++itr) {
+        std::string key = itr.key().asString();
+        ProcessingHostInfo * & ph = hostsInfo[key];
+        if ((ph == 0) || (itr->isMember("hostInfo"))) {
+            if (ph == 0) { ph = new ProcessingHostInfo; }
+            ph->fromStr(fastWriter.write(*itr));
+            continue;
+        }
+        json & ags = (*itr)["agentsInfo"];
+        for (Json::ValueIterator ittr = ags.begin(); ittr != ags.end(); ++ittr) {
+            AgentInfo ag;
+            ag.fromStr(fastWriter.write(*ittr));
+            bool found = false;
+            for (auto & agi : ph->agInfo) {
+                if (agi.name == ag.name) {
+                    agi = ag;
+                    found = true;
+                    break;
+                }
+            }
+            if (! found) { ph->agInfo.push_back(ag); }
+        }
+    }
+
+    for (Json::ValueIterator itr = d["swarmInfo"].begin();
+         itr != d["swarmInfo"].end(); ++itr) {
+        std::string key = itr.key().asString();
+        SwarmInfo * & sw = swarmInfo[key];
+        if (sw == 0) { sw = new SwarmInfo; }
+        sw->fromStr(fastWriter.write(*itr));
+    }
+
+    return true;
+}
@@ -49,9 +49,11 @@
 // Topic: System headers
 //   - vector
 //   - map
+//   - set
 //------------------------------------------------------------
 #include <vector>
 #include <map>
+#include <set>
 
 //------------------------------------------------------------
 // Topic: External packages
@@ -125,6 +127,8 @@ struct SwarmInfo : public BasicInfoContainer {
 };
 
 struct ProcessingFrameworkInfo : public BasicInfoContainer {
+    ProcessingFrameworkInfo() :
+        numSrvTasks(0), numContTasks(0), version(0) {}
     MasterInfo                      masterInfo;
     std::map<std::string,
         ProcessingHostInfo*>        hostsInfo;
@@ -134,6 +138,21 @@ struct ProcessingFrameworkInfo : public BasicInfoContainer {
     int                             numContTasks;
     virtual std::string toJsonStr();
     virtual void fromStr(std::string s);
+
+    // Versioned delta updates: the sub-trees modified since the last
+    // update are marked as dirty, and only those are serialized in the
+    // next delta.  A keyframe carries the entire structure.
+    unsigned long                   version;
+    std::set<std::string>           dirtyHosts;
+    std::map<std::string,
+        std::set<std::string>>      dirtyAgents;
+    std::set<std::string>           dirtySwarms;
+    void touchHost(std::string key);
+    void touchAgent(std::string key, std::string agName);
+    void touchSwarm(std::string key);
+    bool isDirty();
+    std::string toDeltaJsonStr(bool keyframe);
+    bool applyDelta(std::string s);
 };
 
 #endif // PROCINFO_H
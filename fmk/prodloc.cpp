@@ -0,0 +1,156 @@
+/******************************************************************************
+ * File:    prodloc.cpp  
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.ProductLocator
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement ProductLocator class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+
+#include "prodloc.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+ProductLocator::ProductLocator(size_t cap)
+    : capacity(cap)
+{
+}
+
+//----------------------------------------------------------------------
+// Method: setCapacity
+//----------------------------------------------------------------------
+void ProductLocator::setCapacity(size_t cap)
+{
+    capacity = cap;
+    for (auto & kv : held) { trim(kv.first); }
+}
+
+//----------------------------------------------------------------------
+// Method: add
+// Record that the host keeps a copy of the product.  A product added
+// again becomes the newest one of the host
+//----------------------------------------------------------------------
+void ProductLocator::add(const std::string & product, const std::string & host)
+{
+    if (product.empty() || host.empty()) { return; }
+
+    std::deque<std::string> & prods = held[host];
+    if (! where[product].insert(host).second) {
+        prods.erase(std::find(prods.begin(), prods.end(), product));
+    }
+    prods.push_back(product);
+    trim(host);
+}
+
+//----------------------------------------------------------------------
+// Method: forget
+// Remove all the products of a host
+//----------------------------------------------------------------------
+void ProductLocator::forget(const std::string & host)
+{
+    auto it = held.find(host);
+    if (it == held.end()) { return; }
+    while (! it->second.empty()) {
+        drop(it->second.front(), host);
+        it->second.pop_front();
+    }
+    held.erase(it);
+}
+
+//----------------------------------------------------------------------
+// Method: hosts
+// Hosts with a copy of the product
+//----------------------------------------------------------------------
+std::vector<std::string> ProductLocator::hosts(const std::string & product) const
+{
+    auto it = where.find(product);
+    if (it == where.end()) { return std::vector<std::string>(); }
+    return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
+//----------------------------------------------------------------------
+// Method: count
+// Number of the products given held by each host, only for the hosts
+// holding any of them
+//----------------------------------------------------------------------
+std::map<std::string, int>
+ProductLocator::count(const std::vector<std::string> & products) const
+{
+    std::map<std::string, int> n;
+    for (auto & p : products) {
+        auto it = where.find(p);
+        if (it == where.end()) { continue; }
+        for (auto & h : it->second) { ++n[h]; }
+    }
+    return n;
+}
+
+//----------------------------------------------------------------------
+// Method: drop
+//----------------------------------------------------------------------
+void ProductLocator::drop(const std::string & product, const std::string & host)
+{
+    auto it = where.find(product);
+    if (it == where.end()) { return; }
+    it->second.erase(host);
+    if (it->second.empty()) { where.erase(it); }
+}
+
+//----------------------------------------------------------------------
+// Method: trim
+// Forget the oldest products of the host above the capacity
+//----------------------------------------------------------------------
+void ProductLocator::trim(const std::string & host)
+{
+    if (capacity == 0) { return; }
+    std::deque<std::string> & prods = held[host];
+    while (prods.size() > capacity) {
+        drop(prods.front(), host);
+        prods.pop_front();
+    }
+}
+
+//}
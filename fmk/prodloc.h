@@ -0,0 +1,142 @@
+/******************************************************************************
+ * File:    prodloc.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.ProductLocator
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare ProductLocator class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+
+#ifndef PRODLOC_H
+#define PRODLOC_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - vector
+//   - map
+//   - set
+//   - deque
+//------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <deque>
+
+//------------------------------------------------------------
+// Topic: External packages
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: ProductLocator
+// Registry of the processing hosts that keep a copy of each product in
+// their local cache, as reported by their agents.  Each host keeps at
+// most capacity products (0 means no limit); the oldest ones are
+// forgotten first, as the agents do with the files in the cache.  It is
+// only a hint: an agent that no longer has a product fetches it again
+// from the gateway.
+//==========================================================================
+class ProductLocator {
+public:
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    explicit ProductLocator(size_t cap = 0);
+
+    //----------------------------------------------------------------------
+    // Method: setCapacity
+    //----------------------------------------------------------------------
+    void setCapacity(size_t cap);
+
+    //----------------------------------------------------------------------
+    // Method: add
+    // Record that the host keeps a copy of the product
+    //----------------------------------------------------------------------
+    void add(const std::string & product, const std::string & host);
+
+    //----------------------------------------------------------------------
+    // Method: forget
+    // Remove all the products of a host
+    //----------------------------------------------------------------------
+    void forget(const std::string & host);
+
+    //----------------------------------------------------------------------
+    // Method: hosts
+    // Hosts with a copy of the product
+    //----------------------------------------------------------------------
+    std::vector<std::string> hosts(const std::string & product) const;
+
+    //----------------------------------------------------------------------
+    // Method: count
+    // Number of the products given held by each host, only for the hosts
+    // holding any of them
+    //----------------------------------------------------------------------
+    std::map<std::string, int> count(const std::vector<std::string> & products) const;
+
+    //----------------------------------------------------------------------
+    // Method: size
+    // Number of products with a copy in any host
+    //----------------------------------------------------------------------
+    size_t size() const { return where.size(); }
+
+private:
+    void drop(const std::string & product, const std::string & host);
+    void trim(const std::string & host);
+
+    std::map<std::string, std::set<std::string>>   where;
+    std::map<std::string, std::deque<std::string>> held;
+    size_t capacity;
+};
+
+//}
+
+#endif // PRODLOC_H
@@ -0,0 +1,295 @@
+/******************************************************************************
+ * File:    replay.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.Replay
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement ReplayRole and ReplayEngine classes
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   Component, MsgJournal
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "replay.h"
+#include "msgscan.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+
+#include <dirent.h>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+ReplayRole::ReplayRole(ReplayEngine * eng, ChannelId chnl)
+    : engine(eng), chnlId(chnl)
+{
+    elemClass = 0;
+    address   = "replay://" + ChannelRegistry::name(chnl);
+}
+
+//----------------------------------------------------------------------
+// Method: inject
+//----------------------------------------------------------------------
+void ReplayRole::inject(MessageBuffer && m)
+{
+    iMsgList.push(std::move(m));
+}
+
+//----------------------------------------------------------------------
+// Method: setMsgOut
+//----------------------------------------------------------------------
+bool ReplayRole::setMsgOut(MessageBuffer m)
+{
+    engine->recordOutput(chnlId, m);
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+ReplayEngine::ReplayEngine(Component * c, std::string dir)
+    : comp(c), outDir(dir), numOutputs(0)
+{
+    outJournal.reset(new MsgJournal(outDir, comp->getName() + ".out"));
+}
+
+//----------------------------------------------------------------------
+// Method: addChannel
+// Connect the component to a stand-in role for the channel
+//----------------------------------------------------------------------
+void ReplayEngine::addChannel(const ChannelDescriptor & chnl)
+{
+    ChannelId id = ChannelRegistry::intern(chnl);
+    if (roles.find(id) != roles.end()) { return; }
+
+    ReplayRole * role = new ReplayRole(this, id);
+    roles[id].reset(role);
+    ChannelDescriptor chnlName(chnl);
+    comp->addConnection(chnlName, role);
+}
+
+//----------------------------------------------------------------------
+// Method: loadJournal
+// Take the records in direction dir from a journal
+//----------------------------------------------------------------------
+int ReplayEngine::loadJournal(std::string jrnlDir, std::string name,
+                              char dir, int64_t fromNs, int64_t toNs)
+{
+    MsgJournalReader reader(jrnlDir, name);
+    reader.seek(fromNs);
+
+    MsgJournalReader::Record r;
+    int numRecs = 0;
+    while (reader.next(r)) {
+        if (r.timeNs > toNs) { break; }
+        if (r.dir != dir) { continue; }
+        addChannel(r.chnl);
+        inputs.push_back({r.timeNs, ChannelRegistry::find(r.chnl),
+                          std::string(r.data, r.length)});
+        ++numRecs;
+    }
+    return numRecs;
+}
+
+//----------------------------------------------------------------------
+// Method: loadMsonDir
+// Take the .mson dumps in direction dir found in msonDir.  The file
+// names are <sec>.<nsec>_<component>_<dir>_<channel>.mson
+//----------------------------------------------------------------------
+int ReplayEngine::loadMsonDir(std::string msonDir, char dir)
+{
+    DIR * d = opendir(msonDir.c_str());
+    if (d == 0) { return 0; }
+
+    const std::string ext(".mson");
+    const std::string tag = std::string("_") + dir + "_";
+    int numFiles = 0;
+    struct dirent * e;
+    while ((e = readdir(d)) != 0) {
+        std::string f(e->d_name);
+        if ((f.size() <= ext.size()) ||
+            (f.compare(f.size() - ext.size(), ext.size(), ext) != 0)) { continue; }
+
+        size_t timeEnd = f.find('_');
+        size_t dirPos  = f.find(tag, timeEnd);
+        if ((timeEnd == std::string::npos) || (dirPos == std::string::npos)) { continue; }
+
+        std::string chnl = f.substr(dirPos + tag.size(),
+                                    f.size() - ext.size() - dirPos - tag.size());
+        size_t dot = f.find('.');
+        int64_t timeNs = (int64_t)(atoll(f.c_str())) * 1000000000LL;
+        if (dot < timeEnd) { timeNs += atol(f.c_str() + dot + 1); }
+
+        std::ifstream fIn(msonDir + "/" + f);
+        std::stringstream buffer;
+        buffer << fIn.rdbuf();
+
+        addChannel(chnl);
+        inputs.push_back({timeNs, ChannelRegistry::find(chnl), buffer.str()});
+        ++numFiles;
+    }
+    closedir(d);
+    return numFiles;
+}
+
+//----------------------------------------------------------------------
+// Method: run
+// Replay the messages
+//----------------------------------------------------------------------
+void ReplayEngine::run(double speed)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    std::stable_sort(inputs.begin(), inputs.end(),
+                     [](const Input & a, const Input & b) { return a.timeNs < b.timeNs; });
+
+    comp->setChannelEncodings();
+    comp->setChannelQueues();
+    comp->fromInitialisedToRunning();
+    comp->fromRunningToOperational();
+
+    Clock::time_point start = Clock::now();
+    auto waitUntil = [&](int64_t relNs) {
+        if (speed > 0) {
+            std::this_thread::sleep_until(start +
+                std::chrono::nanoseconds((int64_t)(relNs / speed)));
+        }
+    };
+
+    // Heart beats follow the timeline of the captured messages
+    int64_t t0 = inputs.empty() ? 0 : inputs.front().timeNs;
+    int64_t stepNs = (int64_t)(comp->stepSize) * 1000000LL;
+    int64_t nextBeatNs = stepNs;
+
+    MsgRouting route;
+    for (auto & in : inputs) {
+        int64_t relNs = in.timeNs - t0;
+        while (nextBeatNs <= relNs) {
+            waitUntil(nextBeatNs);
+            ++comp->iteration;
+            comp->runPostedTasks();
+            comp->runEachIteration();
+            nextBeatNs += stepNs;
+        }
+        waitUntil(relNs);
+
+        roles[in.chnl]->inject(MessageBuffer(in.data));
+        Clock::time_point t1 = Clock::now();
+        // Messages held back by a full staging queue go in the same step
+        do {
+            comp->processIncommingMessages();
+        } while (comp->messagesPending());
+        Clock::time_point t2 = Clock::now();
+
+        std::string type;
+        if (MsgHeaderScanner::scan(in.data.data(), in.data.size(), route)) {
+            type = route.type;
+        }
+        samples.push_back({in.timeNs, in.chnl, type,
+                    std::chrono::duration<double, std::micro>(t2 - t1).count()});
+    }
+
+    // Flush the outputs
+    outJournal.reset();
+    writeLatencies();
+}
+
+//----------------------------------------------------------------------
+// Method: recordOutput
+// Called by the roles for each message sent by the component
+//----------------------------------------------------------------------
+void ReplayEngine::recordOutput(ChannelId chnl, MessageBuffer & m)
+{
+    ++numOutputs;
+    if (outJournal) { outJournal->append(MsgJournal::Send, chnl, std::move(m)); }
+}
+
+//----------------------------------------------------------------------
+// Method: report
+// Show handling latency statistics per message type
+//----------------------------------------------------------------------
+void ReplayEngine::report(std::ostream & os)
+{
+    std::map<std::string, std::vector<double>> perType;
+    for (auto & s : samples) {
+        perType[s.type.empty() ? std::string("?") : s.type].push_back(s.us);
+        perType["ALL"].push_back(s.us);
+    }
+
+    os << comp->getName() << ": " << samples.size() << " messages replayed, "
+       << numOutputs << " messages sent\n"
+       << "Handling latency (us):\n"
+       << std::setw(10) << "Type" << std::setw(10) << "Count"
+       << std::setw(12) << "Mean" << std::setw(12) << "P50"
+       << std::setw(12) << "P90" << std::setw(12) << "P99"
+       << std::setw(12) << "Max" << '\n';
+    os << std::fixed << std::setprecision(1);
+    for (auto & kv : perType) {
+        std::vector<double> & v = kv.second;
+        std::sort(v.begin(), v.end());
+        double sum = 0;
+        for (double x : v) { sum += x; }
+        auto pct = [&v](double p) { return v[(size_t)(p * (v.size() - 1))]; };
+        os << std::setw(10) << kv.first << std::setw(10) << v.size()
+           << std::setw(12) << sum / v.size() << std::setw(12) << pct(0.5)
+           << std::setw(12) << pct(0.9) << std::setw(12) << pct(0.99)
+           << std::setw(12) << v.back() << '\n';
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: writeLatencies
+//----------------------------------------------------------------------
+void ReplayEngine::writeLatencies()
+{
+    std::ofstream fOut(outDir + "/" + comp->getName() + ".latency.csv");
+    fOut << "time_ns,channel,type,latency_us\n";
+    for (auto & s : samples) {
+        fOut << s.timeNs << ',' << ChannelRegistry::name(s.chnl) << ','
+             << s.type << ',' << s.us << '\n';
+    }
+}
+
+//}
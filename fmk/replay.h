@@ -0,0 +1,224 @@
+/******************************************************************************
+ * File:    replay.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.Replay
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare ReplayRole and ReplayEngine classes
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   Component, MsgJournal
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - vector
+//   - map
+//   - memory
+//   - iostream
+//------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <iostream>
+#include <climits>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - component.h
+//   - msgjournal.h
+//------------------------------------------------------------
+#include "component.h"
+#include "msgjournal.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+class ReplayEngine;
+
+//==========================================================================
+// Class: ReplayRole
+// In-process stand-in for a connection: incoming messages are injected
+// by the replay engine, and outgoing messages are handed over to it
+//==========================================================================
+class ReplayRole : public ScalabilityProtocolRole {
+
+public:
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    ReplayRole(ReplayEngine * eng, ChannelId chnl);
+
+    //----------------------------------------------------------------------
+    // Method: inject
+    //----------------------------------------------------------------------
+    void inject(MessageBuffer && m);
+
+    //----------------------------------------------------------------------
+    // Method: update
+    //----------------------------------------------------------------------
+    virtual void update() {}
+
+    //----------------------------------------------------------------------
+    // Method: setMsgOut
+    //----------------------------------------------------------------------
+    virtual bool setMsgOut(MessageBuffer m);
+
+    //----------------------------------------------------------------------
+    // Method: getClassName
+    //----------------------------------------------------------------------
+    virtual std::string getClassName() { return "ReplayRole"; }
+
+    //----------------------------------------------------------------------
+    // Method: getRecvFd
+    //----------------------------------------------------------------------
+    virtual int getRecvFd() { return -1; }
+
+protected:
+    virtual void init(int elemCls, const char * addr) {}
+    virtual void processMessageString(MessageString & m) {}
+
+private:
+    ReplayEngine * engine;
+    ChannelId      chnlId;
+};
+
+//==========================================================================
+// Class: ReplayEngine
+// Injects captured messages (from a message journal or from .mson
+// dumps) into a single component, with the original timing or an
+// accelerated one, recording the messages it sends and the time it
+// takes to handle each incoming message.  The component is driven from
+// the caller thread (it must be created without address, so that it
+// does not start its own thread)
+//==========================================================================
+class ReplayEngine {
+
+public:
+    //----------------------------------------------------------------------
+    // Constructor
+    // Outputs (journal <name>.out, and latencies) are stored in outDir
+    //----------------------------------------------------------------------
+    ReplayEngine(Component * c, std::string outDir);
+
+    //----------------------------------------------------------------------
+    // Method: addChannel
+    // Connect the component to a stand-in role for the channel (channels
+    // with injected messages are added automatically)
+    //----------------------------------------------------------------------
+    void addChannel(const ChannelDescriptor & chnl);
+
+    //----------------------------------------------------------------------
+    // Method: loadJournal
+    // Take the records in direction dir from a journal, returns number
+    // of records taken
+    //----------------------------------------------------------------------
+    int loadJournal(std::string jrnlDir, std::string name,
+                    char dir = MsgJournal::Recv,
+                    int64_t fromNs = 0, int64_t toNs = LLONG_MAX);
+
+    //----------------------------------------------------------------------
+    // Method: loadMsonDir
+    // Take the .mson dumps in direction dir found in msonDir, returns
+    // number of files taken
+    //----------------------------------------------------------------------
+    int loadMsonDir(std::string msonDir, char dir = MsgJournal::Recv);
+
+    //----------------------------------------------------------------------
+    // Method: run
+    // Replay the messages.  speed is the acceleration factor with
+    // respect to the original timing (0: no waits at all)
+    //----------------------------------------------------------------------
+    void run(double speed = 1.0);
+
+    //----------------------------------------------------------------------
+    // Method: report
+    // Show handling latency statistics per message type
+    //----------------------------------------------------------------------
+    void report(std::ostream & os);
+
+    //----------------------------------------------------------------------
+    // Method: recordOutput
+    // Called by the roles for each message sent by the component
+    //----------------------------------------------------------------------
+    void recordOutput(ChannelId chnl, MessageBuffer & m);
+
+private:
+    struct Input {
+        int64_t     timeNs;
+        ChannelId   chnl;
+        std::string data;
+    };
+
+    struct Sample {
+        int64_t     timeNs;
+        ChannelId   chnl;
+        std::string type;
+        double      us;
+    };
+
+    //----------------------------------------------------------------------
+    // Method: writeLatencies
+    //----------------------------------------------------------------------
+    void writeLatencies();
+
+private:
+    Component *                                      comp;
+    std::string                                      outDir;
+    std::vector<Input>                               inputs;
+    std::map<ChannelId, std::unique_ptr<ReplayRole>> roles;
+    std::unique_ptr<MsgJournal>                      outJournal;
+    std::vector<Sample>                              samples;
+    int                                              numOutputs;
+};
+
+//}
+
+#endif  /* REPLAY_H */
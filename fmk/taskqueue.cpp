@@ -0,0 +1,340 @@
+/******************************************************************************
+ * File:    taskqueue.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.TaskQueue
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement TaskQueue class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "taskqueue.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+TaskQueue::TaskQueue(const std::string & n, size_t cap, Policy p, int blkMs)
+    : OverflowQueueBase(n), agingSecs(60.), count(0),
+      capacity(cap), policy(p), blockMs(blkMs),
+      highWater(0), pushed(0), dropped(0), rejected(0)
+{
+    Bucket dflt;
+    dflt.cls.name = "default";
+    buckets.push_back(dflt);
+}
+
+//----------------------------------------------------------------------
+// Method: setClasses
+// Define the priority classes (tasks already queued are kept in their
+// classes), and the aging period
+//----------------------------------------------------------------------
+void TaskQueue::setClasses(const std::vector<Class> & cls, double aging)
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+
+    std::list<std::pair<Clock::time_point, TaskInfo>> queued;
+    for (auto & b : buckets) { queued.splice(queued.end(), b.items); }
+
+    buckets.resize(1);
+    buckets[0].cls.weight = 1;
+    for (auto & c : cls) {
+        if (c.name == buckets[0].cls.name) {
+            buckets[0].cls.weight = c.weight;
+        } else {
+            Bucket b;
+            b.cls = c;
+            buckets.push_back(b);
+        }
+    }
+    agingSecs = aging;
+
+    // Re-queue the tasks, keeping their waiting times
+    for (auto & it : queued) {
+        bucketFor(it.second).items.push_back(std::move(it));
+    }
+    for (auto & b : buckets) {
+        b.items.sort([] (const std::pair<Clock::time_point, TaskInfo> & p,
+                         const std::pair<Clock::time_point, TaskInfo> & q) {
+                         return p.first < q.first; });
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: configure
+//----------------------------------------------------------------------
+void TaskQueue::configure(size_t cap, Policy p)
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    capacity = cap;
+    policy   = p;
+    cvRoom.notify_all();
+}
+
+//----------------------------------------------------------------------
+// Method: overflowPolicy
+//----------------------------------------------------------------------
+OverflowQueueBase::Policy TaskQueue::overflowPolicy()
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    return policy;
+}
+
+//----------------------------------------------------------------------
+// Method: push
+// Append a task to its class; returns false if a task was dropped, or
+// if the new one was rejected (Block)
+//----------------------------------------------------------------------
+bool TaskQueue::push(TaskInfo x)
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    ++pushed;
+
+    if ((policy == Block) && (capacity > 0) && (count >= capacity)) {
+        if ((blockMs <= 0) ||
+            (! cvRoom.wait_for(ulck, std::chrono::milliseconds(blockMs),
+                               [this]() { return ((capacity == 0) ||
+                                                  (count < capacity)); }))) {
+            ++rejected;
+            return false;
+        }
+    }
+
+    Clock::time_point now = Clock::now();
+    bool dropping = (capacity > 0) && (count >= capacity);
+    if (dropping) {
+        buckets[selectBucket(now, false)].items.pop_front();
+        --count;
+        ++dropped;
+    }
+
+    bucketFor(x).items.push_back(std::make_pair(now, std::move(x)));
+    ++count;
+    if (count > highWater) { highWater = count; }
+    return !dropping;
+}
+
+//----------------------------------------------------------------------
+// Method: pop
+// Extract the task with the highest priority, returns false if the
+// queue is empty
+//----------------------------------------------------------------------
+bool TaskQueue::pop(TaskInfo & x)
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    if (count == 0) { return false; }
+    Bucket & b = buckets[selectBucket(Clock::now(), true)];
+    x = std::move(b.items.front().second);
+    b.items.pop_front();
+    --count;
+    cvRoom.notify_one();
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: pop
+// Extract the first task, in priority order, accepted by the function
+// given.  Classes are visited by the priority of their heads, and each
+// one in arrival order
+//----------------------------------------------------------------------
+bool TaskQueue::pop(TaskInfo & x, Acceptor accept, size_t depth)
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    if (count == 0) { return false; }
+
+    Clock::time_point now = Clock::now();
+    std::vector<size_t> order;
+    std::vector<double> prio(buckets.size(), 0.);
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        Bucket & b = buckets[i];
+        if (b.items.empty()) { continue; }
+        double age = std::chrono::duration<double>(now - b.items.front().first).count();
+        prio[i] = b.cls.weight + ((agingSecs > 0.) ? (age / agingSecs) : 0.);
+        order.push_back(i);
+    }
+    // Ties go to the class with the oldest head, as in the plain pop
+    std::sort(order.begin(), order.end(), [&] (size_t i, size_t j) {
+            if (prio[i] != prio[j]) { return prio[i] > prio[j]; }
+            return buckets[i].items.front().first < buckets[j].items.front().first; });
+
+    size_t looked = 0;
+    for (auto i : order) {
+        Bucket & b = buckets[i];
+        for (auto it = b.items.begin(); it != b.items.end(); ++it) {
+            if ((depth > 0) && (looked++ >= depth)) { return false; }
+            double waited = std::chrono::duration<double>(now - it->first).count();
+            if (accept(it->second, waited)) {
+                x = std::move(it->second);
+                b.items.erase(it);
+                --count;
+                cvRoom.notify_one();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------
+// Method: requeue
+// Put back in its class a task just popped that could not be delivered.
+// It takes its original arrival time (from the seconds it had been
+// waiting, exact up to the time since it was popped), and its place in
+// arrival order, so that neither the aging of the class nor the waiting
+// time given to the acceptors restart
+//----------------------------------------------------------------------
+void TaskQueue::requeue(TaskInfo x, double waited)
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    Bucket & b = bucketFor(x);
+    Clock::time_point t = Clock::now() -
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(waited));
+    auto it = b.items.begin();
+    while ((it != b.items.end()) && (it->first <= t)) { ++it; }
+    b.items.insert(it, std::make_pair(t, std::move(x)));
+    ++count;
+    if (count > highWater) { highWater = count; }
+}
+
+//----------------------------------------------------------------------
+// Method: classify
+// Name of the class of the task
+//----------------------------------------------------------------------
+std::string TaskQueue::classify(TaskInfo & x)
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    return bucketFor(x).cls.name;
+}
+
+//----------------------------------------------------------------------
+// Method: size
+//----------------------------------------------------------------------
+size_t TaskQueue::size()
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    return count;
+}
+
+//----------------------------------------------------------------------
+// Method: stats
+//----------------------------------------------------------------------
+OverflowQueueBase::Stats TaskQueue::stats()
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    return Stats {name, count, capacity, highWater, pushed, dropped, 0, rejected};
+}
+
+//----------------------------------------------------------------------
+// Method: bucketFor
+// Matching class with the highest weight, or the default one
+//----------------------------------------------------------------------
+TaskQueue::Bucket & TaskQueue::bucketFor(TaskInfo & x)
+{
+    size_t best = 0;
+    for (size_t i = 1; i < buckets.size(); ++i) {
+        if (matches(buckets[i].cls, x) &&
+            ((best == 0) || (buckets[i].cls.weight > buckets[best].cls.weight))) {
+            best = i;
+        }
+    }
+    return buckets[best];
+}
+
+//----------------------------------------------------------------------
+// Method: selectBucket
+// Non empty class with the highest (or lowest) priority at the time
+// given.  Ties go to the class with the oldest (newest) head
+//----------------------------------------------------------------------
+int TaskQueue::selectBucket(Clock::time_point now, bool highest)
+{
+    int    sel = -1;
+    double selPrio = 0.;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        Bucket & b = buckets[i];
+        if (b.items.empty()) { continue; }
+        double age  = std::chrono::duration<double>(now - b.items.front().first).count();
+        double prio = b.cls.weight + ((agingSecs > 0.) ? (age / agingSecs) : 0.);
+        bool better = highest ? (prio > selPrio) : (prio < selPrio);
+        if ((sel < 0) || better ||
+            ((prio == selPrio) &&
+             ((b.items.front().first < buckets[sel].items.front().first) == highest))) {
+            sel = int(i);
+            selPrio = prio;
+        }
+    }
+    return sel;
+}
+
+//----------------------------------------------------------------------
+// Method: matches
+//----------------------------------------------------------------------
+bool TaskQueue::matches(const Class & c, TaskInfo & x)
+{
+    if (! c.origin.empty()) {
+        std::string origin = x.taskOrigin();
+        if (origin.empty()) { origin = "nominal"; }
+        if (origin != c.origin) { return false; }
+    }
+
+    if ((! c.rules.empty()) &&
+        (std::find(c.rules.begin(), c.rules.end(), x.taskRule()) == c.rules.end())) {
+        return false;
+    }
+
+    if (! c.productTypes.empty()) {
+        bool found = false;
+        for (auto & m : x.inputs.products) {
+            if (std::find(c.productTypes.begin(), c.productTypes.end(),
+                          m.productType()) != c.productTypes.end()) {
+                found = true;
+                break;
+            }
+        }
+        if (! found) { return false; }
+    }
+
+    if ((c.flags != 0) && ((x.taskFlags() & c.flags) == 0)) { return false; }
+
+    return true;
+}
+
+//}
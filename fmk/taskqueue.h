@@ -0,0 +1,225 @@
+/******************************************************************************
+ * File:    taskqueue.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.TaskQueue
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare TaskQueue class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef TASKQUEUE_H
+#define TASKQUEUE_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - vector
+//   - list
+//   - chrono
+//   - functional
+//   - mutex
+//   - condition_variable
+//------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <list>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+//------------------------------------------------------------
+// Topic: External packages
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - datatypes.h
+//   - ovfqueue.h
+//------------------------------------------------------------
+#include "datatypes.h"
+#include "ovfqueue.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: TaskQueue
+// Queue of tasks waiting for an agent, split in priority classes.  Each
+// class is a FIFO with a weight; the task popped is the head of the class
+// with the highest priority, which is its weight plus one point for each
+// agingSecs seconds the head has been waiting, so that low weight classes
+// are not starved.  Tasks are put in the matching class with the highest
+// weight, or in the default class (weight 1).  When the queue is full,
+// the new task is rejected (Block), or the oldest task of the lowest
+// priority class is dropped.  All methods are thread safe.
+//==========================================================================
+class TaskQueue : public OverflowQueueBase {
+public:
+    //----------------------------------------------------------------------
+    // Struct: Class
+    // Empty criteria match any task.  flags match if any of them is set
+    // in the task flags; origin is "nominal" or "reprocessing"
+    //----------------------------------------------------------------------
+    struct Class {
+        Class() : weight(1), flags(0) {}
+        std::string              name;
+        int                      weight;
+        std::string              origin;
+        std::vector<std::string> rules;
+        std::vector<std::string> productTypes;
+        int                      flags;
+    };
+
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    explicit TaskQueue(const std::string & n, size_t cap = 0,
+                       Policy p = Block, int blkMs = 100);
+
+    //----------------------------------------------------------------------
+    // Method: setClasses
+    // Define the priority classes (tasks already queued are kept in
+    // their classes), and the aging period
+    //----------------------------------------------------------------------
+    void setClasses(const std::vector<Class> & cls, double agingSecs);
+
+    //----------------------------------------------------------------------
+    // Method: configure
+    //----------------------------------------------------------------------
+    void configure(size_t cap, Policy p);
+
+    //----------------------------------------------------------------------
+    // Method: overflowPolicy
+    //----------------------------------------------------------------------
+    Policy overflowPolicy();
+
+    //----------------------------------------------------------------------
+    // Method: push
+    // Append a task to its class; returns false if a task was dropped,
+    // or if the new one was rejected (Block)
+    //----------------------------------------------------------------------
+    bool push(TaskInfo x);
+
+    //----------------------------------------------------------------------
+    // Method: pop
+    // Extract the task with the highest priority, returns false if the
+    // queue is empty
+    //----------------------------------------------------------------------
+    bool pop(TaskInfo & x);
+
+    //----------------------------------------------------------------------
+    // Method: pop
+    // Extract the first task, in priority order, accepted by the function
+    // given, which takes the task and the seconds it has been waiting.
+    // At most depth tasks are looked at (0 means all of them).  The
+    // function is called with the queue locked.  Returns false if no
+    // task was accepted
+    //----------------------------------------------------------------------
+    typedef std::function<bool(TaskInfo &, double)> Acceptor;
+    bool pop(TaskInfo & x, Acceptor accept, size_t depth = 0);
+
+    //----------------------------------------------------------------------
+    // Method: requeue
+    // Put back in its class a task just popped that could not be
+    // delivered, given the seconds it had been waiting, so that it keeps
+    // its place and its age.  The capacity is not checked
+    //----------------------------------------------------------------------
+    void requeue(TaskInfo x, double waited);
+
+    //----------------------------------------------------------------------
+    // Method: classify
+    // Name of the class of the task
+    //----------------------------------------------------------------------
+    std::string classify(TaskInfo & x);
+
+    //----------------------------------------------------------------------
+    // Method: size
+    //----------------------------------------------------------------------
+    size_t size();
+
+    //----------------------------------------------------------------------
+    // Method: empty
+    //----------------------------------------------------------------------
+    bool empty() { return size() == 0; }
+
+    //----------------------------------------------------------------------
+    // Method: stats
+    //----------------------------------------------------------------------
+    virtual Stats stats();
+
+private:
+    TaskQueue(const TaskQueue &) = delete;
+    TaskQueue & operator=(const TaskQueue &) = delete;
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Bucket {
+        Class                                            cls;
+        std::list<std::pair<Clock::time_point, TaskInfo>> items;
+    };
+
+    Bucket & bucketFor(TaskInfo & x);
+    int selectBucket(Clock::time_point now, bool highest);
+    bool matches(const Class & c, TaskInfo & x);
+
+    std::vector<Bucket> buckets;
+    double              agingSecs;
+    size_t              count;
+
+    size_t   capacity;
+    Policy   policy;
+    int      blockMs;
+
+    size_t   highWater;
+    uint64_t pushed;
+    uint64_t dropped;
+    uint64_t rejected;
+
+    std::mutex              mtx;
+    std::condition_variable cvRoom;
+};
+
+//}
+
+#endif // TASKQUEUE_H
@@ -0,0 +1,252 @@
+/******************************************************************************
+ * File:    tracer.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.Tracer
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Implement Tracer class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "tracer.h"
+
+#include "uuidxx.h"
+
+#include <chrono>
+#include <fstream>
+#include <map>
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+// Max. number of spans kept (the oldest are discarded)
+const size_t TRACE_MAX_SPANS = 65536;
+
+//----------------------------------------------------------------------
+// Method: instance
+// Return the tracer of the process
+//----------------------------------------------------------------------
+Tracer & Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+//----------------------------------------------------------------------
+// Method: newTraceId
+// Create a new trace id
+//----------------------------------------------------------------------
+std::string Tracer::newTraceId()
+{
+    UUID uuid;
+    uuid.generate_random();
+    return uuid.asLowerString();
+}
+
+//----------------------------------------------------------------------
+// Method: now
+// Current time, in microseconds since the epoch
+//----------------------------------------------------------------------
+int64_t Tracer::now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+//----------------------------------------------------------------------
+// Method: mark
+// Store the current time in the record, as start of the next span
+//----------------------------------------------------------------------
+void Tracer::mark(json & v)
+{
+    v["traceMark"] = Json::Int64(now());
+}
+
+//----------------------------------------------------------------------
+// Method: record
+// Store a span of a trace
+//----------------------------------------------------------------------
+void Tracer::record(const std::string & traceId, const std::string & stage,
+                    const std::string & comp, int64_t start, int64_t end)
+{
+    if (traceId.empty()) { return; }
+    push(Span {traceId, stage, comp, start, (end < start) ? start : end});
+}
+
+//----------------------------------------------------------------------
+// Method: recordSinceMark
+// Store a span of the trace of the record, from its mark until now,
+// and mark the record again
+//----------------------------------------------------------------------
+void Tracer::recordSinceMark(json & v, const std::string & stage,
+                             const std::string & comp)
+{
+    int64_t t = now();
+    if (v.isMember("traceMark")) {
+        record(v["traceId"].asString(), stage, comp,
+               v["traceMark"].asInt64(), t);
+    }
+    v["traceMark"] = Json::Int64(t);
+}
+
+//----------------------------------------------------------------------
+// Method: take
+// Remove the spans of a trace from the store, and return them
+//----------------------------------------------------------------------
+json Tracer::take(const std::string & traceId)
+{
+    json arr(Json::arrayValue);
+    std::lock_guard<std::mutex> lock(mtx);
+    std::deque<Span> rest;
+    for (auto & s : spans) {
+        if (s.traceId != traceId) {
+            rest.push_back(std::move(s));
+            continue;
+        }
+        json v;
+        v["traceId"] = s.traceId;
+        v["stage"]   = s.stage;
+        v["comp"]    = s.comp;
+        v["start"]   = Json::Int64(s.start);
+        v["end"]     = Json::Int64(s.end);
+        arr.append(v);
+    }
+    spans.swap(rest);
+    return arr;
+}
+
+//----------------------------------------------------------------------
+// Method: merge
+// Store the spans of a JSON array, as returned by take
+//----------------------------------------------------------------------
+void Tracer::merge(const json & arr)
+{
+    if (! arr.isArray()) { return; }
+    for (auto & v : arr) {
+        record(v["traceId"].asString(), v["stage"].asString(),
+               v["comp"].asString(),
+               v["start"].asInt64(), v["end"].asInt64());
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: size
+// Number of spans stored
+//----------------------------------------------------------------------
+size_t Tracer::size()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return spans.size();
+}
+
+//----------------------------------------------------------------------
+// Method: clear
+// Remove all the spans
+//----------------------------------------------------------------------
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    spans.clear();
+}
+
+//----------------------------------------------------------------------
+// Method: toChromeTrace
+// Return the spans as a Chrome trace-event JSON document
+//----------------------------------------------------------------------
+std::string Tracer::toChromeTrace()
+{
+    json events(Json::arrayValue);
+    std::map<std::string, int> rows;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto & s : spans) {
+        auto it = rows.find(s.traceId);
+        if (it == rows.end()) {
+            // Name the row of each trace after its id
+            it = rows.insert(std::make_pair(s.traceId, int(rows.size()) + 1)).first;
+            json meta;
+            meta["name"]         = "thread_name";
+            meta["ph"]           = "M";
+            meta["pid"]          = 1;
+            meta["tid"]          = it->second;
+            meta["args"]["name"] = s.traceId;
+            events.append(meta);
+        }
+        json ev;
+        ev["name"]            = s.stage;
+        ev["cat"]             = s.comp;
+        ev["ph"]              = "X";
+        ev["ts"]              = Json::Int64(s.start);
+        ev["dur"]             = Json::Int64(s.end - s.start);
+        ev["pid"]             = 1;
+        ev["tid"]             = it->second;
+        ev["args"]["traceId"] = s.traceId;
+        events.append(ev);
+    }
+
+    json doc;
+    doc["traceEvents"]     = events;
+    doc["displayTimeUnit"] = "ms";
+    Json::FastWriter w;
+    return w.write(doc);
+}
+
+//----------------------------------------------------------------------
+// Method: exportChromeTrace
+// Write the spans as a Chrome trace-event JSON file
+//----------------------------------------------------------------------
+bool Tracer::exportChromeTrace(const std::string & fileName)
+{
+    std::ofstream f(fileName);
+    if (! f.good()) { return false; }
+    f << toChromeTrace();
+    return f.good();
+}
+
+//----------------------------------------------------------------------
+// Method: push
+// Store a span, discarding the oldest if the store is full
+//----------------------------------------------------------------------
+void Tracer::push(Span && s)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (spans.size() >= TRACE_MAX_SPANS) { spans.pop_front(); }
+    spans.push_back(std::move(s));
+}
+
+//}
@@ -0,0 +1,210 @@
+/******************************************************************************
+ * File:    tracer.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.libQPF.Tracer
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declare Tracer class
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+//============================================================
+// Group: External Dependencies
+//============================================================
+
+//------------------------------------------------------------
+// Topic: System headers
+//   - string
+//   - deque
+//   - mutex
+//   - cstdint
+//------------------------------------------------------------
+#include <string>
+#include <deque>
+#include <mutex>
+#include <cstdint>
+
+//------------------------------------------------------------
+// Topic: External packages
+//   none
+//------------------------------------------------------------
+
+//------------------------------------------------------------
+// Topic: Project headers
+//   - datatypes.h
+//------------------------------------------------------------
+#include "datatypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Namespace: QPF
+// -----------------------
+//
+// Library namespace
+////////////////////////////////////////////////////////////////////////////
+//namespace QPF {
+
+//==========================================================================
+// Class: Tracer
+// Per-process store of the spans of the product traces.  A trace id is
+// assigned to each product when it is found in the inbox, and carried
+// by the product metadata, the tasks created for it, their output
+// products and the headers of the task messages.  Each stage records
+// a span (stage name, component, start and end in microseconds since
+// the epoch) under that id.  The spans recorded by the task agents are
+// sent back with the final task report and merged into the store of the
+// master process, that exports them in Chrome trace-event format
+//==========================================================================
+class Tracer {
+
+public:
+    struct Span {
+        std::string traceId;
+        std::string stage;
+        std::string comp;
+        int64_t     start;
+        int64_t     end;
+    };
+
+    //----------------------------------------------------------------------
+    // Method: instance
+    // Return the tracer of the process
+    //----------------------------------------------------------------------
+    static Tracer & instance();
+
+    //----------------------------------------------------------------------
+    // Method: newTraceId
+    // Create a new trace id
+    //----------------------------------------------------------------------
+    static std::string newTraceId();
+
+    //----------------------------------------------------------------------
+    // Method: now
+    // Current time, in microseconds since the epoch
+    //----------------------------------------------------------------------
+    static int64_t now();
+
+    //----------------------------------------------------------------------
+    // Method: mark
+    // Store the current time in the record, as start of the next span
+    //----------------------------------------------------------------------
+    static void mark(json & v);
+
+    //----------------------------------------------------------------------
+    // Method: record
+    // Store a span of a trace (ignored if the trace id is empty)
+    //----------------------------------------------------------------------
+    void record(const std::string & traceId, const std::string & stage,
+                const std::string & comp, int64_t start, int64_t end);
+
+    //----------------------------------------------------------------------
+    // Method: recordSinceMark
+    // Store a span of the trace of the record, from its mark until now,
+    // and mark the record again
+    //----------------------------------------------------------------------
+    void recordSinceMark(json & v, const std::string & stage,
+                         const std::string & comp);
+
+    //----------------------------------------------------------------------
+    // Method: take
+    // Remove the spans of a trace from the store, and return them as a
+    // JSON array
+    //----------------------------------------------------------------------
+    json take(const std::string & traceId);
+
+    //----------------------------------------------------------------------
+    // Method: merge
+    // Store the spans of a JSON array, as returned by take
+    //----------------------------------------------------------------------
+    void merge(const json & spans);
+
+    //----------------------------------------------------------------------
+    // Method: size
+    // Number of spans stored
+    //----------------------------------------------------------------------
+    size_t size();
+
+    //----------------------------------------------------------------------
+    // Method: clear
+    // Remove all the spans
+    //----------------------------------------------------------------------
+    void clear();
+
+    //----------------------------------------------------------------------
+    // Method: toChromeTrace
+    // Return the spans as a Chrome trace-event JSON document, with one
+    // row (thread) per trace
+    //----------------------------------------------------------------------
+    std::string toChromeTrace();
+
+    //----------------------------------------------------------------------
+    // Method: exportChromeTrace
+    // Write the spans as a Chrome trace-event JSON file
+    //----------------------------------------------------------------------
+    bool exportChromeTrace(const std::string & fileName);
+
+    //----------------------------------------------------------------------
+    // Class: Scope
+    // Record a span from construction to destruction
+    //----------------------------------------------------------------------
+    class Scope {
+    public:
+        Scope(const std::string & traceId, const std::string & stage,
+              const std::string & comp)
+            : id(traceId), stg(stage), cmp(comp), start(Tracer::now()) {}
+        ~Scope() { Tracer::instance().record(id, stg, cmp, start, Tracer::now()); }
+    private:
+        std::string id;
+        std::string stg;
+        std::string cmp;
+        int64_t     start;
+    };
+
+private:
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    Tracer() {}
+
+    void push(Span && s);
+
+private:
+    std::deque<Span> spans;
+    std::mutex       mtx;
+};
+
+//}
+
+#endif // TRACER_H
@@ -47,12 +47,13 @@
 #include "str.h"
 
 #include <dirent.h>
+#include <algorithm>
 
 #include "cntrmng.h"
 #include "srvmng.h"
 #include "filenamespec.h"
-#include "timer.h"
 #include "filetools.h"
+#include "tracer.h"
 using namespace FileTools;
 
 #include "config.h"
@@ -83,7 +84,9 @@ TskAge::TskAge(const char * name, const char * addr, Synchronizer * s,
                AgentMode mode, const std::vector<std::string> & nds,
                ServiceInfo * srvInfo)
     : Component(name, addr, s), remote(true), agentMode(mode), nodes(nds),
-      pStatus(IDLE), serviceInfo(srvInfo)
+      pStatus(IDLE), serviceInfo(srvInfo),
+      tskProcChnl(ChannelRegistry::InvalidChannel),
+      tskRepChnl(ChannelRegistry::InvalidChannel), pushDispatch(false)
 {
 }
 
@@ -94,7 +97,9 @@ TskAge::TskAge(std::string name, std::string addr, Synchronizer * s,
                AgentMode mode, const std::vector<std::string> & nds,
                ServiceInfo * srvInfo)
     : Component(name, addr, s), remote(true), agentMode(mode), nodes(nds),
-      pStatus(IDLE), serviceInfo(srvInfo)
+      pStatus(IDLE), serviceInfo(srvInfo),
+      tskProcChnl(ChannelRegistry::InvalidChannel),
+      tskRepChnl(ChannelRegistry::InvalidChannel), pushDispatch(false)
 {
 }
 
@@ -103,6 +108,11 @@ TskAge::TskAge(std::string name, std::string addr, Synchronizer * s,
 //----------------------------------------------------------------------
 void TskAge::fromRunningToOperational()
 {
+    // Channels to talk to the Task Manager, resolved once: task
+    // requests go through the first one, reports through the second
+    tskProcChnl = ChannelRegistry::find(ChnlTskProc + "_" + compName);
+    tskRepChnl  = ChannelRegistry::find(ChnlTskRep);
+
     if (agentMode == CONTAINER) {
 
         // Create Container Manager
@@ -113,6 +123,10 @@ void TskAge::fromRunningToOperational()
         maxWaitingCycles        = MAX_WAITING_CYCLES;
         idleCyclesBeforeRequest = IDLE_CYCLES_BEFORE_REQUEST;
 
+        // Free slots are advertised as soon as the agent is idle, and
+        // the Task Manager pushes the tasks
+        pushDispatch = cfg.flags.pushTaskDispatch();
+
         TraceMsg("Agent Mode: CONTAINER");
 
     } else {
@@ -138,20 +152,20 @@ void TskAge::fromRunningToOperational()
 
     isTaskRequestActive = true;
 
-    prevTaskStatus = TASK_UNKNOWN_STATE;
-    prevProgress = -1;
-    prevInspStatus = "";
-    prevInspCode = -127;
-
-    agStatus = TASK_RUNNING;
-    
     // Get initial values for Host Info structure
     hostInfo.hostIp = compAddress;
     hostInfo.cpuInfo.overallCpuLoad.timeInterval = 0;
     hostInfo.update();
     hostInfo.cpuInfo.overallCpuLoad.timeInterval = 10;
 
-    armHostInfoTimer();
+    // Slots for concurrent tasks
+    if (agentMode == CONTAINER) {
+        slots.resize(numberOfSlots());
+        TraceMsg("Agent runs up to " + std::to_string(slots.size()) + " tasks");
+    }
+
+    // Host info updates are sent periodically, from the component thread
+    startTimer(HOST_INFO_TIMER, [this]() { sendHostInfoUpdate(); }, HOST_INFO_TIMER);
 
     transitTo(OPERATIONAL);
     InfoMsg("New state: " + getStateName(getState()));
@@ -178,33 +192,28 @@ void TskAge::runEachIterationForContainers()
     DbgMsg("Status is " + ProcStatusName[pStatus] +
            " at iteration " + str::toStr<int>(iteration));
 
+    // Update status for running containers (the reports may free the
+    // slots, so the container ids are taken first)
+    std::vector<std::string> running;
+    for (auto & slot : slots) {
+        if (slot.task != 0) { running.push_back(slot.contId); }
+    }
+    for (auto & contId : running) { sendTaskReport(contId); }
+
     // Upon status, perform the required action
     switch (pStatus) {
     case IDLE:
         ++idleCycles;
         // Request task for processing in case the agent is idle
-        if (isTaskRequestActive) {
-            if (idleCycles > idleCyclesBeforeRequest) {
-                // Create message and send
-                Message<MsgBodyTSK> msg;
-                msg.buildHdr(ChnlTskProc, MsgTskRqst, CHNLS_IF_VERSION,
-                             compName, "TskMng",
-                             "", "", "");
-                
-                std::string chnl(ChnlTskProc + "_" + compName);
-                pStatus = WAITING;
-                InfoMsg("Switching to status " + ProcStatusName[pStatus]);
-                waitingCycles = 0;
-                send(chnl, msg.str());
-
-                DBG("Sending request via channel " + chnl);
-                DbgMsg("Sending request via channel " + chnl);
-            }
+        if (pushDispatch || (idleCycles > idleCyclesBeforeRequest)) {
+            requestTask();
         }
         break;
     case WAITING:
         ++waitingCycles;
-        if (waitingCycles > maxWaitingCycles) {
+        // In push mode the Task Manager keeps the request until it has
+        // a task for the agent: a new one would cancel it
+        if ((! pushDispatch) && (waitingCycles > maxWaitingCycles)) {
             pStatus = IDLE;
             InfoMsg("Switching back to status " + ProcStatusName[pStatus]);
             idleCycles = 0;
@@ -220,13 +229,66 @@ void TskAge::runEachIterationForContainers()
     default:
         break;
     }
+}
+
+//----------------------------------------------------------------------
+// Method: numberOfSlots
+// Configured number of slots, or the number of cores of the host
+// shared among its agents
+//----------------------------------------------------------------------
+int TskAge::numberOfSlots()
+{
+    int n = cfg.network.agentSlots();
+    if (n > 0) { return n; }
+
+    int agentsInHost = 1;
+    std::map<std::string, int> procNodes = cfg.network.processingNodes();
+    auto it = procNodes.find(compAddress);
+    if ((it != procNodes.end()) && (it->second > 0)) { agentsInHost = it->second; }
+
+    n = int(hostInfo.cpuInfo.numCpus) / agentsInHost;
+    return (n > 0) ? n : 1;
+}
 
-    // Update status for running containers
-    for (auto const & kv : containerEpoch) {
-        std::string contId = kv.first;
-        sendTaskReport(contId);
+//----------------------------------------------------------------------
+// Method: freeSlots
+//----------------------------------------------------------------------
+int TskAge::freeSlots()
+{
+    int n = 0;
+    for (auto & s : slots) {
+        if (s.task == 0) { ++n; }
+    }
+    return n;
+}
+
+//----------------------------------------------------------------------
+// Method: requestTask
+// Ask the Task Manager for a task.  The request carries the free slots
+// of the agent, and the number of tasks received so far
+//----------------------------------------------------------------------
+void TskAge::requestTask()
+{
+    if (! isTaskRequestActive) { return; }
+
+    // Create message and send
+    Message<MsgBodyTSK> msg;
+    msg.buildHdr(ChnlTskProc, MsgTskRqst, CHNLS_IF_VERSION,
+                 compName, "TskMng",
+                 "", "", "");
+    MsgBodyTSK body;
+    body["credits"]  = freeSlots();
+    body["received"] = numTask;
+    msg.buildBody(body);
+
+    if (pStatus != WAITING) {
+        pStatus = WAITING;
+        InfoMsg("Switching to status " + ProcStatusName[pStatus]);
     }
+    waitingCycles = 0;
+    send(tskProcChnl, msg);
 
+    DbgMsg("Sending task request to TskMng");
 }
 
 //----------------------------------------------------------------------
@@ -243,27 +305,29 @@ void TskAge::runEachIterationForServices()
     }
 }
 
-//----------------------------------------------------------------------
-// Method: armHostInfoTimer
-// Arm new timer for sending HostInfo updates
-//----------------------------------------------------------------------
-void TskAge::armHostInfoTimer()
-{
-    Timer * hstnfoSender = new Timer(HOST_INFO_TIMER, true,
-                                     &TskAge::sendHostInfoUpdate, this);
-}
-
 //----------------------------------------------------------------------
 // Method: processTskProcMsg
 //----------------------------------------------------------------------
-void TskAge::processTskProcMsg(ScalabilityProtocolRole* c, MessageString & m)
+void TskAge::processTskProcMsg(ScalabilityProtocolRole* c, MessageBase & m)
 {
-    Message<MsgBodyTSK> msg(m);
+    Message<MsgBodyTSK> msg(std::move(m));
 
     // Return if not recipient
     if (msg.header.target() != compName) { return; }
 
-    if ((pStatus != WAITING) && (pStatus != IDLE)) { return; }
+    // Take a free slot
+    Slot * slotPtr = 0;
+    for (auto & s : slots) {
+        if (s.task == 0) { slotPtr = &s; break; }
+    }
+    if (slotPtr == 0) {
+        WarnMsg("Task received with no free slot, ignored");
+        // The task is sent again upon the next request, once a slot
+        // is free
+        pStatus = PROCESSING;
+        return;
+    }
+    Slot & slot = *slotPtr;
 
     // Define and set task object
     MsgBodyTSK & body = msg.body;
@@ -272,6 +336,7 @@ void TskAge::processTskProcMsg(ScalabilityProtocolRole* c, MessageString & m)
 
     task["taskHost"]  = compAddress;
     task["taskAgent"] = compName;
+    Tracer::mark(task.val());
 
     assert(compName == msg.header.target());
     DBG(">>>>>>>>>> " << compName
@@ -290,57 +355,72 @@ void TskAge::processTskProcMsg(ScalabilityProtocolRole* c, MessageString & m)
     }
 
     //---- Create exchange area
-    internalTaskNameIdx = (compName + "-" + timeTag() + "-" +
-                           std::to_string(numTask));
+    slot.internalTaskNameIdx = (compName + "-" + timeTag() + "-" +
+                                std::to_string(numTask));
 
-    exchangeDir = workDir + "/" + internalTaskNameIdx;
-    exchgIn     = exchangeDir + "/in";
-    exchgOut    = exchangeDir + "/out";
-    exchgLog    = exchangeDir + "/log";
+    slot.exchangeDir = workDir + "/" + slot.internalTaskNameIdx;
+    slot.exchgIn     = slot.exchangeDir + "/in";
+    slot.exchgOut    = slot.exchangeDir + "/out";
+    slot.exchgLog    = slot.exchangeDir + "/log";
 
-    mkdir(exchangeDir.c_str(), Config::PATHMode);
-    mkdir(exchgIn.c_str(),     Config::PATHMode);
-    mkdir(exchgOut.c_str(),    Config::PATHMode);
-    mkdir(exchgLog.c_str(),    Config::PATHMode);
+    mkdir(slot.exchangeDir.c_str(), Config::PATHMode);
+    mkdir(slot.exchgIn.c_str(),     Config::PATHMode);
+    mkdir(slot.exchgOut.c_str(),    Config::PATHMode);
+    mkdir(slot.exchgLog.c_str(),    Config::PATHMode);
 
     //---- Retrieve the input products
-    urlh.setProcElemRunDir(workDir, internalTaskNameIdx);
+    URLHandler & urlh = slot.urlh;
+    urlh.setProcElemRunDir(workDir, slot.internalTaskNameIdx);
     if (remote) {
         urlh.setRemoteCopyParams(cfg.network.masterNode(), compAddress);
+        urlh.setLocalCache(localCacheDir());
     }
 
     int i = 0;
     for (auto & m : task.inputs.products) {
         urlh.setProduct(m);
         ProductMetadata & mg = urlh.fromGateway2Processing();
+        if (urlh.inLocalCache()) {
+            task["cachedProducts"].append(mg.productId());
+        }
         task.inputs.products.push_back(mg);
         task["inputs"][i] = mg.val();
         ++i;
     }
+    Tracer::instance().recordSinceMark(task.val(), "inputs.fetch", compName);
 
     //----  * * * LAUNCH TASK * * *
     std::string contId;
     std::string procName(task.taskPath());
     std::string sourceProcCfgFile = (Config::PATHProcs + "/" +
                                      procName + "/sample.cfg.json");
-    std::string targetProcCfgFile = exchangeDir + "/" + procName + ".cfg";
+    std::string targetProcCfgFile = slot.exchangeDir + "/" + procName + ".cfg";
     copyfile(sourceProcCfgFile, targetProcCfgFile);
     TRC("Copying " + sourceProcCfgFile + " to " + targetProcCfgFile);
-    if (dckMng->createContainer(procName, exchangeDir, contId)) {
+    if (dckMng->createContainer(procName, slot.exchangeDir, contId)) {
         InfoMsg("Running task " + task.taskName() +
                 " (" + task.taskPath() + ") within container " + contId);
-        origMsgString = m;
+        Tracer::instance().recordSinceMark(task.val(), "container.start", compName);
 
         // Save container info
+        slot.task    = runningTask;
+        slot.contId  = contId;
+        slot.origMsg = msg.val();
         containerToTaskMap[contId]  = runningTask;
         containerEpoch[contId]      = time(0);
         
         usleep(50000); // 50 ms
 
-        // Set processing status
-        pStatus = PROCESSING;
-        workingDuring = 0;
-        resetProgress();            
+        // Set processing status: with free slots left, the agent keeps
+        // asking for tasks (in push mode, at the next iteration)
+        if (freeSlots() == 0) {
+            pStatus = PROCESSING;
+        } else {
+            pStatus = IDLE;
+            idleCycles = 0;
+        }
+        slot.workingDuring = 0;
+        resetProgress(slot);
     } else {
         WarnMsg("Couldn't execute docker container");
         
@@ -355,11 +435,11 @@ void TskAge::processTskProcMsg(ScalabilityProtocolRole* c, MessageString & m)
 //----------------------------------------------------------------------
 // Method: processSubcmdMsg
 //----------------------------------------------------------------------
-void TskAge::processSubcmdMsg(MessageString & m)
+void TskAge::processSubcmdMsg(MessageBase & m)
 {
-    TRC("Sub-command message received: " + m);
+    TRC("Sub-command message received: " + m.str());
 
-    Message<MsgBodyTSK> msg(m);
+    Message<MsgBodyTSK> msg(std::move(m));
 
     std::string subCmd   = msg.body["subcmd"].asString();
     SubjectId   subj     = (SubjectId)(msg.body["target_type"].asInt());
@@ -438,26 +518,35 @@ void TskAge::applyActionOnContainer(std::string & act, std::string & contId,
 {
     std::vector<std::string> noargs;
 
-    switch (agStatus) {
+    // Each container keeps its own status, in its slot
+    Slot * slotPtr = 0;
+    for (auto & s : slots) {
+        if ((s.task != 0) && (s.contId == contId)) { slotPtr = &s; break; }
+    }
+
+    TaskStatus noStatus = TASK_UNKNOWN_STATE;
+    TaskStatus & status = (slotPtr != 0) ? slotPtr->status : noStatus;
+
+    switch (status) {
     case TASK_RUNNING:
         if ((act == "PAUSE") || (act == "SUSPEND")) {
             dckMng->runCmd("pause",   noargs, contId);
-            agStatus = TASK_PAUSED;
+            status = TASK_PAUSED;
         } else if ((act == "CANCEL") || (act == "STOP")) {
             dckMng->runCmd("stop",    noargs, contId);
-            agStatus = (act == "STOP") ? TASK_STOPPED : TASK_PAUSED;
+            status = (act == "STOP") ? TASK_STOPPED : TASK_PAUSED;
         }
         break;
     case TASK_PAUSED:
         if ((act == "RESUME") || (act == "REACTIVATE")) {
             dckMng->runCmd("unpause", noargs, contId);
-            agStatus = TASK_RUNNING;
+            status = TASK_RUNNING;
         }
         break;
     case TASK_STOPPED:
         if ((act == "RESUME") || (act == "REACTIVATE")) {
             dckMng->runCmd("restart", noargs, contId);
-            agStatus = TASK_RUNNING;
+            status = TASK_RUNNING;
         }
         break;
     default:
@@ -481,6 +570,14 @@ void TskAge::sendTaskReport(std::string contId)
     if ((task.taskStatus() == TASK_FAILED) ||
         (task.taskStatus() == TASK_FINISHED)) { return; }
 
+    // Only the containers running in a slot are monitored
+    Slot * slotPtr = 0;
+    for (auto & s : slots) {
+        if ((s.task != 0) && (s.contId == contId)) { slotPtr = &s; break; }
+    }
+    if (slotPtr == 0) { return; }
+    Slot & slot = *slotPtr;
+
     // Get updated Docker info
     json taskData = retrieveDockerInfo(contId, false);
 
@@ -494,27 +591,27 @@ void TskAge::sendTaskReport(std::string contId)
     if (taskHasEnded) {
         InfoMsg("Task container monitoring finished");
         if (taskStatus == TASK_FINISHED) { 
-            endProgress(); 
+            endProgress(slot);
         }
         taskData = retrieveDockerInfo(contId, true);
     } else {
-        workingDuring++;
-        updateProgress();
+        slot.workingDuring++;
+        updateProgress(slot);
     }
 
     // Avoid unnecessary messages
-    if ((taskStatus == prevTaskStatus) && 
-        (progress   == prevProgress) &&
-        (inspStatus == prevInspStatus) &&
-        (inspCode   == prevInspCode)) { return; }
+    if ((taskStatus    == slot.prevTaskStatus) &&
+        (slot.progress == slot.prevProgress) &&
+        (inspStatus    == slot.prevInspStatus) &&
+        (inspCode      == slot.prevInspCode)) { return; }
     
-    prevTaskStatus = taskStatus; 
-    prevProgress   = progress; 
-    prevInspStatus = inspStatus; 
-    prevInspCode   = inspCode;
+    slot.prevTaskStatus = taskStatus;
+    slot.prevProgress   = slot.progress;
+    slot.prevInspStatus = inspStatus;
+    slot.prevInspCode   = inspCode;
 
     // Update progress
-    taskData["State"]["Progress"] = std::to_string(progress);
+    taskData["State"]["Progress"] = std::to_string(slot.progress);
 
     // Put declared status in task info structure...
     // ... and add it as well to the taskData JSON structure
@@ -539,26 +636,39 @@ void TskAge::sendTaskReport(std::string contId)
     if ((taskStatus == TASK_FINISHED) ||
         (taskStatus == TASK_FAILED) ||
         (taskStatus == TASK_STOPPED)) {
-        transferOutputProducts(task);
+        Tracer & tracer = Tracer::instance();
+        tracer.recordSinceMark(task.val(), "container.run", compName);
+        transferOutputProducts(slot, task);
+        tracer.recordSinceMark(task.val(), "outputs.transfer", compName);
+        // The spans of the task go back to the master with the report
+        task["traceSpans"] = tracer.take(task.traceId());
         taskHasEnded = true;
     }
 
-    sendBodyElem<MsgBodyTSK>(ChnlTskProc,
-                             ChnlTskProc + "_" + compName, MsgTskRep,
+    sendBodyElem<MsgBodyTSK>(ChnlTskRep,
+                             tskRepChnl, MsgTskRep,
                              compName, "TskMng",
                              "info", task.str(),
-                             origMsgString);
+                             slot.origMsg);
 
     if (taskHasEnded) {
-        pStatus = FINISHING;
-        InfoMsg("Switching to status " + ProcStatusName[pStatus]);
-    }
-
-    if (taskStatus == TASK_FINISHED) {
-        containerToTaskMap.erase(containerToTaskMap.find(contId));
-        containerEpoch.erase(containerEpoch.find(contId));
+        slot.release();
+        if (pushDispatch) {
+            // The slot is free again: no need to wait for the next
+            // cycles, unless a request is already waiting for a task
+            if (pStatus != WAITING) {
+                pStatus = IDLE;
+                idleCycles = 0;
+            }
+        } else if (pStatus == PROCESSING) {
+            pStatus = FINISHING;
+            InfoMsg("Switching to status " + ProcStatusName[pStatus]);
+        }
+        // The task is forgotten once it ends, whatever its final status
+        containerToTaskMap.erase(contId);
+        containerEpoch.erase(contId);
+        delete &task;
     }
-    
 }
 
 //----------------------------------------------------------------------
@@ -620,7 +730,7 @@ json TskAge::retrieveDockerInfo(std::string & contId, bool fullInfo)
 //----------------------------------------------------------------------
 // Method: transferOutputProducts
 //----------------------------------------------------------------------
-void TskAge::transferOutputProducts(TaskInfo & task)
+void TskAge::transferOutputProducts(Slot & slot, TaskInfo & task)
 {
     DBG("Transferring output products for task: " << task.taskName());
 
@@ -630,7 +740,7 @@ void TskAge::transferOutputProducts(TaskInfo & task)
     std::vector<std::string> outFiles;
     DIR * dp = NULL;
     struct dirent * dirp;
-    for (auto & vd : {exchgOut, exchgLog}) {
+    for (auto & vd : {slot.exchgOut, slot.exchgLog}) {
         if ((dp = opendir(vd.c_str())) == NULL) {
             WarnMsg("Cannot open output directory " + vd);
         } else {
@@ -658,14 +768,65 @@ void TskAge::transferOutputProducts(TaskInfo & task)
             // Place output product at external (output) shared area
             m["procTargetType"] = imd["procTargetType"];
             m["procTarget"]     = imd["procTarget"];
-            urlh.setProduct(m);
-            m = urlh.fromProcessing2Gateway();
+            m["traceId"]        = task.traceId();
+            slot.urlh.setProduct(m);
+            m = slot.urlh.fromProcessing2Gateway();
+            if (slot.urlh.inLocalCache()) {
+                task["cachedProducts"].append(m.productId());
+            }
         } else {
             continue;
         }
         task.outputs.products.push_back(m);
         task["outputs"][i] = m.val();
     }
+
+    trimLocalCache();
+}
+
+//----------------------------------------------------------------------
+// Method: localCacheDir
+// Folder where the products transferred to and from the host are kept
+// for later tasks.  It is shared by the agents of the host
+//----------------------------------------------------------------------
+std::string TskAge::localCacheDir()
+{
+    if (cfg.orchestration.localCacheSize() <= 0) { return std::string(); }
+    std::string cacheDir(workDir + "/cache");
+    mkdir(cacheDir.c_str(), Config::PATHMode);
+    return cacheDir;
+}
+
+//----------------------------------------------------------------------
+// Method: trimLocalCache
+// Remove the least recently used products above the cache size.  Each
+// use of a product links it again, which updates its change time
+//----------------------------------------------------------------------
+void TskAge::trimLocalCache()
+{
+    std::string cacheDir(remote ? localCacheDir() : std::string());
+    if (cacheDir.empty()) { return; }
+
+    std::vector<std::pair<time_t, std::string>> files;
+    DIR * dp = opendir(cacheDir.c_str());
+    if (dp == NULL) { return; }
+    struct dirent * dirp;
+    struct stat st;
+    while ((dirp = readdir(dp)) != NULL) {
+        if (dirp->d_name[0] == '.') { continue; }
+        std::string file(cacheDir + "/" + dirp->d_name);
+        if (stat(file.c_str(), &st) == 0) {
+            files.push_back(std::make_pair(st.st_ctime, file));
+        }
+    }
+    closedir(dp);
+
+    size_t cacheSize = cfg.orchestration.localCacheSize();
+    if (files.size() <= cacheSize) { return; }
+    std::sort(files.begin(), files.end());
+    for (size_t k = 0; k < files.size() - cacheSize; ++k) {
+        unlink(files[k].second.c_str());
+    }
 }
 
 //----------------------------------------------------------------------
@@ -676,79 +837,77 @@ void TskAge::sendHostInfoUpdate()
     // Update host information
     hostInfo.update();
 
-    sendBodyElem<MsgBodyTSK>(ChnlTskProc,
-                             ChnlTskProc + "_" + compName, MsgHostMon,
+    sendBodyElem<MsgBodyTSK>(ChnlTskRep,
+                             tskRepChnl, MsgHostMon,
                              compName, "TskMng",
-                             "info", hostInfo.toJsonStr(), "");
-
-    armHostInfoTimer();
+                             "info", hostInfo.toJsonStr(), json());
 }
 
 //----------------------------------------------------------------------
 // Method: resetProgress
 //----------------------------------------------------------------------
-void TskAge::resetProgress()
+void TskAge::resetProgress(Slot & slot)
 {
     // Initialize progress and log related variables
-    progress = 0;
-    isLogFileOpen = false;
+    slot.progress = 0;
+    slot.isLogFileOpen = false;
 }
 
 //----------------------------------------------------------------------
 // Method: updateProgress
 //----------------------------------------------------------------------
-void TskAge::updateProgress()
+void TskAge::updateProgress(Slot & slot)
 {
     // First, check that file exists and is open
-    if (! isLogFileOpen) {
-        logFilePos = 0;
-        logDir = exchangeDir + "/log";
-        logFile = "";
+    if (! slot.isLogFileOpen) {
+        slot.logFilePos = 0;
+        slot.logDir = slot.exchangeDir + "/log";
+        slot.logFile = "";
         
         // Look for log file in <exchangeDirr>/log
-        while (logFile.empty()) {
+        while (slot.logFile.empty()) {
             DIR * dp = NULL;
             struct dirent * dirp;
-            if ((dp = opendir(logDir.c_str())) == NULL) {
-                WarnMsg("Cannot open log directory " + logDir);
+            if ((dp = opendir(slot.logDir.c_str())) == NULL) {
+                WarnMsg("Cannot open log directory " + slot.logDir);
             } else {
                 while ((dirp = readdir(dp)) != NULL) {
                     if (dirp->d_name[0] != '.') {
                         std::string dname(dirp->d_name);
                         //if (dname.substr(0, 3) != "EUC") { continue; }
-                        logFile = logDir + "/" + dname;
+                        slot.logFile = slot.logDir + "/" + dname;
                     }
                 }
                 closedir(dp);
             }
         }
         // Open log file
-        if (! logFile.empty()) {
-            logFileHdl.open(logFile);
-            isLogFileOpen = true;
+        if (! slot.logFile.empty()) {
+            slot.logFileHdl.open(slot.logFile);
+            slot.isLogFileOpen = true;
         }
     }
 
-    if (! isLogFileOpen) { return; }
+    if (! slot.isLogFileOpen) { return; }
     
     // See if new content can be obtained from the log file
-    logFileHdl.seekg(0, logFileHdl.end);
-    int length = logFileHdl.tellg();
+    slot.logFileHdl.seekg(0, slot.logFileHdl.end);
+    int length = slot.logFileHdl.tellg();
     
     const std::string ProgressTag(cfg.flags.progressString());
     
     // If new content is there, read it and process it
-    if (length > logFilePos) {
-        logFileHdl.seekg(logFilePos, logFileHdl.beg);
+    if (length > slot.logFilePos) {
+        slot.logFileHdl.seekg(slot.logFilePos, slot.logFileHdl.beg);
 
         std::string line;
-        while (! logFileHdl.eof()) {
+        while (! slot.logFileHdl.eof()) {
             // Get line, look for progress mark, and parse it
             // It is assumed that  progress is shown as follows:
             // .....:PROGRESS:... XXX%
             // where XXX is a float number representing the percentage
             // of progress, and that no other % appears in the line
-            std::getline(logFileHdl, line);
+            std::getline(slot.logFileHdl, line);
             if (line.length() < 1) { break; }
             size_t progressTagPos = line.find(ProgressTag);
                       
@@ -761,25 +920,25 @@ void TskAge::updateProgress()
                         std::string percentage =
                             line.substr(porcBeginsAt + 1,
                                         porcEndsAt - porcBeginsAt);
-                        progress = (int)floor(std::stof(percentage));
+                        slot.progress = (int)floor(std::stof(percentage));
                     }
                 }
             }
         }
         
-        logFileHdl.clear();
-        logFilePos = length;
+        slot.logFileHdl.clear();
+        slot.logFilePos = length;
     }
 }
 
 //----------------------------------------------------------------------
 // Method: endProgress
 //----------------------------------------------------------------------
-void TskAge::endProgress()
+void TskAge::endProgress(Slot & slot)
 {
-    progress = 100;
-    logFileHdl.close();
-    isLogFileOpen = false;
+    slot.progress = 100;
+    slot.logFileHdl.close();
+    slot.isLogFileOpen = false;
 }
 
 //}
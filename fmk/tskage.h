@@ -131,12 +131,12 @@ protected:
     //----------------------------------------------------------------------
     // Method: processTskProcMsg
     //----------------------------------------------------------------------
-    virtual void processTskProcMsg(ScalabilityProtocolRole* c, MessageString & m);
+    virtual void processTskProcMsg(ScalabilityProtocolRole* c, MessageBase & m);
 
     //----------------------------------------------------------------------
     // Method: processSubcmdMsg
     //----------------------------------------------------------------------
-    virtual void processSubcmdMsg(MessageString & m);
+    virtual void processSubcmdMsg(MessageBase & m);
 
 private:
     //----------------------------------------------------------------------
@@ -149,17 +149,81 @@ private:
     //----------------------------------------------------------------------
     void runEachIterationForServices();
 
+    //----------------------------------------------------------------------
+    // Struct: Slot
+    // Context of a task run by the agent: each slot runs a container
+    //----------------------------------------------------------------------
+    struct Slot {
+        Slot() : task(0), isLogFileOpen(false), logFilePos(0),
+                 workingDuring(0), progress(0) { release(); }
+        void release() {
+            task = 0;
+            contId.clear();
+            if (isLogFileOpen) { logFileHdl.close(); }
+            isLogFileOpen  = false;
+            prevTaskStatus = TASK_UNKNOWN_STATE;
+            prevProgress   = -1;
+            prevInspStatus = "";
+            prevInspCode   = -127;
+            status         = TASK_RUNNING;
+        }
+
+        TaskInfo *    task;
+        std::string   contId;
+        json          origMsg;
+
+        std::string   internalTaskNameIdx;
+        std::string   exchangeDir;
+        std::string   exchgIn;
+        std::string   exchgOut;
+        std::string   exchgLog;
+
+        bool          isLogFileOpen;
+        std::ifstream logFileHdl;
+        size_t        logFilePos;
+        std::string   logDir;
+        std::string   logFile;
+
+        int           workingDuring;
+        int           progress;
+
+        TaskStatus    prevTaskStatus;
+        int           prevProgress;
+        std::string   prevInspStatus;
+        int           prevInspCode;
+
+        URLHandler    urlh;
+
+        // Status set by the commands on its container (running, paused
+        // or stopped)
+        TaskStatus    status;
+    };
+
+    //----------------------------------------------------------------------
+    // Method: numberOfSlots
+    // Configured number of slots, or the number of cores of the host
+    // shared among its agents
+    //----------------------------------------------------------------------
+    int numberOfSlots();
+
+    //----------------------------------------------------------------------
+    // Method: freeSlots
+    //----------------------------------------------------------------------
+    int freeSlots();
+
+    //----------------------------------------------------------------------
+    // Method: requestTask
+    // Ask the Task Manager for a task, or advertise the free slots of the
+    // agent when tasks are pushed
+    //----------------------------------------------------------------------
+    void requestTask();
+
     //----------------------------------------------------------------------
     // Method: applyActionOnContainer
     //----------------------------------------------------------------------
     void applyActionOnContainer(std::string & act, std::string & contId,
                                 bool isQuitting = false);
 
-    //----------------------------------------------------------------------
-    // Method: armHostInfoTimer
-    //----------------------------------------------------------------------
-    void armHostInfoTimer();
-    
     //----------------------------------------------------------------------
     // Method: sendTaskReport
     //----------------------------------------------------------------------
@@ -183,7 +247,20 @@ private:
     //----------------------------------------------------------------------
     // Method: transferOutputProducts
     //----------------------------------------------------------------------
-    void transferOutputProducts(TaskInfo & task);
+    void transferOutputProducts(Slot & slot, TaskInfo & task);
+
+    //----------------------------------------------------------------------
+    // Method: localCacheDir
+    // Folder where the products transferred to and from the host are
+    // kept for later tasks (empty if there is no cache)
+    //----------------------------------------------------------------------
+    std::string localCacheDir();
+
+    //----------------------------------------------------------------------
+    // Method: trimLocalCache
+    // Remove the least recently used products above the cache size
+    //----------------------------------------------------------------------
+    void trimLocalCache();
 
     //----------------------------------------------------------------------
     // Method: sendHostInfoUpdate
@@ -193,17 +270,17 @@ private:
     //----------------------------------------------------------------------
     // Method: resetProgress
     //----------------------------------------------------------------------
-    void resetProgress();
+    void resetProgress(Slot & slot);
     
     //----------------------------------------------------------------------
     // Method: updateProgress
     //----------------------------------------------------------------------
-    void updateProgress();
+    void updateProgress(Slot & slot);
     
     //----------------------------------------------------------------------
     // Method: endProgress
     //----------------------------------------------------------------------
-    void endProgress();
+    void endProgress(Slot & slot);
     
     Property(TskAge, std::string, workDir, WorkDir);
     Property(TskAge, std::string, sysDir,  SysDir);
@@ -222,43 +299,24 @@ private:
     std::map<std::string, time_t>    containerEpoch;
     
     TaskStatus               taskStatus;
-    TaskStatus               agStatus;
     
-    std::string              internalTaskNameIdx;
-    std::string              exchangeDir;
-    std::string              exchgIn;
-    std::string              exchgOut;
-    std::string              exchgLog;
+    std::vector<Slot>        slots;
 
     std::string              ruleBasedName;
 
-    bool                     isLogFileOpen;
-    std::ifstream            logFileHdl;
-    size_t                   logFilePos;
-    std::string              logDir;
-    std::string              logFile;
-
-    MessageString            origMsgString;
-
     int                      numTask;
     int                      waitingCycles;
     int                      maxWaitingCycles;
     int                      idleCycles;
     int                      idleCyclesBeforeRequest;
-    int                      workingDuring;
-
-    int                      progress;
 
-    TaskStatus               prevTaskStatus;
-    int                      prevProgress;
-    std::string              prevInspStatus;
-    int                      prevInspCode;
-    
-    URLHandler               urlh;
+    ChannelId                tskProcChnl;
+    ChannelId                tskRepChnl;
 
     HostInfo                 hostInfo;
 
     bool                     isTaskRequestActive;
+    bool                     pushDispatch;
 };
 
 //}
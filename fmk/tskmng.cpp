@@ -43,6 +43,7 @@
 #include <sys/time.h>
 #include <array>
 #include <memory>
+#include <functional>
 
 #include "channels.h"
 #include "str.h"
@@ -50,17 +51,32 @@
 #include "tools.h"
 #include "config.h"
 #include "timer.h"
+#include "tracer.h"
+#include "metrics.h"
 
 using Configuration::cfg;
 
 const int FMK_INFO_TIMER = 5000;
 const int TSK_REP_TIMER  = 3000;
 
+// Default period between full FMKMON updates (s)
+const int FMKMON_KEYFRAME_PERIOD = 30;
+
+// Default waiting time of a task that adds a point to its priority (s)
+const int TASK_AGING_PERIOD = 60;
+
+// Tasks of the pool looked at when searching one for an agent
+const size_t TASK_SCAN_DEPTH = 64;
+
 //----------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------
 TskMng::TskMng(const char * name, const char * addr, Synchronizer * s)
-    : Component(name, addr, s)
+    : Component(name, addr, s),
+      localityWait(0),
+      containerTasks(std::string(name) + ".containerTasks", 0, OverflowQueueBase::Block, 0),
+      pushDispatch(false),
+      tskRegMsgs(std::string(name) + ".tskRegMsgs", 0, OverflowQueueBase::Coalesce)
 {
 }
 
@@ -68,7 +84,11 @@ TskMng::TskMng(const char * name, const char * addr, Synchronizer * s)
 // Constructor
 //----------------------------------------------------------------------
 TskMng::TskMng(std::string name, std::string addr, Synchronizer * s)
-    : Component(name, addr, s)
+    : Component(name, addr, s),
+      localityWait(0),
+      containerTasks(name + ".containerTasks", 0, OverflowQueueBase::Block, 0),
+      pushDispatch(false),
+      tskRegMsgs(name + ".tskRegMsgs", 0, OverflowQueueBase::Coalesce)
 {
 }
 
@@ -84,7 +104,22 @@ void TskMng::fromRunningToOperational()
         emptyInfo.name = a;
         emptyInfo.load = 0.0;
         agentInfo[a] = emptyInfo;
+        agentChnl[a] = ChannelRegistry::find(ChnlTskProc + "_" + a);
     }
+    for (size_t i = 0; i < cfg.agentNames.size() && i < cfg.agHost.size(); ++i) {
+        agentHost[cfg.agentNames[i]] = cfg.agHost[i];
+    }
+
+    // Placement of the tasks in the agents (limits in %)
+    int maxLoad = cfg.orchestration.maxHostLoad();
+    int minMem  = cfg.orchestration.minFreeMemory();
+    placement.configure(AgentPlacement::policyFromName(cfg.orchestration.agentPlacement()),
+                        (maxLoad > 0) ? (maxLoad * 0.01) : 1.5,
+                        (minMem > 0) ? (minMem * 0.01) : 0.05);
+
+    // Tasks prefer the hosts that keep copies of their inputs
+    localityWait = cfg.orchestration.localityWait();
+    productLocs.setCapacity(cfg.orchestration.localCacheSize());
 
     // Initialize Task Status maps
     for (int k = TASK_SCHEDULED; k != TASK_UNKNOWN_STATE; ++k) {
@@ -107,6 +142,15 @@ void TskMng::fromRunningToOperational()
 
     sendingPeriodicFmkInfo = false;
     sendingTskRegInfo      = false;
+    lastFmkInfoKeyframe    = std::chrono::steady_clock::time_point();
+
+    configureQueue(containerTasks, "containerTasks");
+    setTaskClasses();
+    configureQueue(tskRegMsgs,     "tskRegMsgs");
+
+    // Tasks are pushed to the agents with free slots, instead of
+    // waiting for their requests
+    pushDispatch = cfg.flags.pushTaskDispatch();
 
     // Transit to Operational
     transitTo(OPERATIONAL);
@@ -161,15 +205,51 @@ void TskMng::runEachIteration()
         TRC(trace);
         lastTrace = trace;
     }
+
+    // Tasks waiting for the hosts with their inputs, or for hosts less
+    // loaded, may go now to the agents waiting for a task
+    dispatchParkedRequests();
+
+    publishMetrics();
+}
+
+//----------------------------------------------------------------------
+// Method: publishMetrics
+// Update the gauges of task queues and task status counts
+//----------------------------------------------------------------------
+void TskMng::publishMetrics()
+{
+    auto gauge = [this] (const char * name, const char * help,
+                         const std::string & lbl) -> Gauge & {
+        Gauge * & g = metricGauges[std::string(name) + lbl];
+        if (g == 0) { g = &Metrics::instance().gauge(name, help, lbl); }
+        return *g;
+    };
+
+    const char * qName = "qpf_task_queue_length";
+    const char * qHelp = "Tasks waiting to be sent to the agents";
+    gauge(qName, qHelp, Metrics::labels({{"set", "container"}})).set(containerTasks.size());
+    gauge(qName, qHelp, Metrics::labels({{"set", "service"}})).set(serviceTasks.size());
+
+    const char * sName = "qpf_tasks";
+    const char * sHelp = "Tasks per task set and status";
+    for (auto & kv : containerTaskStatus) {
+        gauge(sName, sHelp, Metrics::labels({{"set", "container"},
+                                             {"status", TaskStatusName[kv.first]}})).set(kv.second);
+    }
+    for (auto & kv : serviceTaskStatus) {
+        gauge(sName, sHelp, Metrics::labels({{"set", "service"},
+                                             {"status", TaskStatusName[kv.first]}})).set(kv.second);
+    }
 }
 
 //----------------------------------------------------------------------
 // Method: processTskRqstMsg
 //----------------------------------------------------------------------
-void TskMng::processTskRqstMsg(ScalabilityProtocolRole* c, MessageString & m)
+void TskMng::processTskRqstMsg(ScalabilityProtocolRole* c, MessageBase & m)
 {
     // Define and set task object
-    Message<MsgBodyTSK> msg(m);
+    Message<MsgBodyTSK> msg(std::move(m));
     std::string agName(msg.header.source());
     DBG("TASK REQUEST FROM " << agName << " RECEIVED");
     
@@ -187,61 +267,217 @@ void TskMng::processTskRqstMsg(ScalabilityProtocolRole* c, MessageString & m)
         return;
     }
 
+    std::map<std::string, ChannelId>::iterator ic = agentChnl.find(agName);
+    ChannelId chnl = ((ic != agentChnl.end()) ?
+                      ic->second : ChannelRegistry::InvalidChannel);
+
+    // Each request takes at most one reply.  Agents in push mode
+    // advertise their free slots instead: the request is kept until a
+    // task can be sent in reply (see dispatchParkedRequests), and the
+    // agent asks again as soon as it takes a task with slots left
+    if (pushDispatch && msg.body.val().isMember("credits")) {
+        if (updateCredits(agName, chnl, msg.body)) {
+            keepRequest();
+            parkedAgents.insert(agName);
+            dispatchParkedRequests();
+        }
+        return;
+    }
+
     // Check that no previous message was sent (and the Agent was not
-    // aware of if).  In that case, resend it.
-    std::map<std::string, MessageString>::iterator it = containerTaskLastMessage.find(agName);
-    if (it != containerTaskLastMessage.end()) {
+    // aware of if).  In that case, resend it.  Agents running several
+    // tasks tell how many they got, so that a running task is not
+    // taken as not received
+    std::map<std::string, json>::iterator it = containerTaskLastMessage.find(agName);
+    bool lastReceived = (msg.body.val().isMember("received") &&
+                         (msg.body["received"].asInt() >= agentCredits[agName].sent));
+    if ((it != containerTaskLastMessage.end()) && (! lastReceived)) {
         // There is a message send to this agent.  A new request by
         // this agent without a removal of this last message from the
         // map containerTaskLastMessage means that the message was not
         // noticed by the agent.  Therefore, we resend the same
         // message.
-        MessageString & msgStr = it->second;
-        send(ChnlTskProc + "_" + agName, msgStr);
+        Message<MsgBodyTSK> lastMsg(it->second);
+        send(chnl, lastMsg);
         DBG("Task message resent to " + agName);
         return;
     }
 
-    
-    // Select task to send
+    // The agent takes no task while its host is full
+    if (selectAgent({agName}).empty()) {
+        DBG("Host of " + agName + " is full, no task sent");
+        return;
+    }
+
+    // Take the first task the agent may run
     TraceMsg("Pool of tasks has size of " + std::to_string(containerTasks.size()));
-    if (containerTasks.size() < 1) { return; }        
+    TaskInfo nextTask;
+    double taskWaited = 0.;
+    if (containerTasks.pop(nextTask, [&] (TaskInfo & t, double waited) {
+                taskWaited = waited;
+                return ! placeTask(t, {agName}, waited).empty(); },
+            TASK_SCAN_DEPTH)) {
+        sendTask(agName, chnl, nextTask, taskWaited);
+    }
+}
+
+//----------------------------------------------------------------------
+// Method: setTaskClasses
+// Define the priority classes of the pool of tasks, from the
+// orchestration configuration
+//----------------------------------------------------------------------
+void TskMng::setTaskClasses()
+{
+    std::vector<TaskQueue::Class> classes;
+    for (auto & kv : cfg.orchestration.taskClasses()) {
+        CfgGrpTaskClass & c = kv.second;
+        TaskQueue::Class cls;
+        cls.name         = kv.first;
+        cls.weight       = c.weight();
+        cls.origin       = c.origin();
+        cls.rules        = c.rules();
+        cls.productTypes = c.productTypes();
+        cls.flags        = c.flags();
+        classes.push_back(cls);
+        TraceMsg("Task class " + cls.name + " with weight " +
+                 std::to_string(cls.weight));
+    }
+
+    // Seconds of waiting worth one point of weight
+    int aging = cfg.orchestration.taskAging();
+    containerTasks.setClasses(classes, (aging > 0) ? aging : TASK_AGING_PERIOD);
+}
 
-    json taskInfoData = containerTasks.front().val();
-    containerTasks.pop_front();
+//----------------------------------------------------------------------
+// Method: sendTask
+// Send a task taken from the pool to the agent.  If the message cannot
+// be sent, the task is put back in the pool with the seconds it had
+// been waiting, so that it keeps its age
+//----------------------------------------------------------------------
+bool TskMng::sendTask(const std::string & agName, ChannelId chnl, TaskInfo & nextTask,
+                      double waited)
+{
+    Tracer::instance().recordSinceMark(nextTask.val(), "queue", compName);
+
+    json taskInfoData = nextTask.val();
     
     std::string taskName = agName + "_" + taskInfoData["taskName"].asString();
     taskInfoData["taskName"] = taskName;
     
     // Create message
+    Message<MsgBodyTSK> msg;
     msg.buildHdr(ChnlTskProc, MsgTskProc, CHNLS_IF_VERSION,
                  compName, agName, "", "", "");
+    msg.val()["header"]["traceId"] = nextTask.traceId();
     MsgBodyTSK body;
     
     body["info"] = taskInfoData;
     msg.buildBody(body);
 
-    MessageString msgStr(msg.str());
-    send(ChnlTskProc + "_" + agName, msgStr);
+    if (! send(chnl, msg)) {
+        containerTasks.requeue(nextTask, waited);
+        WarnMsg("Task " + taskName + " could not be sent to " + agName +
+                ", back to the pool of tasks");
+        return false;
+    }
 
-    containerTaskLastMessage[agName] = msgStr;
+    containerTaskLastMessage[agName] = msg.val();
+    ++agentCredits[agName].sent;
     
     taskRegistry[taskName] = TASK_SCHEDULED;
     containerTaskStatus[TASK_SCHEDULED]++;
     containerTaskStatusPerAgent[std::make_pair(agName, TASK_SCHEDULED)]++;
     
     DBG("Task " + taskName + "sent to " + agName);
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: updateCredits
+// Take the free slots advertised by an agent.  Together with the number
+// of tasks the agent has received, so that tasks still on their way are
+// not counted twice.  Agents only ask again once they got the reply to
+// their previous request: if the last task sent is not among those
+// received, it was lost, and it is sent again in reply.  Returns whether
+// a new task may be sent in reply to the request
+//----------------------------------------------------------------------
+bool TskMng::updateCredits(const std::string & agName, ChannelId chnl,
+                           MsgBodyTSK & body)
+{
+    AgentCredits & ac = agentCredits[agName];
+    int received = body["received"].asInt();
+
+    // The agent may have been restarted, or this manager
+    if ((received < ac.received) || (received > ac.sent)) { ac.sent = received; }
+
+    ac.credits  = body["credits"].asInt();
+    ac.received = received;
+
+    if (ac.sent > received) {
+        std::map<std::string, json>::iterator it =
+            containerTaskLastMessage.find(agName);
+        if (it != containerTaskLastMessage.end()) {
+            Message<MsgBodyTSK> lastMsg(it->second);
+            send(chnl, lastMsg);
+            DBG("Task message resent to " + agName);
+            return false;
+        }
+        ac.sent = received;
+    }
+
+    DBG("Agent " + agName + " has " + std::to_string(ac.available()) + " free slots");
+    return (ac.available() > 0);
+}
+
+//----------------------------------------------------------------------
+// Method: dispatchParkedRequests
+// Answer the requests kept from the agents in push mode with the tasks
+// of the pool they may run, each one going to the agent chosen by the
+// placement policy among them
+//----------------------------------------------------------------------
+void TskMng::dispatchParkedRequests()
+{
+    while (! parkedAgents.empty()) {
+        std::vector<std::string> candidates(parkedAgents.begin(), parkedAgents.end());
+        std::string agName;
+        TaskInfo nextTask;
+        double taskWaited = 0.;
+        if (! containerTasks.pop(nextTask, [&] (TaskInfo & t, double waited) {
+                    taskWaited = waited;
+                    agName = placeTask(t, candidates, waited);
+                    return ! agName.empty(); },
+                TASK_SCAN_DEPTH)) {
+            return;
+        }
+        // The request is still owed if the task could not be sent
+        if (! sendTask(agName, agentChnl[agName], nextTask, taskWaited)) { return; }
+        parkedAgents.erase(agName);
+    }
 }
 
 //----------------------------------------------------------------------
 // Method: processTskRepMsg
 //----------------------------------------------------------------------
-void TskMng::processTskRepMsg(ScalabilityProtocolRole* c, MessageString & m)
+void TskMng::processTskRepMsg(ScalabilityProtocolRole* c, MessageBase & m)
 {
-    Message<MsgBodyTSK> msg(m);
+    Message<MsgBodyTSK> msg(std::move(m));
     MsgBodyTSK & body = msg.body;
     TaskInfo task(body["info"]);
 
+    // Spans recorded by the agent come with the final report
+    if (task.val().isMember("traceSpans")) {
+        Tracer::instance().merge(task.val()["traceSpans"]);
+        task.val().removeMember("traceSpans");
+    }
+
+    // And so do the products the agent kept in the cache of its host
+    if (task.val().isMember("cachedProducts")) {
+        for (auto & p : task.val()["cachedProducts"]) {
+            productLocs.add(p.asString(), task.taskHost());
+        }
+        task.val().removeMember("cachedProducts");
+    }
+
     std::string taskName  = task.taskName();
     TaskStatus oldStatus  = taskRegistry[taskName];
 
@@ -269,18 +505,20 @@ void TskMng::processTskRepMsg(ScalabilityProtocolRole* c, MessageString & m)
                 (taskStatus == TASK_FAILED) ||
                 (taskStatus == TASK_FINISHED) ||
                 (taskStatus == TASK_UNKNOWN_STATE)){
-                containerTaskLastMessage.erase(containerTaskLastMessage.find(agName));
+                containerTaskLastMessage.erase(agName);
             }
 
             TaskStatusSpectra spec = convertTaskStatusToSpectra(agName);
 
             const std::string & hostIp = task.taskHost();
+            std::unique_lock<std::mutex> ulck(mtxHostInfo);
             ProcessingHostInfo * procHostInfo = Config::procFmkInfo->hostsInfo[hostIp];
             TraceMsg("HOSTIP: " + hostIp);
             for (auto & agi : procHostInfo->agInfo) {
                 TraceMsg("-- AGNAME: " + agi.name);
                 if (agi.name == agName) {
                     agi.taskStatus = spec;
+                    Config::procFmkInfo->touchAgent(hostIp, agName);
                     TraceMsg("Placing spectrum " + spec.toJsonStr() +
                         " placed for " + agName);
                 }
@@ -292,13 +530,14 @@ void TskMng::processTskRepMsg(ScalabilityProtocolRole* c, MessageString & m)
         InfoMsg("Finished task " + taskName);
     }
 
-    tskRegMsgs[taskName] = task.str();
+    // Only the latest report of each task is kept
+    tskRegMsgs.push(task.val(), taskName);
 }
 
 //----------------------------------------------------------------------
 // Method: processHostMonMsg
 //----------------------------------------------------------------------
-void TskMng::processHostMonMsg(ScalabilityProtocolRole* c, MessageString & m)
+void TskMng::processHostMonMsg(ScalabilityProtocolRole* c, MessageBase & m)
 {
     // Place new information in general structure
     consolidateMonitInfo(m);
@@ -346,29 +585,93 @@ void TskMng::execContainerTask()
 {
 }
 
-inline double weightFunc(double load, double tasks) {
-    return 100 * load + tasks;
+//----------------------------------------------------------------------
+// Method: selectAgent
+// Select, among the candidates, the agent to run the next task, from
+// the latest information of their hosts and their tasks.  Returns an
+// empty string if all their hosts are full
+//----------------------------------------------------------------------
+std::string TskMng::selectAgent(const std::vector<std::string> & candidates)
+{
+    std::map<std::string, int> hostTasks;
+    for (auto & a : agents) { hostTasks[agentHost[a]] += activeTasks(a); }
+
+    std::unique_lock<std::mutex> ulck(mtxHostInfo);
+    std::vector<AgentPlacement::Candidate> cands;
+    for (auto & a : candidates) {
+        AgentPlacement::Candidate c;
+        const std::string & host = agentHost[a];
+        c.name       = a;
+        c.agentTasks = activeTasks(a);
+        c.hostTasks  = hostTasks[host];
+        auto it = Config::procFmkInfo->hostsInfo.find(host);
+        if ((it != Config::procFmkInfo->hostsInfo.end()) && (it->second != 0)) {
+            c.hostInfo = &(it->second->hostInfo);
+        }
+        cands.push_back(c);
+    }
+    return placement.select(cands);
 }
 
 //----------------------------------------------------------------------
-// Method: selectAgent
-// Send a TaskProcessingMsg to the Task Manager, requesting the
-// execution of a rule
+// Method: placeTask
+// Select, among the candidates, the agent to run the task.  Those on the
+// hosts holding more of its inputs are tried first.  If none of them can
+// take it, the task waits for them up to localityWait seconds, and then
+// goes to any candidate, fetching the inputs from the gateway
+//----------------------------------------------------------------------
+std::string TskMng::placeTask(TaskInfo & task,
+                              const std::vector<std::string> & candidates,
+                              double waited)
+{
+    if (localityWait <= 0) { return selectAgent(candidates); }
+
+    std::vector<std::string> inputs;
+    for (auto & m : task.inputs.products) { inputs.push_back(m.productId()); }
+    std::map<std::string, int> held = productLocs.count(inputs);
+    if (held.empty()) { return selectAgent(candidates); }
+
+    std::map<int, std::vector<std::string>, std::greater<int>> byInputs;
+    for (auto & a : candidates) {
+        auto it = held.find(agentHost[a]);
+        if (it != held.end()) { byInputs[it->second].push_back(a); }
+    }
+    for (auto & kv : byInputs) {
+        std::string agName = selectAgent(kv.second);
+        if (! agName.empty()) { return agName; }
+    }
+
+    if (waited < localityWait) {
+        for (auto & a : agents) {
+            if (held.find(agentHost[a]) != held.end()) { return std::string(); }
+        }
+    }
+    return selectAgent(candidates);
+}
+
 //----------------------------------------------------------------------
-std::string TskMng::selectAgent()
+// Method: activeTasks
+// Tasks of the agent scheduled, running or paused
+//----------------------------------------------------------------------
+int TskMng::activeTasks(const std::string & agName)
 {
-    return std::string();
+    int n = 0;
+    for (auto s : {TASK_SCHEDULED, TASK_RUNNING, TASK_PAUSED}) {
+        auto it = containerTaskStatusPerAgent.find(std::make_pair(agName, s));
+        if (it != containerTaskStatusPerAgent.end()) { n += it->second; }
+    }
+    return n;
 }
 
 //----------------------------------------------------------------------
 // Method: consolidateMonitInfo
 // Consolidates the monitoring info retrieved from the processing hosts
 //----------------------------------------------------------------------
-void TskMng::consolidateMonitInfo(MessageString & m)
+void TskMng::consolidateMonitInfo(MessageBase & m)
 {
     std::unique_lock<std::mutex> ulck(mtxHostInfo);
 
-    Message<MsgBodyTSK> msg(m);
+    Message<MsgBodyTSK> msg(std::move(m));
     MsgBodyTSK & body = msg.body;
     Json::FastWriter fastWriter;
     std::string s(fastWriter.write(body["info"]));
@@ -381,9 +684,11 @@ void TskMng::consolidateMonitInfo(MessageString & m)
     switch (Config::agentMode[hostIp]) {
     case CONTAINER:
         Config::procFmkInfo->hostsInfo[hostIp]->hostInfo = hostInfo;
+        Config::procFmkInfo->touchHost(hostIp);
         break;
     case SERVICE:
         Config::procFmkInfo->swarmInfo[hostIp]->hostInfo = hostInfo;
+        Config::procFmkInfo->touchSwarm(hostIp);
         break;
     default:
         break;
@@ -396,23 +701,12 @@ void TskMng::consolidateMonitInfo(MessageString & m)
 //----------------------------------------------------------------------
 bool TskMng::getTskRepUpdate(json & tskRepData)
 {
-    std::unique_lock<std::mutex> ulck(mtxTskRegMsg);
-    bool dataAvailable = ! tskRegMsgs.empty();
+    std::list<std::pair<std::string, json>> reports;
+    tskRegMsgs.takeAll(reports);
+    bool dataAvailable = ! reports.empty();
     if (dataAvailable) {
-
-        // Prepare message and send it
-        int maxSize = MAX_MESSAGE_SIZE - 400; // header must be added
-
-        std::string multiMsg;
-        for (auto & kv : tskRegMsgs) {
-            if ((multiMsg.length() + kv.second.length()) < maxSize) {
-                multiMsg += "\"" + kv.first + "\":" + kv.second + ",";
-                tskRegMsgs.erase(kv.first);
-            }
-        }
-        multiMsg.pop_back();
-
-        tskRepData = JValue("{" + multiMsg + "}").val();
+        tskRepData = json(Json::objectValue);
+        for (auto & kv : reports) { tskRepData[kv.first].swap(kv.second); }
     }
     
     return dataAvailable;
@@ -420,23 +714,55 @@ bool TskMng::getTskRepUpdate(json & tskRepData)
 
 //----------------------------------------------------------------------
 // Method: getProcFmkInfoUpdate
-// Provide an update on the ProcessingFrameworkInfo structure
+// Provide a delta update on the ProcessingFrameworkInfo structure, or
+// a keyframe if requested or due.  Returns false if there is nothing
+// to send
 //----------------------------------------------------------------------
-void TskMng::getProcFmkInfoUpdate(json & fmkInfoValue)
+bool TskMng::getProcFmkInfoUpdate(json & fmkInfoValue, bool keyframe)
 {
     std::unique_lock<std::mutex> ulck(mtxHostInfo);
-    fmkInfoValue = JValue( Config::procFmkInfo->toJsonStr() ).val();
+
+    int period = cfg.flags.fmkMonKeyframePeriod();
+    if (period <= 0) { period = FMKMON_KEYFRAME_PERIOD; }
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastFmkInfoKeyframe >= std::chrono::seconds(period)) {
+        keyframe = true;
+    }
+
+    if ((! keyframe) && (! Config::procFmkInfo->isDirty())) { return false; }
+
+    if (keyframe) { lastFmkInfoKeyframe = now; }
+    fmkInfoValue = JValue( Config::procFmkInfo->toDeltaJsonStr(keyframe) ).val();
+    return true;
 }
 
 //----------------------------------------------------------------------
 // Method: scheduleTask
-// Schedule task for later provision to the requesting agents
+// Schedule task for later provision to the requesting agents.  Returns
+// false if the pool of tasks is full and does not take it (policy
+// "block"): the caller keeps the task and schedules it again later
 //----------------------------------------------------------------------
-void TskMng::scheduleTask(TaskInfo & task)
+bool TskMng::scheduleTask(TaskInfo & task)
 {
+    Tracer::instance().recordSinceMark(task.val(), "task.register", compName);
+
     // Store task in specific container
     if (task.taskSet() == "CONTAINER") {
-        containerTasks.push_back(task);
+        if (! containerTasks.push(task)) {
+            if (containerTasks.overflowPolicy() == OverflowQueueBase::Block) {
+                DBG("Pool of tasks full, task " + task.taskName() + " kept for later");
+                return false;
+            }
+            WarnMsg("Pool of tasks full, oldest task dropped");
+            RaiseSysAlert(Alert(Alert::System,
+                                Alert::Warning,
+                                Alert::Resource,
+                                std::string(__FILE__ ":" Stringify(__LINE__)),
+                                "Pool of tasks full, oldest task dropped",
+                                0));
+        }
+        // Agents waiting for a task may take this one
+        if (pushDispatch) { post([this] () { dispatchParkedRequests(); }); }
     } else if (task.taskSet() == "SERVICE") {
         serviceTasks.push_back(task);
     } else {
@@ -449,13 +775,14 @@ void TskMng::scheduleTask(TaskInfo & task)
                             + task.taskSet(),
                             0));
     }
+    return true;
 }
 
 //----------------------------------------------------------------------
 // Method: getRunningTasks
 // Get messages from tasks that are still running
 //----------------------------------------------------------------------
-void TskMng::getRunningTasks(std::map<std::string, MessageString> & tasks)
+void TskMng::getRunningTasks(std::map<std::string, json> & tasks)
 {
     tasks = containerTaskLastMessage;
 }
@@ -48,10 +48,16 @@
 //------------------------------------------------------------
 // Topic: System headers
 //   - list
+//   - set
+//   - thread
+//   - mutex
+//   - chrono
 //------------------------------------------------------------
 #include <list>
+#include <set>
 #include <thread>
 #include <mutex>
+#include <chrono>
 
 //------------------------------------------------------------
 // Topic: External packages
@@ -70,6 +76,9 @@
 #include "httpserver.h"
 #include "hostinfo.h"
 #include "procinfo.h"
+#include "taskqueue.h"
+#include "placement.h"
+#include "prodloc.h"
 
 //==========================================================================
 // Class: TaskManager
@@ -101,9 +110,11 @@ public:
 
     //----------------------------------------------------------------------
     // Method: scheduleTask
-    // Schedule task for later provision to the requesting agents
+    // Schedule task for later provision to the requesting agents.
+    // Returns false if the pool of tasks is full and the task must be
+    // scheduled again later
     //----------------------------------------------------------------------
-    void scheduleTask(TaskInfo & task);
+    bool scheduleTask(TaskInfo & task);
     
     //----------------------------------------------------------------------
     // Method: getTskMsgUpdate
@@ -113,15 +124,17 @@ public:
 
     //----------------------------------------------------------------------
     // Method: getProcFmkInfoUpdate
-    // Provide an update on the ProcessingFrameworkInfo structure
+    // Provide a delta update on the ProcessingFrameworkInfo structure,
+    // or a keyframe if requested or due.  Returns false if there is
+    // nothing to send
     //----------------------------------------------------------------------
-    void getProcFmkInfoUpdate(json & fmkInfoValue);
+    bool getProcFmkInfoUpdate(json & fmkInfoValue, bool keyframe = false);
 
     //----------------------------------------------------------------------
     // Method: getRunningTasks
     // Get messages from tasks that are still running
     //----------------------------------------------------------------------
-    void getRunningTasks(std::map<std::string, MessageString> & tasks);
+    void getRunningTasks(std::map<std::string, json> & tasks);
 
 protected:
     //----------------------------------------------------------------------
@@ -133,17 +146,17 @@ protected:
     //----------------------------------------------------------------------
     // Method: processTskRqstMsg
     //----------------------------------------------------------------------
-    void processTskRqstMsg(ScalabilityProtocolRole* c, MessageString & m);
+    void processTskRqstMsg(ScalabilityProtocolRole* c, MessageBase & m);
 
     //----------------------------------------------------------------------
     // Method: processTskRepMsg
     //----------------------------------------------------------------------
-    void processTskRepMsg(ScalabilityProtocolRole* c, MessageString & m);
+    void processTskRepMsg(ScalabilityProtocolRole* c, MessageBase & m);
 
     //----------------------------------------------------------------------
     // Method: processHostMonMsg
     //----------------------------------------------------------------------
-    void processHostMonMsg(ScalabilityProtocolRole* c, MessageString & m);
+    void processHostMonMsg(ScalabilityProtocolRole* c, MessageBase & m);
 
 
 private:
@@ -155,14 +168,34 @@ private:
 
     //----------------------------------------------------------------------
     // Method: selectAgent
+    // Select, among the candidates, the agent to run the next task, from
+    // the latest information of their hosts and their tasks.  Returns an
+    // empty string if all their hosts are full
     //----------------------------------------------------------------------
-    std::string selectAgent();
+    std::string selectAgent(const std::vector<std::string> & candidates);
+
+    //----------------------------------------------------------------------
+    // Method: placeTask
+    // Select, among the candidates, the agent to run the task, preferring
+    // those on the hosts with copies of its inputs.  Returns an empty
+    // string if no candidate can take it, or if the task should rather
+    // wait for an agent on those hosts
+    //----------------------------------------------------------------------
+    std::string placeTask(TaskInfo & task,
+                          const std::vector<std::string> & candidates,
+                          double waited);
+
+    //----------------------------------------------------------------------
+    // Method: activeTasks
+    // Tasks of the agent scheduled, running or paused
+    //----------------------------------------------------------------------
+    int activeTasks(const std::string & agName);
 
     //----------------------------------------------------------------------
     // Method: consolidateMonitInfo
     // Consolidates the monitoring info retrieved from the processing hosts
     //----------------------------------------------------------------------
-    void consolidateMonitInfo(MessageString & m);
+    void consolidateMonitInfo(MessageBase & m);
 
     //----------------------------------------------------------------------
     // Method: convertTaskStatusToSpectra
@@ -176,13 +209,58 @@ private:
     bool sendTaskAgMsg(MessageString & m,
                        std::string agName);
 
+    //----------------------------------------------------------------------
+    // Method: setTaskClasses
+    // Define the priority classes of the pool of tasks, from the
+    // orchestration configuration
+    //----------------------------------------------------------------------
+    void setTaskClasses();
+
+    //----------------------------------------------------------------------
+    // Method: sendTask
+    // Send a task taken from the pool to the agent, or put it back in
+    // the pool, with the seconds it had been waiting, if it cannot be sent
+    //----------------------------------------------------------------------
+    bool sendTask(const std::string & agName, ChannelId chnl, TaskInfo & task,
+                  double waited);
+
+    //----------------------------------------------------------------------
+    // Method: updateCredits
+    // Take the free slots advertised by an agent, and tell whether a
+    // new task may be sent in reply
+    //----------------------------------------------------------------------
+    bool updateCredits(const std::string & agName, ChannelId chnl,
+                       MsgBodyTSK & body);
+
+    //----------------------------------------------------------------------
+    // Method: dispatchParkedRequests
+    // Answer the requests kept from the agents in push mode with the
+    // tasks of the pool they may run
+    //----------------------------------------------------------------------
+    void dispatchParkedRequests();
+
+    //----------------------------------------------------------------------
+    // Method: publishMetrics
+    // Update the gauges of task queues and task status counts
+    //----------------------------------------------------------------------
+    void publishMetrics();
+
 private:
     typedef std::pair<std::string, TaskStatus>  TaskStatusPerAgent;
     std::vector<std::string>         agents;
     std::map<std::string, AgentInfo> agentInfo;
+    std::map<std::string, ChannelId> agentChnl;
+    std::map<std::string, std::string> agentHost;
+
+    AgentPlacement placement;
+
+    // Hosts with copies of the products in their local caches, and
+    // the longest a task waits for an agent on them (s)
+    ProductLocator productLocs;
+    double localityWait;
 
     std::list<TaskInfo> serviceTasks;
-    std::list<TaskInfo> containerTasks;
+    TaskQueue containerTasks;
 
     typedef std::map<std::string, TaskInfo>  RuleTagInputs;
 
@@ -194,7 +272,22 @@ private:
     std::map<TaskStatus, int> serviceTaskStatus;
 
     std::map<TaskStatusPerAgent, int> containerTaskStatusPerAgent;
-    std::map<std::string, MessageString> containerTaskLastMessage;
+    std::map<std::string, json> containerTaskLastMessage;
+
+    // Free slots advertised by each agent (push dispatch).  Tasks sent
+    // but not yet seen by the agent when it advertised are discounted
+    struct AgentCredits {
+        AgentCredits() : credits(0), received(0), sent(0) {}
+        int available() const { return credits - (sent - received); }
+        int credits;
+        int received;
+        int sent;
+    };
+    std::map<std::string, AgentCredits> agentCredits;
+    bool pushDispatch;
+
+    // Agents whose request is kept until there is a task for them
+    std::set<std::string> parkedAgents;
 
     HttpServer * httpSrv;
 
@@ -202,10 +295,14 @@ private:
 
     bool sendingPeriodicFmkInfo;
 
-    std::mutex mtxTskRegMsg;
+    std::chrono::steady_clock::time_point lastFmkInfoKeyframe;
+
+    std::map<std::string, Gauge*> metricGauges;
 
     bool sendingTskRegInfo;
-    std::map<std::string, std::string> tskRegMsgs;
+
+    // Latest task report of each task, not yet taken by Master
+    OverflowQueue<json> tskRegMsgs;
 };
 
 #endif // TSKMNG_H
@@ -52,6 +52,7 @@
 #include "message.h"
 #include "config.h"
 #include "uuidxx.h"
+#include "tracer.h"
 
 using Configuration::cfg;
 
@@ -299,12 +300,16 @@ void TskOrc::createTasks(ProductList & inData, int flags, std::vector<TaskInfo>
                     DbgMsg("Input: " + itInp.productId());
                 }
 
-                // Generate task and store in output vector
+                // Generate task and store in output vector; the task
+                // follows the trace of the product firing the rule
                 TaskInfo task;
                 createTask(kv.first, kv.second, flags, task);
+                task["traceId"] = md.traceId();
+                Tracer::mark(task.val());
                 tasks.push_back(task);
             }
         }
+        Tracer::instance().recordSinceMark(md.val(), "orchestrate", compName);
     }
 }
 
@@ -327,6 +332,8 @@ void TskOrc::createTask(Rule * rule, ProductList & inputs, int flags, TaskInfo &
     task["taskSession"]  = cfg.sessionId;
     task["params"]       = nullJson;
     task["taskFlags"]    = flags;
+    task["taskRule"]     = rule->name;
+    task["taskOrigin"]   = "nominal";
     
     std::string productId;
     
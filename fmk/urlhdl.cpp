@@ -43,6 +43,7 @@
 #include <unistd.h>
 #include <cassert>
 #include <ctime>
+#include <chrono>
 #include <cstdio>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -59,6 +60,7 @@
 #include "dbg.h"
 
 #include "filetools.h"
+#include "metrics.h"
 using namespace FileTools;
 
 #define showBacktrace()
@@ -76,7 +78,7 @@ using Configuration::cfg;
 //----------------------------------------------------------------------
 // Method: Constructor
 //----------------------------------------------------------------------
-URLHandler::URLHandler(bool remote) : isRemote(remote)
+URLHandler::URLHandler(bool remote) : isRemote(remote), cached(false)
 {
 }
 
@@ -265,8 +267,23 @@ ProductMetadata & URLHandler::fromGateway2Processing()
                     cfg.storage.gateway + section,
                     taskExchgDir + section);
 
+    cached = false;
     if (isRemote) {
-        (void)relocate(file, newFile, COPY_TO_REMOTE);
+        // Inputs kept in the local cache need no transfer
+        std::string cacheFile(cachePath(newFile));
+        struct stat st;
+        bool hit = ((! cacheFile.empty()) && (stat(cacheFile.c_str(), &st) == 0) &&
+                    (relocate(cacheFile, newFile, LINK) == 0));
+        if (! hit) {
+            (void)relocate(file, newFile, COPY_TO_REMOTE);
+        }
+        cached = (hit || ((! cacheFile.empty()) &&
+                          (relocate(newFile, cacheFile, LINK) == 0)));
+        if (! cacheFile.empty()) {
+            Metrics::instance().counter("qpf_local_cache_lookups_total",
+                                        "Inputs looked up in the local cache",
+                                        Metrics::labels({{"result", hit ? "hit" : "miss"}})).inc();
+        }
         unlink(file.c_str());
     } else {
         (void)relocate(file, newFile, MOVE);
@@ -307,8 +324,16 @@ ProductMetadata & URLHandler::fromProcessing2Gateway()
                     taskExchgDir + subdir,
                     cfg.storage.gateway + section);
 
+    cached = false;
     if (isRemote) {
         (void)relocate(file, newFile, COPY_TO_MASTER);
+        // Keep the output products for the tasks that may use them
+        // on this host
+        std::string cacheFile(cachePath(file));
+        if ((subdir == "/out") && (! cacheFile.empty())) {
+            unlink(cacheFile.c_str());
+            cached = (relocate(file, cacheFile, LINK) == 0);
+        }
         unlink(file.c_str());
     } else {
         (void)relocate(file, newFile, LINK);
@@ -522,6 +547,10 @@ int URLHandler::relocate(std::string & sFrom, std::string & sTo,
         }
     }
 
+    static const char * methodName[] = { "link", "move", "copy", "copy_to_remote",
+                                         "copy_to_master", "symlink" };
+    auto t0 = std::chrono::steady_clock::now();
+
     int retVal = 0;
     switch(method) {
     case LINK:
@@ -562,6 +591,21 @@ int URLHandler::relocate(std::string & sFrom, std::string & sTo,
                 ") relocating product:\n\t" +
                 sFrom + std::string(" => ") + sTo).c_str());
         //showBacktrace();
+    } else if ((method != LINK) && (method != SYMLINK)) {
+        // Transfer throughput: bytes over the time spent
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                                    - t0).count();
+        std::string lbl(Metrics::labels({{"method", methodName[method]}}));
+        Metrics & mtr = Metrics::instance();
+        mtr.histogram("qpf_transfer_seconds", "Duration of product transfers",
+                      Histogram::expBounds(0.001, 4, 10), lbl).observe(secs);
+        // (the source is gone after a move, the target may be remote)
+        struct stat st;
+        std::string & f = (method == MOVE) ? sTo : sFrom;
+        if (stat(f.c_str(), &st) == 0) {
+            mtr.counter("qpf_transfer_bytes_total", "Bytes of products transferred",
+                        lbl).inc(st.st_size);
+        }
     }
     return retVal;
 }
@@ -577,6 +621,25 @@ void URLHandler::setRemoteCopyParams(std::string maddr, std::string raddr)
     TRC("Master addr: " << maddr << "  Remote addr: " << raddr);
 }
 
+//----------------------------------------------------------------------
+// Method: setLocalCache
+//----------------------------------------------------------------------
+void URLHandler::setLocalCache(std::string dir)
+{
+    cacheDir = dir;
+    TRC("Local cache: " << cacheDir);
+}
+
+//----------------------------------------------------------------------
+// Method: cachePath
+// Path of the copy of a file in the local cache (empty if none)
+//----------------------------------------------------------------------
+std::string URLHandler::cachePath(const std::string & file)
+{
+    if (cacheDir.empty()) { return std::string(); }
+    return cacheDir + "/" + file.substr(file.find_last_of('/') + 1);
+}
+
 //----------------------------------------------------------------------
 // Method: setProcElemRunDir
 //----------------------------------------------------------------------
@@ -164,17 +164,39 @@ public:
     //----------------------------------------------------------------------
     void setProcElemRunDir(std::string wkDir, std::string tskDir);
 
+    //----------------------------------------------------------------------
+    // Method: setLocalCache
+    // Folder of the remote host where the products transferred are kept,
+    // so that later tasks on the host need not transfer them again
+    //----------------------------------------------------------------------
+    void setLocalCache(std::string dir);
+
+    //----------------------------------------------------------------------
+    // Method: inLocalCache
+    // True if the product last relocated has a copy in the local cache
+    //----------------------------------------------------------------------
+    bool inLocalCache() const { return cached; }
+
+private:
+    //----------------------------------------------------------------------
+    // Method: cachePath
+    // Path of the copy of a file in the local cache (empty if none)
+    //----------------------------------------------------------------------
+    std::string cachePath(const std::string & file);
+
 private:
     std::string workDir;
     std::string intTaskDir;
     std::string taskExchgDir;
     std::string master_address;
     std::string remote_address;
+    std::string cacheDir;
 
     std::string productUrl;
     std::string productUrlSpace;
 
     bool isRemote;
+    bool cached;
 };
 
 //}
@@ -0,0 +1,113 @@
+// -*- C++ -*-
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <atomic>
+#include <cstdint>
+#include <cmath>
+
+//-----------------------------------------------------------------------------
+// LatencyHistogram
+// HDR style histogram of durations (in microseconds): values are kept in
+// buckets with a relative precision of 1/16 (exact below 16 us), from 1 us
+// up to ~200 days, in constant memory.  Recording is lock-free, so the
+// histogram can be read while the owner thread keeps recording.
+//-----------------------------------------------------------------------------
+class LatencyHistogram {
+public:
+    static const int      SubBucketBits = 4;
+    static const int      SubBuckets    = 1 << SubBucketBits;
+    static const int      MaxValueBits  = 44;
+    static const int      NumBuckets    = (MaxValueBits - SubBucketBits + 1) * SubBuckets;
+    static const uint64_t MaxValue      = (uint64_t(1) << MaxValueBits) - 1;
+
+    LatencyHistogram() { reset(); }
+
+    void record(uint64_t us) {
+        if (us > MaxValue) { us = MaxValue; }
+        counts[index(us)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(us, std::memory_order_relaxed);
+        uint64_t m = minV.load(std::memory_order_relaxed);
+        while ((us < m) && !minV.compare_exchange_weak(m, us)) {}
+        m = maxV.load(std::memory_order_relaxed);
+        while ((us > m) && !maxV.compare_exchange_weak(m, us)) {}
+    }
+
+    void reset() {
+        for (auto & c : counts) { c = 0; }
+        total = 0;
+        sum   = 0;
+        minV  = MaxValue;
+        maxV  = 0;
+    }
+
+    uint64_t count() const { return total.load(); }
+    uint64_t min() const { return (total.load() > 0) ? minV.load() : 0; }
+    uint64_t max() const { return maxV.load(); }
+    double mean() const {
+        uint64_t n = total.load();
+        return (n > 0) ? (double(sum.load()) / n) : 0.;
+    }
+
+    // Highest value equivalent (within the bucket precision) to the value
+    // at the given percentile (0-100)
+    uint64_t percentile(double p) const {
+        uint64_t n = total.load();
+        if (n == 0) { return 0; }
+        uint64_t target = uint64_t(std::ceil(p * 0.01 * n));
+        if (target < 1) { target = 1; }
+        uint64_t acc = 0;
+        for (int i = 0; i < NumBuckets; ++i) {
+            acc += counts[i].load(std::memory_order_relaxed);
+            if (acc >= target) {
+                uint64_t v = highestEquivalent(i);
+                return (v < max()) ? v : max();
+            }
+        }
+        return max();
+    }
+
+private:
+    // Values below SubBuckets have a bucket each; above, each power of
+    // two is split in SubBuckets linear buckets
+    static int index(uint64_t v) {
+        if (v < uint64_t(SubBuckets)) { return int(v); }
+        int msb = 63 - __builtin_clzll(v);
+        int shift = msb - SubBucketBits;
+        int sub = int(v >> shift) - SubBuckets;
+        return (shift + 1) * SubBuckets + sub;
+    }
+
+    static uint64_t highestEquivalent(int idx) {
+        if (idx < SubBuckets) { return uint64_t(idx); }
+        int shift = idx / SubBuckets - 1;
+        uint64_t sub = uint64_t(idx % SubBuckets) + SubBuckets;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::atomic<uint64_t> counts[NumBuckets];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> minV;
+    std::atomic<uint64_t> maxV;
+};
+
+//-----------------------------------------------------------------------------
+// ChannelStats
+// Traffic counters and latency histograms of a role: latency is measured
+// from the transmission stamp in the message header to the execution of
+// the handler, and the round trip time from a request to its reply
+//-----------------------------------------------------------------------------
+struct ChannelStats {
+    ChannelStats() : msgsIn(0), bytesIn(0), msgsOut(0), bytesOut(0) {}
+    std::atomic<uint64_t> msgsIn;
+    std::atomic<uint64_t> bytesIn;
+    std::atomic<uint64_t> msgsOut;
+    std::atomic<uint64_t> bytesOut;
+    LatencyHistogram      latency;
+    LatencyHistogram      rtt;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "msgbuf.h"
+#include "nn.hpp"
+
+#include <cstring>
+
+//-----------------------------------------------------------------------------
+// MessageBuffer
+//-----------------------------------------------------------------------------
+MessageBuffer::MessageBuffer()
+    : ptr(0), len(0)
+{
+}
+
+MessageBuffer::MessageBuffer(const MessageString & s)
+    : ptr(0), len(0)
+{
+    ptr = nn::allocmsg(s.size(), 0);
+    len = s.size();
+    memcpy(ptr, s.data(), len);
+}
+
+MessageBuffer::MessageBuffer(const char * s)
+    : ptr(0), len(0)
+{
+    len = strlen(s);
+    ptr = nn::allocmsg(len, 0);
+    memcpy(ptr, s, len);
+}
+
+MessageBuffer::MessageBuffer(const char * s, size_t n)
+    : ptr(0), len(0)
+{
+    ptr = nn::allocmsg(n, 0);
+    len = n;
+    memcpy(ptr, s, len);
+}
+
+MessageBuffer::MessageBuffer(MessageBuffer && other)
+    : ptr(other.ptr), len(other.len)
+{
+    other.ptr = 0;
+    other.len = 0;
+}
+
+MessageBuffer::~MessageBuffer()
+{
+    reset();
+}
+
+MessageBuffer & MessageBuffer::operator=(MessageBuffer && other)
+{
+    if (this != &other) {
+        reset();
+        ptr = other.ptr;
+        len = other.len;
+        other.ptr = 0;
+        other.len = 0;
+    }
+    return *this;
+}
+
+MessageBuffer MessageBuffer::adopt(void * msg, size_t n)
+{
+    MessageBuffer b;
+    b.ptr = msg;
+    b.len = n;
+    return b;
+}
+
+MessageString MessageBuffer::str() const
+{
+    return (ptr == 0) ? MessageString() : MessageString(data(), len);
+}
+
+void * MessageBuffer::release()
+{
+    void * p = ptr;
+    ptr = 0;
+    len = 0;
+    return p;
+}
+
+void MessageBuffer::reset()
+{
+    if (ptr != 0) {
+        nn_freemsg(ptr);
+        ptr = 0;
+        len = 0;
+    }
+}
@@ -0,0 +1,49 @@
+// -*- C++ -*-
+
+#ifndef MSGBUF_H
+#define MSGBUF_H
+
+#include <nanomsg/nn.h>
+
+#include <string>
+#include <cstddef>
+
+typedef std::string                  MessageString;
+
+//-----------------------------------------------------------------------------
+// MessageBuffer
+// Owning handle of a nanomsg message buffer (allocated with nn_allocmsg or
+// received with NN_MSG).  Handles can only be moved, so the message content
+// travels from the socket to its consumer without being copied.
+//-----------------------------------------------------------------------------
+class MessageBuffer {
+public:
+    MessageBuffer();
+    MessageBuffer(const MessageString & s);
+    MessageBuffer(const char * s);
+    MessageBuffer(const char * s, size_t len);
+    MessageBuffer(MessageBuffer && other);
+    ~MessageBuffer();
+
+    MessageBuffer & operator=(MessageBuffer && other);
+
+    static MessageBuffer adopt(void * msg, size_t len);
+
+    const char * data() const { return (const char *)(ptr); }
+    char * data() { return (char *)(ptr); }
+    size_t size() const { return len; }
+    bool empty() const { return (ptr == 0) || (len == 0); }
+
+    MessageString str() const;
+    void * release();
+    void reset();
+
+private:
+    MessageBuffer(const MessageBuffer &);
+    MessageBuffer & operator=(const MessageBuffer &);
+
+    void * ptr;
+    size_t len;
+};
+
+#endif
@@ -13,11 +13,12 @@ Pair::Pair(int elemCls, const char * addr)
     init(elemCls, addr);
 }
 
-void Pair::setMsgOut(MessageString m)
+bool Pair::setMsgOut(MessageBuffer m)
 {
     if (elemClass == NN_PAIR) {
-        ScalabilityProtocolRole::setMsgOut(m);
+        return ScalabilityProtocolRole::setMsgOut(std::move(m));
     }
+    return false;
 }
 
 void Pair::init(int elemCls, const char * addr)
@@ -36,6 +37,11 @@ void Pair::init(int elemCls, const char * addr)
     (void)usleep(WAIT_BINDING);
 }
 
+bool Pair::canReceive()
+{
+    return (elemClass == NN_PAIR);
+}
+
 void Pair::getIncommingMessageStrings()
 {
     if (elemClass == NN_PAIR) {
@@ -13,7 +13,8 @@ class Pair : public ScalabilityProtocolRole {
 public:
     Pair(int elemCls, std::string addr);
     Pair(int elemCls, const char * addr);
-    virtual void setMsgOut(MessageString m);
+    virtual bool setMsgOut(MessageBuffer m);
+    virtual bool canReceive();
 protected:
     virtual void init(int elemCls, const char * addr);
     virtual void getIncommingMessageStrings();
@@ -3,28 +3,31 @@
 //-----------------------------------------------------------------------------
 // Pipeline
 //-----------------------------------------------------------------------------
-Pipeline::Pipeline(int elemCls, std::string addr)
+Pipeline::Pipeline(int elemCls, std::string addr, Binding b)
+    : binding(b)
 {
     init(elemCls, addr.c_str());
 }
 
-Pipeline::Pipeline(int elemCls, const char * addr)
+Pipeline::Pipeline(int elemCls, const char * addr, Binding b)
+    : binding(b)
 {
     init(elemCls, addr);
 }
 
-void Pipeline::setMsgOut(MessageString m)
+bool Pipeline::setMsgOut(MessageBuffer m)
 {
     if (elemClass == NN_PUSH) {
-        ScalabilityProtocolRole::setMsgOut(m);
+        return ScalabilityProtocolRole::setMsgOut(std::move(m));
     }
+    return false;
 }
 
 void Pipeline::init(int elemCls, const char * addr)
 {
     elemClass = elemCls;
     createSocket(elemClass);
-    if (elemClass == NN_PUSH) {
+    if ((elemClass == NN_PUSH) == (binding == PusherBinds)) {
         endPoint = sck->bind(addr);
         TRC("BIND >> " << addr);
     } else {
@@ -35,6 +38,11 @@ void Pipeline::init(int elemCls, const char * addr)
     (void)usleep(WAIT_BINDING);
 }
 
+bool Pipeline::canReceive()
+{
+    return (elemClass == NN_PULL);
+}
+
 void Pipeline::getIncommingMessageStrings()
 {
     if (elemClass == NN_PULL) {
@@ -11,13 +11,20 @@
 //-----------------------------------------------------------------------------
 class Pipeline : public ScalabilityProtocolRole {
 public:
-    Pipeline(int elemCls, std::string addr);
-    Pipeline(int elemCls, const char * addr);
-    virtual void setMsgOut(MessageString m);
+    // The pusher binds, unless a single puller collects the messages
+    // of several pushers
+    enum Binding { PusherBinds, PullerBinds };
+
+    Pipeline(int elemCls, std::string addr, Binding b = PusherBinds);
+    Pipeline(int elemCls, const char * addr, Binding b = PusherBinds);
+    virtual bool setMsgOut(MessageBuffer m);
+    virtual bool canReceive();
 protected:
     virtual void init(int elemCls, const char * addr);
     virtual void getIncommingMessageStrings();
     virtual void processMessageString(MessageString & m);
+private:
+    Binding binding;
 };
 
 #endif
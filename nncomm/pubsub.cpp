@@ -13,11 +13,12 @@ PubSub::PubSub(int elemCls, const char * addr)
     init(elemCls, addr);
 }
 
-void PubSub::setMsgOut(MessageString m)
+bool PubSub::setMsgOut(MessageBuffer m)
 {
     if (elemClass == NN_PUB) {
-        ScalabilityProtocolRole::setMsgOut(m);
+        return ScalabilityProtocolRole::setMsgOut(std::move(m));
     }
+    return false;
 }
 
 void PubSub::init(int elemCls, const char * addr)
@@ -36,6 +37,11 @@ void PubSub::init(int elemCls, const char * addr)
     (void)usleep(WAIT_BINDING);
 }
 
+bool PubSub::canReceive()
+{
+    return (elemClass == NN_SUB);
+}
+
 void PubSub::getIncommingMessageStrings()
 {
     if (elemClass == NN_SUB) {
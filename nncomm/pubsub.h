@@ -13,7 +13,8 @@ class PubSub : public ScalabilityProtocolRole {
 public:
     PubSub(int elemCls, std::string addr);
     PubSub(int elemCls, const char * addr);
-    virtual void setMsgOut(MessageString m);
+    virtual bool setMsgOut(MessageBuffer m);
+    virtual bool canReceive();
 protected:
     virtual void init(int elemCls, const char * addr);
     virtual void getIncommingMessageStrings();
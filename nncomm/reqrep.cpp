@@ -3,12 +3,12 @@
 //-----------------------------------------------------------------------------
 // ReqRep
 //-----------------------------------------------------------------------------
-ReqRep::ReqRep(int elemCls, std::string addr)
+ReqRep::ReqRep(int elemCls, std::string addr) : repState(RepIdle)
 {
     init(elemCls, addr.c_str());
 }
 
-ReqRep::ReqRep(int elemCls, const char * addr)
+ReqRep::ReqRep(int elemCls, const char * addr) : repState(RepIdle)
 {
     init(elemCls, addr);
 }
@@ -28,6 +28,45 @@ void ReqRep::init(int elemCls, const char * addr)
     (void)usleep(WAIT_BINDING);
 }
 
+bool ReqRep::setMsgOut(MessageBuffer m)
+{
+    if (elemClass == NN_REP) {
+        // Only one reply per request
+        int holding = RepHolding;
+        if (! repState.compare_exchange_strong(holding, RepReplying)) {
+            TRC(elemName << ": no request to reply to, message not sent");
+            return false;
+        }
+    }
+    if (ScalabilityProtocolRole::setMsgOut(std::move(m))) { return true; }
+
+    // Not queued: the request is still to be answered
+    int replying = RepReplying;
+    (void)repState.compare_exchange_strong(replying, RepHolding);
+    return false;
+}
+
+bool ReqRep::canReceive()
+{
+    return (elemClass != NN_REP) || (repState == RepIdle);
+}
+
+bool ReqRep::owesReply()
+{
+    return (elemClass == NN_REP) && (repState == RepHolding);
+}
+
+void ReqRep::releaseRequest()
+{
+    int holding = RepHolding;
+    if ((elemClass == NN_REP) &&
+        repState.compare_exchange_strong(holding, RepIdle) && ioRunning) {
+        // The I/O thread may take the next request
+        uint64_t one = 1;
+        (void)write(ioOutFd, &one, sizeof(one));
+    }
+}
+
 void ReqRep::getIncommingMessageStrings()
 {
     incMsgsMask = NN_IN;
@@ -38,3 +77,37 @@ void ReqRep::processMessageString(MessageString & m)
 {
     TRC("I (" << elemName << ") got a message: '" << m << "'");
 }
+
+int ReqRep::sendBuffer(MessageBuffer & m)
+{
+    if (elemClass != NN_REP) { return ScalabilityProtocolRole::sendBuffer(m); }
+
+    if (repState != RepReplying) {
+        errno = EFSM;
+        return -1;
+    }
+    int n;
+    try {
+        n = ScalabilityProtocolRole::sendBuffer(m);
+    } catch (...) {
+        repState = RepIdle;
+        throw;
+    }
+    repState = RepIdle;
+    return n;
+}
+
+int ReqRep::recvBuffer(int flags)
+{
+    if ((elemClass == NN_REP) && (repState != RepIdle)) {
+        errno = EAGAIN;
+        return -1;
+    }
+    return ScalabilityProtocolRole::recvBuffer(flags);
+}
+
+void ReqRep::messageReceived()
+{
+    // The request is taken before the consumer may see it and reply
+    if (elemClass == NN_REP) { repState = RepHolding; }
+}
@@ -6,17 +6,35 @@
 #include "scalprotrole.h"
 #include <nanomsg/reqrep.h>
 
+#include <atomic>
+
 //-----------------------------------------------------------------------------
 // ReqRep
+// A REP socket drops the request it holds whenever it receives again, and
+// it can only send the reply to that request.  So the replier takes one
+// request at a time: it does not receive again until the request has been
+// answered, or released by its owner when no answer is to be sent, and
+// messages with no request to answer are refused.
 //-----------------------------------------------------------------------------
 class ReqRep : public ScalabilityProtocolRole {
 public:
     ReqRep(int elemCls, std::string addr);
     ReqRep(int elemCls, const char * addr);
+    virtual bool setMsgOut(MessageBuffer m);
+    virtual bool canReceive();
+    virtual bool owesReply();
+    virtual void releaseRequest();
 protected:
     virtual void init(int elemCls, const char * addr);
     virtual void getIncommingMessageStrings();
     virtual void processMessageString(MessageString & m);
+    virtual int sendBuffer(MessageBuffer & m);
+    virtual int recvBuffer(int flags);
+    virtual void messageReceived();
+private:
+    // Replier state: no request, request taken, and reply queued
+    enum { RepIdle, RepHolding, RepReplying };
+    std::atomic<int> repState;
 };
 
 #endif
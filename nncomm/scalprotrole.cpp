@@ -1,17 +1,30 @@
 #include "scalprotrole.h"
 #include <cassert>
 #include <sstream>
+#include <chrono>
 
 #include <nanomsg/survey.h>
+#include <nanomsg/reqrep.h>
+
+#include <poll.h>
+#include <sys/eventfd.h>
 
 ScalabilityProtocolRole::ScalabilityProtocolRole()
-    : sck(0), readyToGo(false), incMsgsMask(NN_IN | NN_OUT)
+    : sck(0), iMsgList(MSG_QUEUE_SIZE), oMsgList(MSG_QUEUE_SIZE),
+      readyToGo(false), incMsgsMask(NN_IN | NN_OUT),
+      rcvFd(-1), pollTimeout(50), drainBudget(0),
+      outWaiters(0), ioRunning(false), ioNotifyFd(-1), ioOutFd(-1), numRecv(0),
+      reqSentAt(0)
 {
 }
 
 ScalabilityProtocolRole::~ScalabilityProtocolRole()
 {
-    if (sck != 0) sck->shutdown(endPoint);
+    stopIoThread();
+    if (sck != 0) {
+        for (auto & ep : extraEndPoints) { sck->shutdown(ep); }
+        sck->shutdown(endPoint);
+    }
 }
 
 void ScalabilityProtocolRole::createSocket(int protocol, int domain)
@@ -19,6 +32,9 @@ void ScalabilityProtocolRole::createSocket(int protocol, int domain)
     sck = new Socket {domain, protocol};
     assert(sck != 0);
     assert(sck->fd() >= 0);
+    // No limit on the size of incoming messages
+    int maxSize = -1;
+    sck->setsockopt(NN_SOL_SOCKET, NN_RCVMAXSIZE, &maxSize, sizeof(maxSize));
     TRC(elemName << ": " << sck);
     readyToGo = true;
 }
@@ -27,28 +43,70 @@ void ScalabilityProtocolRole::update()
 {
     if (!readyToGo) { return; }
 
+    if (ioRunning) {
+        // Messages are already being received by the I/O thread; just
+        // clear the notification, before the queue is drained by next()
+        uint64_t n;
+        (void)read(ioNotifyFd, &n, sizeof(n));
+        return;
+    }
+
     // Get incomming messages, if any
     getIncommingMessageStrings();
 }
 
+bool ScalabilityProtocolRole::next(MessageBuffer & m)
+{
+    return iMsgList.pop(m);
+}
+
+bool ScalabilityProtocolRole::hasMessages()
+{
+    // Messages received and not yet taken with next()
+    return !iMsgList.empty();
+}
+
 bool ScalabilityProtocolRole::next(MessageString & m)
 {
-    std::unique_lock<std::mutex> ulck(mtxMsgLists);
-    bool thereAreMessages = !iMsgList.empty();
-    if (thereAreMessages) {
-        m = iMsgList.front();
-        iMsgList.pop();
-    }
+    MessageBuffer b;
+    bool thereAreMessages = next(b);
+    if (thereAreMessages) { m = b.str(); }
     return thereAreMessages;
 }
 
-void ScalabilityProtocolRole::setMsgOut(MessageString m)
+bool ScalabilityProtocolRole::setMsgOut(MessageBuffer m)
 {
-    if (readyToGo) {
-        sck->send((void*)(m.c_str()), m.size(), 0);
-        //TRC("++ Sending " << std::to_string(m.length()) 
-        //    << " bytes msg. <<<" << m << ">>>");
+    if (!readyToGo) { return false; }
+
+    if (ioRunning) {
+        // Producers are serialized only among themselves; the I/O
+        // thread takes the messages without locking.  While the queue
+        // is full they wait (releasing the lock) for a bounded time
+        std::unique_lock<std::mutex> ulck(mtxMsgLists);
+        if (!oMsgList.push(std::move(m))) {
+            ++outWaiters;
+            bool room = cvOutRoom.wait_for(ulck, std::chrono::milliseconds(MSG_OUT_WAIT),
+                                           [&]() { return oMsgList.push(std::move(m)); });
+            --outWaiters;
+            if (!room) {
+                TRC(elemName << ": outbound queue full, message not sent");
+                return false;
+            }
+        }
+        uint64_t one = 1;
+        (void)write(ioOutFd, &one, sizeof(one));
+        return true;
+    }
+
+    int n;
+    try {
+        n = sendBuffer(m);
+    } catch (std::exception & e) {
+        TRC(elemName << ": error sending message: " << e.what());
+        return false;
     }
+    //TRC("++ Sending " << std::to_string(m.size()) << " bytes msg.");
+    return (n >= 0);
 }
 
 int ScalabilityProtocolRole::getClass()
@@ -78,40 +136,267 @@ std::string ScalabilityProtocolRole::getAddress()
     return address;
 }
 
+void ScalabilityProtocolRole::addBinding(std::string addr)
+{
+    // Same socket, reachable through another transport (e.g. inproc://
+    // for peers in this process, and tcp:// for remote ones)
+    extraEndPoints.push_back(sck->bind(addr.c_str()));
+    TRC("BIND >> " << addr);
+}
+
+bool ScalabilityProtocolRole::canReceive()
+{
+    return true;
+}
+
+bool ScalabilityProtocolRole::owesReply()
+{
+    return false;
+}
+
+void ScalabilityProtocolRole::releaseRequest()
+{
+    // Only replier roles hold requests
+}
+
+int ScalabilityProtocolRole::getRecvFd()
+{
+    if (ioRunning) { return ioNotifyFd; }
+    if (!readyToGo || !canReceive()) { return -1; }
+    return getSocketRecvFd();
+}
+
+int ScalabilityProtocolRole::getSocketRecvFd()
+{
+    if (rcvFd < 0) {
+        size_t fdsz = sizeof(rcvFd);
+        if (nn_getsockopt(sck->fd(), NN_SOL_SOCKET, NN_RCVFD,
+                          (char*) &rcvFd, &fdsz) != 0) {
+            rcvFd = -1;
+        }
+    }
+    return rcvFd;
+}
+
+ChannelStats & ScalabilityProtocolRole::getStats()
+{
+    return stats;
+}
+
+void ScalabilityProtocolRole::countOut(size_t n)
+{
+    stats.msgsOut++;
+    stats.bytesOut += n;
+    if (elemClass == NN_REQ) {
+        reqSentAt = std::chrono::duration_cast<std::chrono::nanoseconds>
+            (std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+void ScalabilityProtocolRole::countIn(size_t n)
+{
+    stats.msgsIn++;
+    stats.bytesIn += n;
+    if (elemClass == NN_REQ) {
+        int64_t sentAt = reqSentAt.exchange(0);
+        if (sentAt > 0) {
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>
+                (std::chrono::steady_clock::now().time_since_epoch()).count();
+            stats.rtt.record((now - sentAt) / 1000);
+        }
+    }
+}
+
+void ScalabilityProtocolRole::setPollTimeout(int ms)
+{
+    pollTimeout = ms;
+}
+
+void ScalabilityProtocolRole::setDrainBudget(int n)
+{
+    drainBudget = n;
+}
+
+void ScalabilityProtocolRole::startIoThread()
+{
+    if (!readyToGo || ioRunning) { return; }
+
+    ioNotifyFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ioOutFd    = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((ioNotifyFd < 0) || (ioOutFd < 0)) {
+        if (ioNotifyFd >= 0) { close(ioNotifyFd); ioNotifyFd = -1; }
+        if (ioOutFd >= 0)    { close(ioOutFd);    ioOutFd = -1; }
+        return;
+    }
+
+    // The I/O thread waits on the socket itself, so receiving must
+    // not wait, and reads everything available
+    pollTimeout = 0;
+    if (drainBudget <= 0) { drainBudget = MSG_QUEUE_SIZE; }
+
+    ioRunning = true;
+    ioThr = std::thread(&ScalabilityProtocolRole::runIoThread, this);
+}
+
+void ScalabilityProtocolRole::stopIoThread()
+{
+    if (!ioRunning) { return; }
+    ioRunning = false;
+    uint64_t one = 1;
+    (void)write(ioOutFd, &one, sizeof(one));
+    if (ioThr.joinable()) { ioThr.join(); }
+    close(ioNotifyFd); ioNotifyFd = -1;
+    close(ioOutFd);    ioOutFd = -1;
+}
+
+void ScalabilityProtocolRole::flushMsgsOut()
+{
+    MessageBuffer m;
+    bool popped = false;
+    while (oMsgList.pop(m)) {
+        popped = true;
+        int n = -1;
+        std::string why("message not sent");
+        try {
+            n = sendBuffer(m);
+            if (n < 0) { why += ": " + std::string(nn_strerror(errno)); }
+        } catch (std::exception & e) {
+            why += ": " + std::string(e.what());
+        }
+        if (n < 0) { sendFailed(why); }
+    }
+
+    // Producers waiting for room check again; taking the lock makes sure
+    // that they are either still to check, or already waiting
+    if (popped && (outWaiters > 0)) {
+        { std::lock_guard<std::mutex> lck(mtxMsgLists); }
+        cvOutRoom.notify_all();
+    }
+}
+
+void ScalabilityProtocolRole::setSendErrorHandler(SendErrorHandler h)
+{
+    sendErrorHandler = h;
+}
+
+void ScalabilityProtocolRole::sendFailed(const std::string & why)
+{
+    TRC(elemName << ": " << why);
+    if (sendErrorHandler) { sendErrorHandler(why); }
+}
+
+void ScalabilityProtocolRole::runIoThread()
+{
+    struct pollfd fds[2];
+    uint64_t n;
+
+    while (ioRunning) {
+        flushMsgsOut();
+
+        // Receive whatever is available, while there is room for it
+        bool receiving = canReceive() && !iMsgList.full();
+        if (receiving) {
+            unsigned long before = numRecv;
+            getIncommingMessageStrings();
+            if (numRecv != before) {
+                uint64_t one = 1;
+                (void)write(ioNotifyFd, &one, sizeof(one));
+            }
+            receiving = canReceive() && !iMsgList.full();
+        }
+
+        fds[0] = {ioOutFd, POLLIN, 0};
+        fds[1] = {receiving ? getSocketRecvFd() : -1, POLLIN, 0};
+        // A full inbound queue or a role not expecting messages (e.g. a
+        // surveyor with no pending survey) is checked again shortly.  A
+        // replier holding a request is woken up by its reply or release
+        int timeout = (receiving || owesReply()) ? -1 : 10;
+        if (poll(fds, 2, timeout) < 0) { continue; }
+        if ((fds[0].revents & POLLIN) != 0) {
+            (void)read(ioOutFd, &n, sizeof(n));
+        }
+    }
+    flushMsgsOut();
+}
+
 void ScalabilityProtocolRole::getIncommingMessageStrings()
 {
-    if (elemClass == NN_SURVEYOR) {
-        while (true) {
+    if (drainBudget > 0) {
+        // Drain mode: read all the pending messages, without waiting,
+        // until EAGAIN or until the budget for this update is exhausted.
+        // Roles that must not receive again yet (e.g. a replier holding
+        // a request) stop earlier
+        int numMsgs = 0;
+        while ((numMsgs < drainBudget) && canReceive()) {
             try {
-                rc = sck->recv(buf, MAX_MESSAGE_SIZE, 0);
-                if (rc == ETIMEDOUT) { return; }
-                if (rc > 0) {
-                    std::unique_lock<std::mutex> ulck(mtxMsgLists);
-                    memset((void*)(buf + rc), 0, MAX_MESSAGE_SIZE - rc);
-                    iMsgList.push(MessageString(buf));
-                }
+                rc = recvBuffer(NN_DONTWAIT);
             } catch (...) {
                 return;
             }
+            if (rc < 0) { return; }
+            ++numMsgs;
         }
-    } else {
-        int rev = getevents(sck->fd(), incMsgsMask, 50);
+    } else if (canReceive()) {
+        int rev = getevents(sck->fd(), incMsgsMask, pollTimeout);
         //if (rev & NN_IN == NN_IN) {
         if (rev > 0) {
             try {
-                rc = sck->recv(buf, MAX_MESSAGE_SIZE, 0);
+                rc = recvBuffer(0);
             } catch (...) {
                 return;
             }
-            if (rc > 0) {
-                std::unique_lock<std::mutex> ulck(mtxMsgLists);
-                memset((void*)(buf + rc), 0, MAX_MESSAGE_SIZE - rc);
-                iMsgList.push(MessageString(buf));
-            }
         }
     }
 }
 
+int ScalabilityProtocolRole::sendBuffer(MessageBuffer & m)
+{
+    // Ownership of the buffer is transferred to nanomsg only if the
+    // message is actually sent
+    void * msg = m.release();
+    int n;
+    try {
+        n = sck->send(&msg, NN_MSG, 0);
+    } catch (...) {
+        nn_freemsg(msg);
+        throw;
+    }
+    if (n < 0) {
+        nn_freemsg(msg);
+    } else {
+        countOut(n);
+    }
+    return n;
+}
+
+void ScalabilityProtocolRole::messageReceived()
+{
+    // Called for each message received, before the consumer can see it
+}
+
+int ScalabilityProtocolRole::recvBuffer(int flags)
+{
+    // Leave the message in the socket if there is no room for it
+    if (iMsgList.full()) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    void * msg = 0;
+    int n = sck->recv(&msg, NN_MSG, flags);
+    if (n > 0) {
+        countIn(n);
+        messageReceived();
+        // Only the receiving thread (the I/O thread, if any) pushes
+        // here, and it was checked above that there is room
+        (void)iMsgList.push(MessageBuffer::adopt(msg, n));
+        ++numRecv;
+    } else if (msg != 0) {
+        nn_freemsg(msg);
+    }
+    return n;
+}
+
 int ScalabilityProtocolRole::getevents(int s, int events, int timeout)
 {
     int rc;
@@ -5,51 +5,84 @@
 
 #include <nanomsg/nn.h>
 #include "nn.hpp"
+#include "msgbuf.h"
+#include "spscq.h"
+#include "latency.h"
 
 #include "err.h"
 #include "dbg.h"
 
 #include <string>
+#include <vector>
 #include <queue>
 #include <memory>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <linux/sockios.h>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 
 #define NN_IN             1
 #define NN_OUT            2
 
 #define NN_BUS_MASTER     NN_BUS & 0x8000
 
-#define MAX_MESSAGE_SIZE  65536 // 64KB!
-
 #define WAIT_BINDING      100000
 #define DEADLINE          100000
 
-typedef std::string                  MessageString;
+#define MSG_QUEUE_SIZE    4096
+
+// Longest wait for room in a full outbound queue (ms)
+#define MSG_OUT_WAIT      100
+
 typedef nn::socket                   Socket;
-typedef std::queue<MessageString>    MsgList;
+typedef SpscQueue<MessageBuffer>     MsgList;
+typedef std::function<void(const std::string &)> SendErrorHandler;
 
-class ScalabilityProtocolRole {
+class ScalabilityProtocolRole : public CacheAligned {
 public:
     ScalabilityProtocolRole();
-    ~ScalabilityProtocolRole();
+    virtual ~ScalabilityProtocolRole();
     virtual void createSocket(int protocol, int domain = AF_SP);
     virtual void update();
+    virtual bool next(MessageBuffer & m);
     virtual bool next(MessageString & m);
-    virtual void setMsgOut(MessageString m);
+    virtual bool setMsgOut(MessageBuffer m);
     virtual int getClass();
     virtual std::string getClassName();
     virtual std::string getName();
     virtual void setName(std::string & name);
     virtual std::string getAddress();
+    virtual void addBinding(std::string addr);
+    virtual bool canReceive();
+    bool hasMessages();
+    virtual bool owesReply();
+    virtual void releaseRequest();
+    virtual int getRecvFd();
+    virtual void setPollTimeout(int ms);
+    virtual void setDrainBudget(int n);
+    virtual void startIoThread();
+    virtual void stopIoThread();
+    void setSendErrorHandler(SendErrorHandler h);
+    ChannelStats & getStats();
 protected:
     virtual void init(int elemCls, const char * addr) = 0;
     virtual void getIncommingMessageStrings();
     virtual void processMessageString(MessageString & m) = 0;
+    virtual int sendBuffer(MessageBuffer & m);
+    virtual int recvBuffer(int flags);
+    virtual void messageReceived();
+    virtual void flushMsgsOut();
+    virtual int getSocketRecvFd();
+    void countOut(size_t n);
+    void countIn(size_t n);
+    void sendFailed(const std::string & why);
 private:
     static int getevents(int s, int events, int timeout);
+    void runIoThread();
 protected:
     Socket *    sck;
     MsgList     iMsgList;
@@ -58,11 +91,34 @@ protected:
     int         elemClass;
     std::string elemName;
     std::string address;
-    char        buf[MAX_MESSAGE_SIZE];
     int         rc;
     int         endPoint;
+    std::vector<int> extraEndPoints;
     int         incMsgsMask;
+    int         rcvFd;
+    int         pollTimeout;
+    int         drainBudget;
     std::mutex  mtxMsgLists;
+
+    // Producers waiting for room in oMsgList, and failures of the
+    // messages sent by the I/O thread, reported to the owner
+    std::condition_variable cvOutRoom;
+    std::atomic<int>        outWaiters;
+    SendErrorHandler        sendErrorHandler;
+
+    // When the I/O thread runs, it is the only one using the socket: it
+    // fills iMsgList, notifying the consumer through ioNotifyFd, and
+    // sends the messages queued in oMsgList, signalled through ioOutFd
+    std::thread       ioThr;
+    std::atomic<bool> ioRunning;
+    int               ioNotifyFd;
+    int               ioOutFd;
+    unsigned long     numRecv;
+
+    // Traffic and latency statistics; for REQ roles, the time the last
+    // request was sent (steady clock, ns) to measure the round trip
+    ChannelStats         stats;
+    std::atomic<int64_t> reqSentAt;
 };
 
 #endif
@@ -0,0 +1,416 @@
+#include "shmring.h"
+
+#include <cstring>
+#include <algorithm>
+#include <climits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <time.h>
+
+#define SHM_MAGIC         0x51504652u
+#define SHM_WRAP          UINT64_MAX
+#define SHM_MORE          (((uint64_t)(1)) << 63)
+#define SHM_ALIGN(n)      (((n) + 7) & ~((uint64_t)(7)))
+
+//-----------------------------------------------------------------------------
+// Shared layout: segment header, followed by the data of both rings.  Ring
+// 0 goes from the creator to the attached end, and ring 1 the other way.
+// Positions grow monotonically, and are taken modulo the ring size.  A
+// writer that finds no room sets full, and the reader wakes it up on the
+// futex of the other ring once it has made room.
+//-----------------------------------------------------------------------------
+struct ShmRing::Ring {
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) std::atomic<uint32_t> seq;
+    std::atomic<uint32_t>             waiting;
+    std::atomic<uint32_t>             full;
+};
+
+struct ShmRing::Segment {
+    std::atomic<uint32_t> magic;
+    std::atomic<uint32_t> closed;
+    uint64_t              ringSize;
+    Ring                  ring[2];
+};
+
+static int futex(std::atomic<uint32_t> * addr, int op, uint32_t val,
+                 const struct timespec * ts)
+{
+    return syscall(SYS_futex, (uint32_t*)(addr), op, val, ts, 0, 0);
+}
+
+//-----------------------------------------------------------------------------
+// ShmRing
+//-----------------------------------------------------------------------------
+ShmRing::ShmRing(int elemCls, std::string addr, size_t rsz)
+    : creator(false), ringSize(SHM_ALIGN(rsz)), seg(0), segSize(0), segIno(0),
+      rxRing(0), txRing(0), rxData(0), txData(0), txOffset(0), attached(false)
+{
+    init(elemCls, addr.c_str());
+}
+
+ShmRing::ShmRing(int elemCls, const char * addr, size_t rsz)
+    : creator(false), ringSize(SHM_ALIGN(rsz)), seg(0), segSize(0), segIno(0),
+      rxRing(0), txRing(0), rxData(0), txData(0), txOffset(0), attached(false)
+{
+    init(elemCls, addr);
+}
+
+ShmRing::~ShmRing()
+{
+    if (ioRunning) {
+        ioRunning = false;
+        if (seg != 0) {
+            rxRing->seq.fetch_add(1);
+            futex(&rxRing->seq, FUTEX_WAKE, INT_MAX, 0);
+        }
+        if (ioThr.joinable()) { ioThr.join(); }
+        close(ioNotifyFd); ioNotifyFd = -1;
+    }
+    detach();
+}
+
+bool ShmRing::isShmAddress(const std::string & addr)
+{
+    return addr.compare(0, strlen(SHM_PREFIX), SHM_PREFIX) == 0;
+}
+
+void ShmRing::init(int elemCls, const char * addr)
+{
+    elemClass = elemCls;
+    address   = std::string(addr);
+    creator   = (elemClass == NN_REP) || (elemClass == NN_PUSH);
+
+    std::string name = address.substr(strlen(SHM_PREFIX));
+    for (auto & c : name) { if (c == '/') { c = '_'; } }
+    shmName = "/qpf_" + name;
+
+    ioNotifyFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    readyToGo  = (ioNotifyFd >= 0);
+    if (!readyToGo) { return; }
+
+    if (creator) {
+        attach();
+        TRC("BIND >> " << address);
+    } else {
+        TRC("CONNECT >> " << address);
+    }
+
+    // The reader thread runs always, and also attaches to the segment
+    // when it does not exist yet
+    ioRunning = true;
+    ioThr = std::thread(&ShmRing::runReader, this);
+}
+
+bool ShmRing::attach()
+{
+    segSize = sizeof(Segment) + 2 * ringSize;
+    int fd;
+    if (creator) {
+        // A segment left by a previous run is discarded
+        (void)shm_unlink(shmName.c_str());
+        fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) { return false; }
+        if (ftruncate(fd, segSize) != 0) {
+            close(fd);
+            return false;
+        }
+    } else {
+        fd = shm_open(shmName.c_str(), O_RDWR, 0600);
+        if (fd < 0) { return false; }
+        struct stat st;
+        if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)(sizeof(Segment)))) {
+            close(fd);
+            return false;
+        }
+        segSize = st.st_size;
+        segIno  = st.st_ino;
+    }
+
+    void * p = mmap(0, segSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) { return false; }
+
+    Segment * s = (Segment *)(p);
+    if (creator) {
+        s->closed = 0;
+        s->ringSize = ringSize;
+        for (auto & r : s->ring) {
+            r.head = 0; r.tail = 0; r.seq = 0; r.waiting = 0; r.full = 0;
+        }
+        s->magic.store(SHM_MAGIC, std::memory_order_release);
+    } else if ((s->magic.load(std::memory_order_acquire) != SHM_MAGIC) ||
+               (s->closed != 0) ||
+               (segSize != sizeof(Segment) + 2 * s->ringSize)) {
+        munmap(p, segSize);
+        return false;
+    }
+
+    std::unique_lock<std::mutex> ulck(mtxMsgLists);
+    seg      = s;
+    ringSize = s->ringSize;
+    char * data = (char *)(p) + sizeof(Segment);
+    txRing   = &s->ring[creator ? 0 : 1];
+    rxRing   = &s->ring[creator ? 1 : 0];
+    txData   = data + (creator ? 0 : ringSize);
+    rxData   = data + (creator ? ringSize : 0);
+    txOffset = 0;
+    rxPartial.clear();
+    attached = true;
+    return true;
+}
+
+void ShmRing::detach()
+{
+    std::unique_lock<std::mutex> ulck(mtxMsgLists);
+    if (seg == 0) { return; }
+    if (creator) {
+        // Tell the other end to attach again to a new segment
+        seg->closed = 1;
+        futex(&seg->ring[0].seq, FUTEX_WAKE, INT_MAX, 0);
+        (void)shm_unlink(shmName.c_str());
+    }
+    munmap(seg, segSize);
+    seg = 0;
+    rxRing = txRing = 0;
+    rxData = txData = 0;
+    attached = false;
+}
+
+bool ShmRing::isAttached()
+{
+    return attached;
+}
+
+bool ShmRing::isStale()
+{
+    // The creator may have been restarted without closing the segment
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0600);
+    if (fd < 0) { return true; }
+    struct stat st;
+    bool stale = (fstat(fd, &st) != 0) || (st.st_ino != segIno);
+    close(fd);
+    return stale;
+}
+
+bool ShmRing::canReceive()
+{
+    return (elemClass != NN_PUSH);
+}
+
+bool ShmRing::setMsgOut(MessageBuffer m)
+{
+    if (!readyToGo || (elemClass == NN_PULL)) { return false; }
+
+    std::unique_lock<std::mutex> ulck(mtxMsgLists);
+    // Messages already waiting go first
+    if ((seg != 0) && oMsgList.empty() && write(m)) { return true; }
+    if (!oMsgList.push(std::move(m))) {
+        TRC(elemName << ": outbound queue full, message not sent");
+        return false;
+    } else if (seg != 0) {
+        // Let the reader thread retry when the ring has room
+        rxRing->seq.fetch_add(1);
+        futex(&rxRing->seq, FUTEX_WAKE, 1, 0);
+    }
+    return true;
+}
+
+void ShmRing::flushPending()
+{
+    std::unique_lock<std::mutex> ulck(mtxMsgLists);
+    if (seg == 0) { return; }
+    MessageBuffer * p;
+    MessageBuffer m;
+    while (((p = oMsgList.front()) != 0) && write(*p)) {
+        oMsgList.pop(m);
+    }
+}
+
+bool ShmRing::write(const MessageBuffer & m)
+{
+    // Messages that do not fit in half the ring go in several records,
+    // all but the last one flagged with SHM_MORE.  txOffset keeps the
+    // part of the message already written when the ring gets full
+    uint64_t maxLen = ((ringSize / 2) & ~((uint64_t)(7))) - sizeof(uint64_t);
+    while (txOffset < m.size()) {
+        uint64_t len  = std::min<uint64_t>(m.size() - txOffset, maxLen);
+        uint64_t flag = (txOffset + len < m.size()) ? SHM_MORE : 0;
+        if (!writeRecord(m.data() + txOffset, len, flag)) { return false; }
+        txOffset += len;
+    }
+    txOffset = 0;
+    countOut(m.size());
+    return true;
+}
+
+bool ShmRing::writeRecord(const char * data, uint64_t len, uint64_t flag)
+{
+    Ring & r = *txRing;
+    uint64_t rec  = sizeof(uint64_t) + SHM_ALIGN(len);
+    uint64_t head = r.head.load(std::memory_order_relaxed);
+    uint64_t pos  = head % ringSize;
+    uint64_t gap  = (pos + rec > ringSize) ? (ringSize - pos) : 0;
+    if (head + gap + rec - r.tail.load(std::memory_order_acquire) > ringSize) {
+        // Ask the reader for a wake up, and check again in case it made
+        // room meanwhile
+        r.full = 1;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (head + gap + rec - r.tail.load(std::memory_order_acquire) > ringSize) {
+            return false;
+        }
+    }
+
+    if (gap > 0) {
+        // Records are contiguous: skip the end of the ring
+        *(uint64_t *)(txData + pos) = SHM_WRAP;
+        head += gap;
+        pos = 0;
+    }
+    *(uint64_t *)(txData + pos) = len | flag;
+    memcpy(txData + pos + sizeof(uint64_t), data, len);
+    r.head.store(head + rec, std::memory_order_release);
+
+    r.seq.fetch_add(1);
+    if (r.waiting.load() != 0) {
+        futex(&r.seq, FUTEX_WAKE, 1, 0);
+    }
+    return true;
+}
+
+bool ShmRing::read()
+{
+    Ring & r = *rxRing;
+    uint64_t tail = r.tail.load(std::memory_order_relaxed);
+    uint64_t head = r.head.load(std::memory_order_acquire);
+    if (tail == head) { return false; }
+
+    uint64_t pos = tail % ringSize;
+    uint64_t hdr = *(uint64_t *)(rxData + pos);
+    if (hdr == SHM_WRAP) {
+        r.tail.store(tail + (ringSize - pos), std::memory_order_release);
+    } else {
+        uint64_t len = hdr & ~SHM_MORE;
+        const char * data = rxData + pos + sizeof(uint64_t);
+        if ((hdr & SHM_MORE) != 0) {
+            rxPartial.append(data, len);
+        } else if (rxPartial.empty()) {
+            // Only the reader thread pushes here
+            countIn(len);
+            if (iMsgList.push(MessageBuffer(data, len))) { ++numRecv; }
+        } else {
+            rxPartial.append(data, len);
+            countIn(rxPartial.size());
+            if (iMsgList.push(MessageBuffer(rxPartial.data(), rxPartial.size()))) {
+                ++numRecv;
+            }
+            rxPartial.clear();
+        }
+        r.tail.store(tail + sizeof(uint64_t) + SHM_ALIGN(len),
+                     std::memory_order_release);
+    }
+
+    // Wake up the writer if it is waiting for room
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (r.full.load() != 0) {
+        r.full = 0;
+        txRing->seq.fetch_add(1);
+        if (txRing->waiting.load() != 0) {
+            futex(&txRing->seq, FUTEX_WAKE, 1, 0);
+        }
+    }
+    return true;
+}
+
+void ShmRing::wait(Ring & r, int ms)
+{
+    // The writer bumps seq after publishing head, and wakes us up only if
+    // we are waiting: seq is read before checking for work, so that a
+    // message arriving meanwhile makes the futex wait return at once.  The
+    // same goes for the room made by the peer for our pending messages,
+    // and for the stop of the role.  With ms < 0 there is no timeout
+    r.waiting = 1;
+    uint32_t s = r.seq.load();
+    bool incoming = canReceive() && (r.head.load(std::memory_order_acquire) !=
+                                     r.tail.load(std::memory_order_relaxed));
+    bool room = !oMsgList.empty() && (txRing->full.load() == 0);
+    if (ioRunning && !incoming && !room) {
+        struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+        futex(&r.seq, FUTEX_WAIT, s, (ms < 0) ? 0 : &ts);
+    }
+    r.waiting = 0;
+}
+
+void ShmRing::runReader()
+{
+    int idle = 0;
+    while (ioRunning) {
+        if (seg == 0) {
+            if (!attach()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+        }
+        if (!creator && ((seg->closed != 0) ||
+                         ((idle >= 10) && isStale()))) {
+            detach();
+            continue;
+        }
+
+        flushPending();
+
+        // Read while there is room in the inbound queue
+        unsigned long before = numRecv;
+        bool more = canReceive();
+        while (more && !iMsgList.full()) {
+            more = read();
+        }
+        if (numRecv != before) {
+            uint64_t one = 1;
+            (void)::write(ioNotifyFd, &one, sizeof(one));
+        }
+
+        if (more) {
+            // The inbound queue is full: let the consumer take some
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } else if (numRecv == before) {
+            // Only the attached end needs to check the segment from time
+            // to time; the creator sleeps until there is something to do
+            wait(*rxRing, creator ? -1 : 100);
+            idle = (idle >= 10) ? 0 : (idle + 1);
+        } else {
+            idle = 0;
+        }
+    }
+}
+
+void ShmRing::startIoThread()
+{
+    // The reader thread is always running
+}
+
+void ShmRing::stopIoThread()
+{
+    // The reader thread lives as long as the role
+}
+
+void ShmRing::addBinding(std::string addr)
+{
+    TRC(elemName << ": shared memory rings have a single peer");
+}
+
+void ShmRing::getIncommingMessageStrings()
+{
+    // Messages are received by the reader thread
+}
+
+void ShmRing::processMessageString(MessageString & m)
+{
+    TRC("I (" << elemName << ") got a message: '" << m << "'");
+}
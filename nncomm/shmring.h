@@ -0,0 +1,72 @@
+// -*- C++ -*-
+
+#ifndef SHMRING_H
+#define SHMRING_H
+
+#include "scalprotrole.h"
+#include <nanomsg/reqrep.h>
+#include <nanomsg/pipeline.h>
+
+#include <cstdint>
+#include <sys/types.h>
+
+#define SHM_PREFIX        "shm://"
+#define SHM_RING_SIZE     (4 << 20)
+
+//-----------------------------------------------------------------------------
+// ShmRing
+// Role for peers living in different processes of the same host.  The
+// two ends share a memory segment with one ring buffer per direction, so
+// that each message costs a memcpy in and out of the ring.  The writer
+// wakes up the reader with a futex on the ring, and a reader thread
+// forwards the messages to the inbound queue, notifying the consumer
+// through an eventfd, as the I/O thread of the socket based roles does.
+// Messages larger than half the ring are sent in several records.
+// The REP and PUSH ends create the segment, and the REQ and PULL ends
+// attach to it (waiting for it to exist).  Addresses are "shm://name".
+//-----------------------------------------------------------------------------
+class ShmRing : public ScalabilityProtocolRole {
+public:
+    ShmRing(int elemCls, std::string addr, size_t ringSize = SHM_RING_SIZE);
+    ShmRing(int elemCls, const char * addr, size_t ringSize = SHM_RING_SIZE);
+    ~ShmRing();
+    virtual bool setMsgOut(MessageBuffer m);
+    virtual bool canReceive();
+    virtual void startIoThread();
+    virtual void stopIoThread();
+    virtual void addBinding(std::string addr);
+    bool isAttached();
+    static bool isShmAddress(const std::string & addr);
+protected:
+    virtual void init(int elemCls, const char * addr);
+    virtual void getIncommingMessageStrings();
+    virtual void processMessageString(MessageString & m);
+private:
+    struct Ring;
+    struct Segment;
+    bool attach();
+    void detach();
+    bool isStale();
+    bool write(const MessageBuffer & m);
+    bool writeRecord(const char * data, uint64_t len, uint64_t flag);
+    bool read();
+    void wait(Ring & r, int ms);
+    void runReader();
+    void flushPending();
+private:
+    bool           creator;
+    size_t         ringSize;
+    std::string    shmName;
+    Segment *      seg;
+    size_t         segSize;
+    ino_t          segIno;
+    Ring *         rxRing;
+    Ring *         txRing;
+    char *         rxData;
+    char *         txData;
+    size_t         txOffset;
+    std::string    rxPartial;
+    std::atomic<bool> attached;
+};
+
+#endif
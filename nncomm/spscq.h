@@ -0,0 +1,112 @@
+// -*- C++ -*-
+
+#ifndef SPSCQ_H
+#define SPSCQ_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#define CACHE_LINE_SIZE   64
+
+//-----------------------------------------------------------------------------
+// CacheAligned
+// Base of the classes with cache-line aligned members (such as an
+// SpscQueue) that are created with new: until C++17 the global operator
+// new does not honour alignments larger than that of max_align_t
+//-----------------------------------------------------------------------------
+struct CacheAligned {
+    static void * operator new(std::size_t n) { return allocate(n); }
+    static void * operator new[](std::size_t n) { return allocate(n); }
+    static void operator delete(void * p) { std::free(p); }
+    static void operator delete[](void * p) { std::free(p); }
+private:
+    static void * allocate(std::size_t n) {
+        void * p = 0;
+        if (posix_memalign(&p, CACHE_LINE_SIZE, n) != 0) { throw std::bad_alloc(); }
+        return p;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// SpscQueue
+// Bounded ring buffer for one producer thread and one consumer thread.
+// Each side owns its index, in a cache line of its own, together with a
+// cached copy of the other side's index, so that in the common case push()
+// and pop() touch no shared cache line but the slot itself.  push() fails
+// instead of waiting when the ring is full.
+//-----------------------------------------------------------------------------
+template<class T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t size = 1024) : head(0), tailCache(0),
+                                             tail(0), headCache(0) {
+        size_t n = 2;
+        while (n < size) { n <<= 1; }
+        mask = n - 1;
+        slots.resize(n);
+    }
+
+    // Producer side
+    bool push(T && x) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache > mask) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache > mask) { return false; }
+        }
+        slots[t & mask] = std::move(x);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T & x) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) { return false; }
+        }
+        x = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: oldest element, left in the queue (null if empty)
+    T * front() {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) { return 0; }
+        }
+        return &slots[h & mask];
+    }
+
+    // Approximate, when called while the other side is active
+    size_t size() const {
+        return (tail.load(std::memory_order_acquire) -
+                head.load(std::memory_order_acquire));
+    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() > mask; }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    SpscQueue(const SpscQueue &);
+    SpscQueue & operator=(const SpscQueue &);
+
+    // Consumer cache line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head;
+    size_t tailCache;
+
+    // Producer cache line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail;
+    size_t headCache;
+
+    alignas(CACHE_LINE_SIZE) size_t mask;
+    std::vector<T> slots;
+};
+
+#endif
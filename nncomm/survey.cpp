@@ -1,50 +1,70 @@
 #include "survey.h"
 
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
 //-----------------------------------------------------------------------------
 // Survey
 //-----------------------------------------------------------------------------
 Survey::Survey(int elemCls, std::string addr)
+    : results(64)
 {
     init(elemCls, addr.c_str());
 }
 
 Survey::Survey(int elemCls, const char * addr)
+    : results(64)
 {
     init(elemCls, addr);
 }
 
-void Survey::setMsgOut(MessageString m)
+Survey::~Survey()
 {
-    if (elemClass == NN_RESPONDENT) {
-        ScalabilityProtocolRole::setMsgOut(m);
-        //TRC("++ Sending answer >> " << m);
-    } else {
-        if (readyToGo) {
-            sck->send((void*)(m.c_str()), m.size(), 0);
-            surveyorWaiting = true;
-            //TRC("++ Sending msg >> " << m);
-            //TRC("++ Waiting for answers . . . ");
-            /*
-            int numResp = 1;
-            try {
-                rc = sck->recv(buf, sizeof(buf), 0);
-                if (rc == ETIMEDOUT) {
-                    TRC("ETIMEDOUT\n");
-                } else {
-                    while ((rc > 0) && (numResp < maxRespondents)) {
-                        TRC("++ Received answer: " << std::string(buf));
-                        numResp++;
-                        rc = sck->recv(buf, sizeof(buf), 0);
-                        if (rc == ETIMEDOUT) {
-                            TRC("ETIMEDOUT\n");
-                        }
-                    }
-                    }
-            } catch (nn::exception & e) {
-                TRC("---- Only " << numResp << " responses");
-                }*/
-        }
+    stopIoThread();
+    if (timerFd >= 0) { close(timerFd); }
+    if (pollFd >= 0)  { close(pollFd); }
+}
+
+void Survey::update()
+{
+    ScalabilityProtocolRole::update();
+
+    if (handler) {
+        SurveyResult r;
+        while (results.pop(r)) { handler(r); }
+    }
+}
+
+bool Survey::setMsgOut(MessageBuffer m)
+{
+    // Surveys go through the same path as any other message, so they
+    // are sent by the I/O thread when there is one
+    return ScalabilityProtocolRole::setMsgOut(std::move(m));
+}
+
+int Survey::sendBuffer(MessageBuffer & m)
+{
+    if (elemClass != NN_SURVEYOR) {
+        return ScalabilityProtocolRole::sendBuffer(m);
     }
+
+    // A new survey cancels the previous one in nanomsg, so what was
+    // collected so far is delivered first
+    if (surveyorWaiting) { closeSurvey(); }
+
+    current.id++;
+    current.responses.clear();
+    current.expected = maxRespondents;
+    current.complete = false;
+
+    int n = ScalabilityProtocolRole::sendBuffer(m);
+    if (n >= 0) {
+        surveyEnd = (std::chrono::steady_clock::now() +
+                     std::chrono::milliseconds(deadline));
+        armDeadline(deadline);
+        surveyorWaiting = true;
+    }
+    return n;
 }
 
 void Survey::setNumOfRespondents(int r)
@@ -52,14 +72,45 @@ void Survey::setNumOfRespondents(int r)
     maxRespondents = r;
 }
 
+void Survey::setDeadline(int ms)
+{
+    deadline = ms;
+    if (elemClass == NN_SURVEYOR) {
+        sck->setsockopt(NN_SURVEYOR, NN_SURVEYOR_DEADLINE, &deadline, sizeof(int));
+    }
+}
+
+void Survey::setResultHandler(SurveyHandler h)
+{
+    handler = h;
+}
+
+bool Survey::nextResult(SurveyResult & r)
+{
+    return results.pop(r);
+}
+
 void Survey::init(int elemCls, const char * addr)
 {
     elemClass = elemCls;
     createSocket(elemClass);
     surveyorWaiting = false;
+    maxRespondents = 0;
+    current.id = 0;
+    timerFd = -1;
+    pollFd = -1;
     if (elemClass == NN_SURVEYOR) {
-        //int deadline = WAIT_BINDING;
-        //sck->setsockopt(NN_SURVEYOR, NN_SURVEYOR_DEADLINE, &deadline, sizeof(int));
+        setDeadline(SURVEY_DEADLINE);
+        // Answers and deadline are waited for through a single descriptor
+        timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        pollFd  = epoll_create1(EPOLL_CLOEXEC);
+        int sckFd = ScalabilityProtocolRole::getSocketRecvFd();
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = timerFd;
+        epoll_ctl(pollFd, EPOLL_CTL_ADD, timerFd, &ev);
+        ev.data.fd = sckFd;
+        epoll_ctl(pollFd, EPOLL_CTL_ADD, sckFd, &ev);
         endPoint = sck->bind(addr);
         TRC("BIND >> " << addr);
     } else {
@@ -70,13 +121,82 @@ void Survey::init(int elemCls, const char * addr)
     (void)usleep(WAIT_BINDING);
 }
 
+void Survey::armDeadline(int ms)
+{
+    struct itimerspec its = {{0, 0}, {ms / 1000, (ms % 1000) * 1000000L}};
+    timerfd_settime(timerFd, 0, &its, 0);
+}
+
+bool Survey::canReceive()
+{
+    return ((elemClass == NN_RESPONDENT) || (surveyorWaiting));
+}
+
+int Survey::getSocketRecvFd()
+{
+    if (elemClass == NN_SURVEYOR) { return pollFd; }
+    return ScalabilityProtocolRole::getSocketRecvFd();
+}
+
 void Survey::getIncommingMessageStrings()
 {
-    if ((elemClass == NN_RESPONDENT) || (surveyorWaiting)) {
+    if (elemClass == NN_RESPONDENT) {
         ScalabilityProtocolRole::getIncommingMessageStrings();
-        surveyorWaiting = ((iMsgList.size() >= maxRespondents) ||
-                           (errno == ETIMEDOUT));
+        return;
+    }
+    if (!surveyorWaiting) { return; }
+
+    // Take the answers available, without waiting
+    int err = EAGAIN;
+    try {
+        while (recvBuffer(NN_DONTWAIT) >= 0) {}
+    } catch (nn::exception & e) {
+        // ETIMEDOUT: deadline reached in nanomsg
+        err = e.num();
+    }
+
+    bool allAnswered = ((current.expected > 0) &&
+                        (current.responses.size() >=
+                         static_cast<size_t>(current.expected)));
+    if (allAnswered || (err != EAGAIN) ||
+        (std::chrono::steady_clock::now() >= surveyEnd)) {
+        current.complete = allAnswered;
+        closeSurvey();
+    }
+}
+
+int Survey::recvBuffer(int flags)
+{
+    if (elemClass != NN_SURVEYOR) {
+        return ScalabilityProtocolRole::recvBuffer(flags);
+    }
+
+    // Answers are kept apart, and delivered together with closeSurvey()
+    void * msg = 0;
+    int n = sck->recv(&msg, NN_MSG, flags);
+    if (n >= 0) {
+        countIn(n);
+        current.responses.push_back(MessageBuffer::adopt(msg, n));
+    } else if (msg != 0) {
+        nn_freemsg(msg);
+    }
+    return n;
+}
+
+void Survey::closeSurvey()
+{
+    surveyorWaiting = false;
+    armDeadline(0);
+    uint64_t n;
+    (void)read(timerFd, &n, sizeof(n));
+
+    TRC("Survey " << current.id << " closed with "
+        << current.responses.size() << " answers");
+    if (!results.push(std::move(current))) {
+        TRC(elemName << ": survey result dropped");
     }
+    // Wake up the owner, as for any incoming message
+    ++numRecv;
 }
 
 void Survey::processMessageString(MessageString & m)
@@ -8,22 +8,66 @@
 
 #include "nncommon.h"
 
+#include <vector>
+#include <chrono>
+#include <functional>
+
+#define SURVEY_DEADLINE   1000
+
+//-----------------------------------------------------------------------------
+// SurveyResult
+// Answers collected for a survey, delivered at once when all the expected
+// respondents have answered, or when the deadline expires
+//-----------------------------------------------------------------------------
+struct SurveyResult {
+    unsigned long              id;
+    std::vector<MessageBuffer> responses;
+    int                        expected;
+    bool                       complete;
+};
+
+typedef std::function<void(SurveyResult &)> SurveyHandler;
+
 //-----------------------------------------------------------------------------
 // Survey
+// The surveyor never waits for the answers: they are collected without
+// blocking as they arrive, and a timer (polled together with the socket)
+// closes the survey at its deadline.  Results are passed to the handler,
+// if set, from update(), i.e. in the thread of the owner of the role;
+// otherwise they are retrieved with nextResult().
 //-----------------------------------------------------------------------------
 class Survey : public ScalabilityProtocolRole {
 public:
     Survey(int elemCls, std::string addr);
     Survey(int elemCls, const char * addr);
-    virtual void setMsgOut(MessageString m);
+    ~Survey();
+    virtual void update();
+    virtual bool setMsgOut(MessageBuffer m);
+    virtual bool canReceive();
     void setNumOfRespondents(int r);
+    void setDeadline(int ms);
+    void setResultHandler(SurveyHandler h);
+    bool nextResult(SurveyResult & r);
 protected:
     virtual void init(int elemCls, const char * addr);
     virtual void getIncommingMessageStrings();
     virtual void processMessageString(MessageString & m);
+    virtual int sendBuffer(MessageBuffer & m);
+    virtual int recvBuffer(int flags);
+    virtual int getSocketRecvFd();
+private:
+    void armDeadline(int ms);
+    void closeSurvey();
 private:
     int maxRespondents;
-    bool surveyorWaiting;
+    int deadline;
+    std::atomic<bool> surveyorWaiting;
+    std::chrono::steady_clock::time_point surveyEnd;
+    SurveyResult current;
+    SpscQueue<SurveyResult> results;
+    SurveyHandler handler;
+    int timerFd;
+    int pollFd;
 };
 
 #endif
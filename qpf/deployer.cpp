@@ -44,6 +44,7 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <algorithm>
 
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -55,9 +56,11 @@
 #include "pubsub.h"
 #include "reqrep.h"
 #include "pipeline.h"
+#include "shmring.h"
 
 #include "message.h"
 #include "channels.h"
+#include "chnlreg.h"
 #include "config.h"
 #include "str.h"
 #include "dbg.h"
@@ -517,6 +520,12 @@ void Deployer::createElementsNetwork()
     // 3. Create the connections
     // ======================================================================
 
+    // Register the per-agent channels, so that components can refer to
+    // all the channels by their ids from now on
+    for (auto & a : agName) {
+        ChannelRegistry::intern(ChnlTskProc + "_" + a);
+    }
+
     //=== PROCESSING HOSTS =========================================
     if (! isMasterHost) {
 
@@ -535,10 +544,8 @@ void Deployer::createElementsNetwork()
 
         // CHANNEL TASK-PROCESSING - REQREP
         // - Out/In: TskAge*/TskMng
-        // Note that this channel is used to send from TskAgents to TskManager:
-        // 1. Processing requests
-        // 2. Processing status reports
-        // 3. Processing completion messages
+        // Note that this channel is only used for the processing requests
+        // of the TskAgents, and the tasks sent by the TskManager in reply
         int j = 0;
         for (auto & p : cfg.agPortTsk) {
             auto & a = ag.at(j);
@@ -551,6 +558,23 @@ void Deployer::createElementsNetwork()
             ++j;
         }
 
+        // CHANNEL TASK-REPORTING - PIPELINE
+        // - Pushers: TskAge*
+        // - Puller: TskMng
+        // Processing status reports and host monitoring information go
+        // through this channel, so that they do not cancel the requests
+        // waiting for their reply in TSKPROC
+        chnl     = ChnlTskRep;
+        TRC("### Connections for channel " << chnl);
+        connAddr = "tcp://" + masterAddress + ":" +
+            str::toStr<int>(initialPort + PortTskRepDist);
+        for (auto & a : ag) {
+            if (a != 0) {
+                a->addConnection(chnl, new Pipeline(NN_PUSH, connAddr,
+                                                    Pipeline::PullerBinds));
+            }
+        }
+
         return;
     }
 
@@ -569,11 +593,16 @@ void Deployer::createElementsNetwork()
     // CHANNEL CMD - PUBSUB
     // - Publisher: EvtMng
     // - Subscribers: TskAge*
+    // The agents living in this process subscribe in-process, the rest
+    // through TCP, so the publisher binds to both transports if needed
     chnl     = ChnlCmd;
     TRC("### Connections for channel " << chnl);
-    bindAddr = "tcp://" + masterAddress + ":" + str::toStr<int>(initialPort);
-    m.evtMng->addConnection(chnl, new PubSub(NN_PUB, bindAddr));
-    connAddr = bindAddr;
+    bool remoteAgents = std::find(ag.begin(), ag.end(), (CommNode*)(0)) != ag.end();
+    bindAddr = chnlAddress(chnl, initialPort, remoteAgents ? RemoteHost : SameProcess);
+    PubSub * cmdPub = new PubSub(NN_PUB, bindAddr);
+    connAddr = chnlAddress(chnl, initialPort, SameProcess);
+    if (remoteAgents) { cmdPub->addBinding(connAddr); }
+    m.evtMng->addConnection(chnl, cmdPub);
     for (auto & c : ag) {
         if (c != 0) {
             c->addConnection(chnl, new PubSub(NN_SUB, connAddr));
@@ -589,17 +618,15 @@ void Deployer::createElementsNetwork()
 
     // CHANNEL TASK-PROCESSING - REQREP
     // - Out/In: TskAge*/TskMng
-    // Note that this channel is used to send from TskAgents to TskManager:
-    // 1. Processing requests
-    // 2. Processing status reports
-    // 3. Processing completion messages
+    // Note that this channel is only used for the processing requests
+    // of the TskAgents, and the tasks sent by the TskManager in reply
     int k = 0;
     for (auto & p : agPortTsk) {
         chnl = ChnlTskProc + "_" + agName.at(k);
         TRC("### Connections for channel " << chnl);
-        bindAddr = "tcp://" + masterAddress + ":" + str::toStr<int>(p);
-        m.tskMng->addConnection(chnl, new ReqRep(NN_REP, bindAddr));
         auto & a = ag.at(k);
+        bindAddr = chnlAddress(chnl, p, (a != 0) ? SameProcess : RemoteHost);
+        m.tskMng->addConnection(chnl, new ReqRep(NN_REP, bindAddr));
         if (a != 0) {
             connAddr = bindAddr;
             a->addConnection(chnl, new ReqRep(NN_REQ, connAddr));
@@ -607,14 +634,32 @@ void Deployer::createElementsNetwork()
         ++k;
     }
 
+    // CHANNEL TASK-REPORTING - PIPELINE
+    // - Pushers: TskAge*
+    // - Puller: TskMng
+    // As for CMD, the puller binds to both transports if needed
+    chnl     = ChnlTskRep;
+    TRC("### Connections for channel " << chnl);
+    bindAddr = chnlAddress(chnl, initialPort + PortTskRepDist,
+                           remoteAgents ? RemoteHost : SameProcess);
+    Pipeline * tskRepPull = new Pipeline(NN_PULL, bindAddr, Pipeline::PullerBinds);
+    connAddr = chnlAddress(chnl, initialPort + PortTskRepDist, SameProcess);
+    if (remoteAgents) { tskRepPull->addBinding(connAddr); }
+    m.tskMng->addConnection(chnl, tskRepPull);
+    for (auto & c : ag) {
+        if (c != 0) {
+            c->addConnection(chnl, new Pipeline(NN_PUSH, connAddr,
+                                                Pipeline::PullerBinds));
+        }
+    }
+
     // CHANNEL FRAMEWORK MONITORING - PIPELINE
     // - Requester: EvtMng
     // - Replier: QPFHMI
     chnl     = ChnlFmkMon;
     TRC("### Connections for channel " << chnl);
-    bindAddr = "ipc:///tmp/" + chnl + ".ipc";
-    connAddr = bindAddr;
-    m.evtMng->addConnection(chnl, new Pipeline(NN_PUSH, bindAddr));
+    bindAddr = chnlAddress(chnl, 0, SameHost);
+    m.evtMng->addConnection(chnl, new ShmRing(NN_PUSH, bindAddr));
     // PULL end is created by HMIProxy
 
     //=== FINALLY, CREATE MASTER COMPONENT ============================
@@ -624,3 +669,24 @@ void Deployer::createElementsNetwork()
     m.master->setTskMng(m.tskMng);
     m.master->init();
 }
+
+//----------------------------------------------------------------------
+// Method: chnlAddress
+// Selects the transport for a channel from the locality of its ends:
+// in-process for the same process, shared memory for the same host, and
+// TCP (on the given port of the master host) otherwise
+//----------------------------------------------------------------------
+std::string Deployer::chnlAddress(std::string chnl, int port, Locality loc)
+{
+    switch (loc) {
+    case SameProcess:
+        // Message buffers are handed over between the sockets, without
+        // copies and without going through the kernel
+        return "inproc://" + chnl;
+    case SameHost:
+        // Peers in other processes of this host share a memory segment
+        return SHM_PREFIX + chnl;
+    default:
+        return "tcp://" + masterAddress + ":" + str::toStr<int>(port);
+    }
+}
@@ -193,6 +193,20 @@ private:
     //----------------------------------------------------------------------
     void createElementsNetwork();
 
+    //----------------------------------------------------------------------
+    // Enum: Locality
+    // Where the two ends of a channel live, with respect to each other
+    //----------------------------------------------------------------------
+    enum Locality { SameProcess, SameHost, RemoteHost };
+
+    //----------------------------------------------------------------------
+    // Method: chnlAddress
+    // Selects the transport for a channel from the locality of its ends:
+    // in-process for the same process, shared memory for the same host,
+    // and TCP (on the given port of the master host) otherwise
+    //----------------------------------------------------------------------
+    std::string chnlAddress(std::string chnl, int port, Locality loc);
+
     //----------------------------------------------------------------------
     // generateProcFmkInfoStructure
     //----------------------------------------------------------------------
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * File:    qpfjrnl.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.QPF.qpfjrnl
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Export selected records of a component message journal as .mson
+ *   files (one JSON message per file), or list them
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   MsgJournalReader, MsgCodec
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "msgjournal.h"
+#include "msgcodec.h"
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <climits>
+#include <unistd.h>
+
+//----------------------------------------------------------------------
+// Function: usage
+//----------------------------------------------------------------------
+static void usage(const char * exe, int code)
+{
+    std::cerr << "Usage: " << exe << " -n name [ -d dir ] [ -f from ] [ -t to ]\n"
+              << "          [ -c channel ] [ -o outDir ] [ -l ] [ -h ]\n"
+              << "where:\n"
+              << "\t-n name     Name of the component that wrote the journal\n"
+              << "\t-d dir      Directory of the journal (default: .)\n"
+              << "\t-f from     Export records from this time on\n"
+              << "\t-t to       Export records up to this time\n"
+              << "\t            (times as YYYY-mm-ddTHH:MM:SS in UTC, or\n"
+              << "\t            as seconds since the epoch)\n"
+              << "\t-c channel  Export only records of this channel\n"
+              << "\t-o outDir   Directory for the .mson files (default: .)\n"
+              << "\t-l          List the records instead of exporting them\n"
+              << "\t-h          Shows this help message.\n";
+    exit(code);
+}
+
+//----------------------------------------------------------------------
+// Function: parseTime
+// Return the time in ns since the epoch
+//----------------------------------------------------------------------
+static int64_t parseTime(const char * s)
+{
+    struct tm t = {};
+    const char * end = strptime(s, "%Y-%m-%dT%H:%M:%S", &t);
+    if ((end != 0) && (*end == 0)) {
+        return (int64_t)(timegm(&t)) * 1000000000LL;
+    }
+    return (int64_t)(atof(s) * 1.0e9);
+}
+
+//----------------------------------------------------------------------
+// Function: main
+//----------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    std::string name;
+    std::string dir(".");
+    std::string outDir(".");
+    std::string chnl;
+    int64_t fromNs = 0;
+    int64_t toNs   = LLONG_MAX;
+    bool listOnly  = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "hln:d:f:t:c:o:")) != -1) {
+        switch (opt) {
+        case 'n': name   = std::string(optarg); break;
+        case 'd': dir    = std::string(optarg); break;
+        case 'o': outDir = std::string(optarg); break;
+        case 'c': chnl   = std::string(optarg); break;
+        case 'f': fromNs = parseTime(optarg);   break;
+        case 't': toNs   = parseTime(optarg);   break;
+        case 'l': listOnly = true;              break;
+        case 'h': usage(argv[0], EXIT_SUCCESS);
+        default:  usage(argv[0], EXIT_FAILURE);
+        }
+    }
+    if (name.empty()) { usage(argv[0], EXIT_FAILURE); }
+
+    MsgJournalReader reader(dir, name);
+    reader.seek(fromNs);
+
+    MsgJournalReader::Record r;
+    int numRecs = 0;
+    char fileName[1024];
+    while (reader.next(r)) {
+        if (r.timeNs > toNs) { break; }
+        if ((! chnl.empty()) && (r.chnl != chnl)) { continue; }
+
+        long long sec  = r.timeNs / 1000000000LL;
+        long      nsec = (long)(r.timeNs % 1000000000LL);
+        if (listOnly) {
+            char line[256];
+            snprintf(line, sizeof(line), "%lld.%09ld %c %-24s %8lu",
+                     sec, nsec, r.dir, r.chnl.c_str(), (unsigned long)(r.length));
+            std::cout << line << '\n';
+        } else {
+            snprintf(fileName, sizeof(fileName), "%s/%lld.%09ld_%s_%c_%s.mson",
+                     outDir.c_str(), sec, nsec, name.c_str(), r.dir, r.chnl.c_str());
+            FILE * fHdl = fopen(fileName, "w");
+            if (fHdl == 0) {
+                perror(fileName);
+                return EXIT_FAILURE;
+            }
+            std::string content = MsgCodec::toJsonStr(r.data, r.length);
+            fwrite(content.data(), 1, content.size(), fHdl);
+            fclose(fHdl);
+        }
+        ++numRecs;
+    }
+
+    std::cerr << numRecs << " records " << (listOnly ? "found" : "exported") << '\n';
+    return EXIT_SUCCESS;
+}
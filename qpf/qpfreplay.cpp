@@ -0,0 +1,178 @@
+/******************************************************************************
+ * File:    qpfreplay.cpp
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.qpfreplay
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Replay captured messages into a single component, offline
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   ReplayEngine, TskMng, EvtMng, TskOrc, DataMng
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+
+#include "replay.h"
+#include "config.h"
+#include "tskmng.h"
+#include "evtmng.h"
+#include "tskorc.h"
+#include "datamng.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <ctime>
+#include <climits>
+#include <unistd.h>
+
+using Configuration::cfg;
+
+//----------------------------------------------------------------------
+// Function: usage
+//----------------------------------------------------------------------
+static void usage(const char * exe, int code)
+{
+    std::cerr << "Usage: " << exe << " -c cfgFile -k class -n name\n"
+              << "          ( -j jrnlDir | -m msonDir ) [ -f from ] [ -t to ]\n"
+              << "          [ -x speed ] [ -o outDir ] [ -h ]\n"
+              << "where:\n"
+              << "\t-c cfgFile  Configuration file (JSON)\n"
+              << "\t-k class    Component class: TskMng, EvtMng, TskOrc or DataMng\n"
+              << "\t-n name     Name of the component that captured the messages\n"
+              << "\t-j jrnlDir  Directory of the message journal\n"
+              << "\t-m msonDir  Directory of the .mson message dumps\n"
+              << "\t-f from     Replay messages from this time on\n"
+              << "\t-t to       Replay messages up to this time\n"
+              << "\t            (times as YYYY-mm-ddTHH:MM:SS in UTC, or\n"
+              << "\t            as seconds since the epoch)\n"
+              << "\t-x speed    Replay speed factor, 0 for no waits (default: 1)\n"
+              << "\t-o outDir   Directory for the outputs and logs (default: .)\n"
+              << "\t-h          Shows this help message.\n";
+    exit(code);
+}
+
+//----------------------------------------------------------------------
+// Function: parseTime
+// Return the time in ns since the epoch
+//----------------------------------------------------------------------
+static int64_t parseTime(const char * s)
+{
+    struct tm t = {};
+    const char * end = strptime(s, "%Y-%m-%dT%H:%M:%S", &t);
+    if ((end != 0) && (*end == 0)) {
+        return (int64_t)(timegm(&t)) * 1000000000LL;
+    }
+    return (int64_t)(atof(s) * 1.0e9);
+}
+
+//----------------------------------------------------------------------
+// Function: createComponent
+// Create the component, with no address (no thread, no sockets)
+//----------------------------------------------------------------------
+static Component * createComponent(std::string & cls, std::string & name)
+{
+    if (cls == "TskMng")  { return new TskMng(name);  }
+    if (cls == "EvtMng")  { return new EvtMng(name);  }
+    if (cls == "TskOrc")  { return new TskOrc(name);  }
+    if (cls == "DataMng") { return new DataMng(name); }
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// Function: main
+//----------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    std::string cfgFile;
+    std::string cls;
+    std::string name;
+    std::string jrnlDir;
+    std::string msonDir;
+    std::string outDir(".");
+    int64_t fromNs = 0;
+    int64_t toNs   = LLONG_MAX;
+    double speed   = 1.0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "hc:k:n:j:m:f:t:x:o:")) != -1) {
+        switch (opt) {
+        case 'c': cfgFile = std::string(optarg); break;
+        case 'k': cls     = std::string(optarg); break;
+        case 'n': name    = std::string(optarg); break;
+        case 'j': jrnlDir = std::string(optarg); break;
+        case 'm': msonDir = std::string(optarg); break;
+        case 'o': outDir  = std::string(optarg); break;
+        case 'f': fromNs  = parseTime(optarg);   break;
+        case 't': toNs    = parseTime(optarg);   break;
+        case 'x': speed   = atof(optarg);        break;
+        case 'h': usage(argv[0], EXIT_SUCCESS);
+        default:  usage(argv[0], EXIT_FAILURE);
+        }
+    }
+    if (cfgFile.empty() || cls.empty() || name.empty() ||
+        (jrnlDir.empty() == msonDir.empty())) { usage(argv[0], EXIT_FAILURE); }
+
+    // Take the configuration from the file, without storing it in the DB
+    std::ifstream fCfg(cfgFile);
+    std::stringstream buffer;
+    buffer << fCfg.rdbuf();
+    json cfgValue;
+    Json::Reader reader;
+    if (! reader.parse(buffer.str(), cfgValue)) {
+        std::cerr << "Cannot parse configuration file " << cfgFile << '\n';
+        return EXIT_FAILURE;
+    }
+    cfg.init(cfgValue);
+
+    Log::setLogBaseDir(outDir);
+
+    Component * comp = createComponent(cls, name);
+    if (comp == 0) { usage(argv[0], EXIT_FAILURE); }
+
+    ReplayEngine engine(comp, outDir);
+    for (int i = 0; i < TX_ID_UNKNOWN; ++i) {
+        engine.addChannel(ChannelAcronym[i]);
+    }
+    for (auto & agName : cfg.agentNames) {
+        engine.addChannel(ChnlTskProc + "_" + agName);
+    }
+
+    int numMsgs = (jrnlDir.empty() ?
+                   engine.loadMsonDir(msonDir) :
+                   engine.loadJournal(jrnlDir, name, MsgJournal::Recv, fromNs, toNs));
+    std::cerr << numMsgs << " messages loaded\n";
+
+    engine.run(speed);
+    engine.report(std::cout);
+
+    return EXIT_SUCCESS;
+}
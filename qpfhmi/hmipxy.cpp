@@ -108,16 +108,16 @@ void HMIProxy::runEachIteration()
         }
 
         msg.buildBody(body);
-        send(ChnlHMICmd, msg.str());
+        send(ChnlHMICmd, msg);
     }
 }
 
 //----------------------------------------------------------------------
 // Method: processHMICmdMsg
 //----------------------------------------------------------------------
-void HMIProxy::processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m)
+void HMIProxy::processHMICmdMsg(ScalabilityProtocolRole* c, MessageBase & m)
 {
-    Message<MsgBodyCMD> msg(m);
+    Message<MsgBodyCMD> msg(std::move(m));
     std::string cmd = msg.body["cmd"].asString();
     if (cmd == CmdStates) {
         
@@ -165,15 +165,17 @@ void HMIProxy::processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m)
 //----------------------------------------------------------------------
 // Method: processFmkMonMsg
 //----------------------------------------------------------------------
-void HMIProxy::processFmkMonMsg(ScalabilityProtocolRole* c, MessageString & m)
+void HMIProxy::processFmkMonMsg(ScalabilityProtocolRole* c, MessageBase & m)
 {
-    Message<MsgBodyTSK> msg(m);
+    Message<MsgBodyTSK> msg(std::move(m));
     MsgBodyTSK & body = msg.body;
     JValue fmkInfoData(body["info"]);
 
     TraceMsg(fmkInfoData.str());
-    TraceMsg(Config::procFmkInfo->toJsonStr());
-    Config::procFmkInfo->fromStr(fmkInfoData.str());
+    if (! Config::procFmkInfo->applyDelta(fmkInfoData.str())) {
+        TraceMsg("FMK info update out of sequence, waiting for keyframe");
+        return;
+    }
     TraceMsg("@@@@@@@@@@ RECEIVED UOPDATE OF FMK INFO @@@@@@@@@@");
 }
 
@@ -214,7 +216,7 @@ void HMIProxy::sendProcHdlCmd(SubjectId subj, std::string subjName, SubcmdId sub
     body["target"]      = subjName;
 
     msg.buildBody(body);
-    send(ChnlHMICmd, msg.str()); 
+    send(ChnlHMICmd, msg); 
     TraceMsg("Sending message: " + msg.str());
 }
 
@@ -246,7 +248,7 @@ void HMIProxy::sendReprocCmd(ProductList & reprocList, int flags)
     body["flags"]       = flags;
     
     msg.buildBody(body);
-    send(ChnlHMICmd, msg.str()); 
+    send(ChnlHMICmd, msg); 
     TraceMsg("Sending message: " + msg.str());
 }
 
@@ -267,7 +269,7 @@ void HMIProxy::sendNewConfig()
     body["config"]      = cfg.str();
 
     msg.buildBody(body);
-    send(ChnlHMICmd, msg.str()); 
+    send(ChnlHMICmd, msg); 
     TRC("Sending message: " + msg.str());
 }
 
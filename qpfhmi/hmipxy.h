@@ -156,12 +156,12 @@ protected:
     //----------------------------------------------------------------------
     // Method: processHMICmdMsg
     //----------------------------------------------------------------------
-    virtual void processHMICmdMsg(ScalabilityProtocolRole* c, MessageString & m);
+    virtual void processHMICmdMsg(ScalabilityProtocolRole* c, MessageBase & m);
 
     //----------------------------------------------------------------------
     // Method: processFmkMonMsg
     //----------------------------------------------------------------------
-    virtual void processFmkMonMsg(ScalabilityProtocolRole* c, MessageString & m);
+    virtual void processFmkMonMsg(ScalabilityProtocolRole* c, MessageBase & m);
 
 private:
     bool requestQuit;
@@ -110,6 +110,7 @@
 #include "reqrep.h"
 #include "pubsub.h"
 #include "pipeline.h"
+#include "shmring.h"
 
 #include "launcher.h"
 
@@ -918,8 +919,8 @@ void MainWindow::init()
     // - Requester: TskMng
     // - Replier: QPFHMI
     chnl      = ChnlFmkMon;
-    connAddr  = "ipc:///tmp/" + chnl + ".ipc";
-    hmiNode->addConnection(chnl, new Pipeline(NN_PULL, connAddr));
+    connAddr  = SHM_PREFIX + chnl;
+    hmiNode->addConnection(chnl, new ShmRing(NN_PULL, connAddr));
 
     // START!
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
@@ -72,7 +72,8 @@ CREATE TABLE alerts (
     origin     text,
     msgs       text,
     file       text,
-    var        alert_variable
+    var        alert_variable,
+    repeats    integer DEFAULT 1
 );
 
 ALTER TABLE alerts OWNER TO eucops;
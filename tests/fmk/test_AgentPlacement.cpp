@@ -0,0 +1,62 @@
+#include "test_AgentPlacement.h"
+
+namespace TestAgentPlacement {
+
+static HostInfo mkHost(int cpus, float load1min, unsigned long memTotal = 0,
+                       unsigned long memAvailable = 0)
+{
+    HostInfo h;
+    h.cpuInfo.numCpus       = cpus;
+    h.loadAvg.load1min      = load1min;
+    h.memInfo.memTotal      = memTotal;
+    h.memInfo.memAvailable  = memAvailable;
+    return h;
+}
+
+static AgentPlacement::Candidate mkCand(const std::string & name, const HostInfo & h,
+                                        int agentTasks, int hostTasks)
+{
+    AgentPlacement::Candidate c;
+    c.name       = name;
+    c.hostInfo   = &h;
+    c.agentTasks = agentTasks;
+    c.hostTasks  = hostTasks;
+    return c;
+}
+
+TEST_F(TestAgentPlacement, Test_leastLoaded) {
+    HostInfo busy = mkHost(8, 6.0);
+    HostInfo idle = mkHost(8, 1.0);
+    AgentPlacement p(AgentPlacement::LeastLoaded);
+    EXPECT_EQ(p.select({mkCand("a", busy, 0, 2), mkCand("b", idle, 1, 1)}), "b");
+    EXPECT_NEAR(AgentPlacement::utilisation(mkCand("a", busy, 0, 2)), 0.75, 1.e-6);
+}
+
+TEST_F(TestAgentPlacement, Test_limits) {
+    HostInfo overloaded = mkHost(4, 60.0);
+    HostInfo noMemory   = mkHost(4, 0.5, 1000000, 10000);
+    AgentPlacement p(AgentPlacement::LeastLoaded, 1.5, 0.05);
+    EXPECT_EQ(p.select({mkCand("a", overloaded, 0, 0)}), "");
+    EXPECT_EQ(p.select({mkCand("a", overloaded, 0, 0), mkCand("b", noMemory, 0, 0)}), "");
+
+    // Tasks already sent count even if the load average does not show them
+    HostInfo quiet = mkHost(2, 0.0);
+    EXPECT_EQ(p.select({mkCand("c", quiet, 3, 3)}), "");
+    EXPECT_EQ(p.select({mkCand("c", quiet, 1, 1)}), "c");
+}
+
+TEST_F(TestAgentPlacement, Test_policies) {
+    HostInfo h1 = mkHost(8, 4.0);
+    HostInfo h2 = mkHost(8, 1.0);
+    std::vector<AgentPlacement::Candidate> cands {mkCand("a", h1, 1, 2),
+                                                  mkCand("b", h2, 1, 3)};
+    AgentPlacement p(AgentPlacement::BinPacking);
+    EXPECT_EQ(p.select(cands), "a");
+    p.configure(AgentPlacement::Spread, 1.5, 0.05);
+    EXPECT_EQ(p.select(cands), "a");
+    p.configure(AgentPlacement::LeastLoaded, 1.5, 0.05);
+    EXPECT_EQ(p.select(cands), "b");
+    EXPECT_EQ(AgentPlacement::policyFromName("spread"), AgentPlacement::Spread);
+}
+
+}
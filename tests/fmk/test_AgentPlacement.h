@@ -0,0 +1,66 @@
+#ifndef TEST_AGENTPLACEMENT_H
+#define TEST_AGENTPLACEMENT_H
+
+#include "placement.h"
+#include "gtest/gtest.h"
+
+//using namespace AgentPlacement;
+
+namespace TestAgentPlacement {
+
+class TestAgentPlacement : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestAgentPlacement() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestAgentPlacement() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // AgentPlacement::obj ev;
+};
+
+class TestAgentPlacementExit : public TestAgentPlacement {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestAgentPlacementExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestAgentPlacementExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_AGENTPLACEMENT_H
@@ -0,0 +1,23 @@
+#include "test_ChannelRegistry.h"
+
+namespace TestChannelRegistry {
+
+TEST_F(TestChannelRegistry, Test_intern) {
+    EXPECT_EQ(ChannelRegistry::find(ChnlCmd), TX_ID_CMD);
+    EXPECT_EQ(ChannelRegistry::intern(ChnlTskProc), TX_ID_TSKPROC);
+
+    ChannelId id = ChannelRegistry::intern(ChnlTskProc + "_TskAgent_01_01");
+    EXPECT_GT(id, TX_ID_UNKNOWN);
+    EXPECT_EQ(ChannelRegistry::intern(ChnlTskProc + "_TskAgent_01_01"), id);
+    EXPECT_EQ(ChannelRegistry::name(id), ChnlTskProc + "_TskAgent_01_01");
+    EXPECT_EQ(ChannelRegistry::baseOf(id), TX_ID_TSKPROC);
+    EXPECT_EQ(ChannelRegistry::find("NONE"), ChannelRegistry::InvalidChannel);
+}
+
+TEST_F(TestChannelRegistry, Test_msgTypeId) {
+    EXPECT_EQ(ChannelRegistry::msgTypeId("TSKRQST"), TX_ID_TSKRQST);
+    EXPECT_EQ(ChannelRegistry::msgTypeId("TSKPROC_X"), TX_ID_UNKNOWN);
+    EXPECT_EQ(ChannelRegistry::msgTag(TX_ID_HOSTMON), Tag_MsgHostMon);
+}
+
+}
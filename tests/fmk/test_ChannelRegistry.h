@@ -0,0 +1,66 @@
+#ifndef TEST_CHANNELREGISTRY_H
+#define TEST_CHANNELREGISTRY_H
+
+#include "chnlreg.h"
+#include "gtest/gtest.h"
+
+//using namespace ChannelRegistry;
+
+namespace TestChannelRegistry {
+
+class TestChannelRegistry : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestChannelRegistry() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestChannelRegistry() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // ChannelRegistry::obj ev;
+};
+
+class TestChannelRegistryExit : public TestChannelRegistry {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestChannelRegistryExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestChannelRegistryExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_CHANNELREGISTRY_H
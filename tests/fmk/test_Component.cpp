@@ -1,13 +1,65 @@
 #include "test_Component.h"
 
+#include "pipeline.h"
+#include "channels.h"
+#include "config.h"
+
+#include <poll.h>
+#include <unistd.h>
+
 //#define CheckResultOf(s,r) do {                                         \
 //    ev.clear();                                                         \
 //    ev.set(std::string( #s ));                                          \
 //    EXPECT_EQ(ev.getValue(), r);                                        \
 //    } while (0)
 
+using Configuration::cfg;
+
 namespace TestComponent {
 
+// Component counting the messages it takes, driven by the test
+class MsgCounter : public Component {
+public:
+    MsgCounter(std::string name)
+        : Component(name), numCmds(0), numTskRep(0), numHostMon(0) {}
+    void queues()  { setChannelQueues(); }
+    void pass()    { updateConnections(); processIncommingMessages(); }
+    bool pending() { return messagesPending(); }
+    int numCmds;
+    int numTskRep;
+    int numHostMon;
+protected:
+    virtual void processCmdMsg(ScalabilityProtocolRole* c, MessageBase & m) {
+        ++numCmds;
+    }
+    virtual void processTskRepMsg(ScalabilityProtocolRole* c, MessageBase & m) {
+        ++numTskRep;
+    }
+    virtual void processHostMonMsg(ScalabilityProtocolRole* c, MessageBase & m) {
+        ++numHostMon;
+    }
+};
+
+// Set the configured queues, and the minimal settings it needs
+static void configureQueues(const char * queues)
+{
+    char tmpl[] = "/tmp/test_Component_XXXXXX";
+    std::string dir(mkdtemp(tmpl));
+    Log::setLogBaseDir(dir);
+    json v;
+    Json::Reader().parse(queues, v["network"]["queues"]);
+    v["general"]["cfgVersion"] = CONFIG_VERSION;
+    v["general"]["workArea"]   = dir;
+    cfg.init(v);
+}
+
+static std::string msgText(const char * type, const char * source)
+{
+    return (std::string("{\"body\":{},\"header\":{\"id\":\"1\",\"type\":\"") +
+            type + "\",\"version\":\"1.0\",\"source\":\"" + source +
+            "\",\"target\":\"*\"}}");
+}
+
 TEST_F(TestComponent, Test_run) {
     EXPECT_DEATH({Component x("name", "address", 0);}, "failed");
     
@@ -53,4 +105,92 @@ TEST_F(TestComponent, Test_writeMsgToFile) {
     
 }
 
+TEST_F(TestComponent, Test_getChannelStats) {
+    char tmpl[] = "/tmp/test_Component_XXXXXX";
+    Log::setLogBaseDir(std::string(mkdtemp(tmpl)));
+
+    // Without address the component runs no thread
+    Component c("TestChannelStats", "", 0);
+    Pipeline * pull = new Pipeline(NN_PULL, "inproc://test_channelStats");
+    Pipeline * push = new Pipeline(NN_PUSH, "inproc://test_channelStats");
+    ChannelDescriptor chnl("TESTCHNL");
+    c.addConnection(chnl, push);
+    EXPECT_TRUE(push->setMsgOut(MessageBuffer("hello")));
+
+    json v;
+    Component::allChannelStats(v);
+    ASSERT_TRUE(v.isMember("TestChannelStats"));
+    json & st = v["TestChannelStats"]["TESTCHNL"];
+    EXPECT_EQ(st["msgsOut"].asUInt64(), 1);
+    EXPECT_EQ(st["bytesOut"].asUInt64(), 5);
+    EXPECT_EQ(st["msgsIn"].asUInt64(), 0);
+    EXPECT_TRUE(st["latency"].isMember("p99"));
+    delete push;
+    delete pull;
+}
+
+TEST_F(TestComponent, Test_messagesPending) {
+    // Staging queue of a single message, blocking the rest in the role
+    configureQueues("{\"CMD\": {\"capacity\": 1, \"policy\": \"block\"}}");
+
+    MsgCounter c("TestPending");
+    Pipeline * pull = new Pipeline(NN_PULL, "inproc://test_messagesPending");
+    Pipeline push(NN_PUSH, "inproc://test_messagesPending");
+    ChannelDescriptor chnl(ChnlCmd);
+    c.addConnection(chnl, pull);
+    c.queues();
+    // The I/O thread takes all of them from the socket, and signals once
+    pull->startIoThread();
+
+    const int NumMsgs = 3;
+    for (int i = 0; i < NumMsgs; ++i) {
+        EXPECT_TRUE(push.setMsgOut(MessageBuffer(msgText("CMD", "EvtMng"))));
+    }
+    struct pollfd pfd = {pull->getRecvFd(), POLLIN, 0};
+    ASSERT_GT(poll(&pfd, 1, 2000), 0);
+    usleep(50000);
+
+    // One message per pass; the rest are left, and reported as pending
+    c.pass();
+    EXPECT_EQ(c.numCmds, 1);
+    EXPECT_TRUE(c.pending());
+    int passes = 1;
+    while (c.pending() && (passes < 2 * NumMsgs)) { c.pass(); ++passes; }
+    EXPECT_EQ(c.numCmds, NumMsgs);
+    EXPECT_FALSE(c.pending());
+    pull->stopIoThread();
+}
+
+TEST_F(TestComponent, Test_coalesceHostMon) {
+    // As in the configuration templates
+    configureQueues("{\"TSKREP\": {\"capacity\": 0, \"policy\": \"coalesce\","
+                    " \"coalesceTypes\": [ \"HOSTMON\" ]}}");
+
+    MsgCounter c("TestCoalesce");
+    Pipeline * pull = new Pipeline(NN_PULL, "inproc://test_coalesceHostMon",
+                                   Pipeline::PullerBinds);
+    Pipeline push1(NN_PUSH, "inproc://test_coalesceHostMon", Pipeline::PullerBinds);
+    Pipeline push2(NN_PUSH, "inproc://test_coalesceHostMon", Pipeline::PullerBinds);
+    ChannelDescriptor chnl(ChnlTskRep);
+    c.addConnection(chnl, pull);
+    c.queues();
+    pull->startIoThread();
+
+    // Only the latest host information of each agent is taken, but
+    // every task report
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(push1.setMsgOut(MessageBuffer(msgText("HOSTMON", "TskAgent_01_01"))));
+        EXPECT_TRUE(push1.setMsgOut(MessageBuffer(msgText("TSKREP", "TskAgent_01_01"))));
+        EXPECT_TRUE(push2.setMsgOut(MessageBuffer(msgText("HOSTMON", "TskAgent_01_02"))));
+    }
+    struct pollfd pfd = {pull->getRecvFd(), POLLIN, 0};
+    ASSERT_GT(poll(&pfd, 1, 2000), 0);
+    usleep(50000);
+
+    c.pass();
+    EXPECT_EQ(c.numHostMon, 2);
+    EXPECT_EQ(c.numTskRep, 3);
+    pull->stopIoThread();
+}
+
 }           
@@ -0,0 +1,62 @@
+#include "test_LoopProfiler.h"
+
+namespace TestLoopProfiler {
+
+TEST_F(TestLoopProfiler, Test_overruns) {
+    LoopProfiler prof;
+    prof.iteration(1000, 250000000);
+    prof.iteration(300000000, 250000000);
+    prof.overrun(2);
+    prof.rotate();
+
+    json v;
+    prof.toJson(v);
+    EXPECT_EQ(v["iterations"].asUInt64(), 2);
+    EXPECT_EQ(v["overruns"].asUInt64(), 3);
+    EXPECT_EQ(v["totalOverruns"].asUInt64(), 3);
+}
+
+TEST_F(TestLoopProfiler, Test_rotate) {
+    LoopProfiler prof;
+    prof.phase(LoopProfiler::ProcessMessages, 5000);
+    prof.handler(TX_ID_TSKREP, 2000000);
+    prof.iteration(10000, 250000000);
+    prof.rotate();
+
+    json v;
+    prof.toJson(v);
+    EXPECT_EQ(v["phases"]["processIncommingMessages"]["count"].asUInt64(), 1);
+    EXPECT_NEAR(v["phases"]["processIncommingMessages"]["max"].asDouble(), 5., 1.e-9);
+    EXPECT_EQ(v["handlers"][ChannelAcronym[TX_ID_TSKREP]]["count"].asUInt64(), 1);
+    EXPECT_EQ(v["handlers"].size(), 1);
+    EXPECT_NE(prof.summary().find("slowest handler " + ChannelAcronym[TX_ID_TSKREP]),
+              std::string::npos);
+
+    // Values of the closed window are gone after the next rotation
+    prof.rotate();
+    prof.rotate();
+    prof.toJson(v);
+    EXPECT_EQ(v["iterations"].asUInt64(), 0);
+    EXPECT_EQ(v["handlers"].size(), 0);
+    EXPECT_EQ(v["totalOverruns"].asUInt64(), 0);
+}
+
+TEST_F(TestLoopProfiler, Test_allToJson) {
+    LoopProfiler a, b;
+    a.attach("TestCompA");
+    {
+        LoopProfiler c;
+        c.attach("TestCompC");
+        json v;
+        LoopProfiler::allToJson(v);
+        EXPECT_TRUE(v.isMember("TestCompA"));
+        EXPECT_TRUE(v.isMember("TestCompC"));
+        EXPECT_FALSE(v.isMember(""));
+    }
+    json v;
+    LoopProfiler::allToJson(v);
+    EXPECT_TRUE(v.isMember("TestCompA"));
+    EXPECT_FALSE(v.isMember("TestCompC"));
+}
+
+}
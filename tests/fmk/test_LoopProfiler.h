@@ -0,0 +1,66 @@
+#ifndef TEST_LOOPPROFILER_H
+#define TEST_LOOPPROFILER_H
+
+#include "loopprof.h"
+#include "gtest/gtest.h"
+
+//using namespace LoopProfiler;
+
+namespace TestLoopProfiler {
+
+class TestLoopProfiler : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestLoopProfiler() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestLoopProfiler() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // LoopProfiler::obj ev;
+};
+
+class TestLoopProfilerExit : public TestLoopProfiler {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestLoopProfilerExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestLoopProfilerExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_LOOPPROFILER_H
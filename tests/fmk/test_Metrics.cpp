@@ -0,0 +1,73 @@
+#include "test_Metrics.h"
+
+#include <thread>
+
+namespace TestMetrics {
+
+TEST_F(TestMetrics, Test_counterShards) {
+    Metrics & mtr = Metrics::instance();
+    Counter & c = mtr.counter("test_events_total", "Events",
+                              Metrics::labels({{"src", "a"}}));
+    EXPECT_EQ(&c, &mtr.counter("test_events_total", "Events",
+                               Metrics::labels({{"src", "a"}})));
+
+    std::vector<std::thread> thrs;
+    for (int t = 0; t < 4; ++t) {
+        thrs.push_back(std::thread([&c] () {
+                    for (int i = 0; i < 10000; ++i) { c.inc(); }
+                }));
+    }
+    for (auto & t : thrs) { t.join(); }
+    EXPECT_EQ(c.value(), 40000);
+}
+
+TEST_F(TestMetrics, Test_histogram) {
+    Histogram & h = Metrics::instance().histogram("test_op_seconds", "Op time",
+                                                  {0.1, 1., 10.});
+    h.observe(0.05);
+    h.observe(0.5);
+    h.observe(0.5);
+    h.observe(20.);
+    EXPECT_EQ(h.count(), 4);
+    EXPECT_NEAR(h.sum(), 21.05, 1.e-6);
+
+    std::string out;
+    h.render(out);
+    EXPECT_NE(out.find("test_op_seconds_bucket{le=\"0.1\"} 1\n"), std::string::npos);
+    EXPECT_NE(out.find("test_op_seconds_bucket{le=\"1\"} 3\n"), std::string::npos);
+    EXPECT_NE(out.find("test_op_seconds_bucket{le=\"10\"} 3\n"), std::string::npos);
+    EXPECT_NE(out.find("test_op_seconds_bucket{le=\"+Inf\"} 4\n"), std::string::npos);
+    EXPECT_NE(out.find("test_op_seconds_count 4\n"), std::string::npos);
+}
+
+TEST_F(TestMetrics, Test_exposition) {
+    Metrics & mtr = Metrics::instance();
+    mtr.gauge("test_queue_length", "Queue length",
+              Metrics::labels({{"q", "x"}})).set(7);
+    mtr.gauge("test_queue_length", "Queue length",
+              Metrics::labels({{"q", "y\"z"}})).set(-2);
+
+    std::string out = mtr.exposition();
+    size_t p = out.find("# HELP test_queue_length Queue length\n"
+                        "# TYPE test_queue_length gauge\n"
+                        "test_queue_length{q=\"x\"} 7\n"
+                        "test_queue_length{q=\"y\\\"z\"} -2\n");
+    EXPECT_NE(p, std::string::npos);
+    // A single header per family
+    size_t q = out.find("# TYPE test_queue_length");
+    EXPECT_EQ(out.find("# TYPE test_queue_length", q + 1), std::string::npos);
+}
+
+TEST_F(TestMetrics, Test_alignment) {
+    Metrics & mtr = Metrics::instance();
+    for (int i = 0; i < 4; ++i) {
+        std::string lbl(Metrics::labels({{"i", std::to_string(i)}}));
+        Counter & c = mtr.counter("test_aligned_total", "Aligned counter", lbl);
+        Histogram & h = mtr.histogram("test_aligned_seconds", "Aligned histogram",
+                                      {0.1, 1.0}, lbl);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&c) % CACHE_LINE_SIZE, 0u);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&h) % CACHE_LINE_SIZE, 0u);
+    }
+}
+
+}
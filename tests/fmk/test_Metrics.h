@@ -0,0 +1,66 @@
+#ifndef TEST_METRICS_H
+#define TEST_METRICS_H
+
+#include "metrics.h"
+#include "gtest/gtest.h"
+
+//using namespace Metrics;
+
+namespace TestMetrics {
+
+class TestMetrics : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMetrics() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMetrics() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // Metrics::obj ev;
+};
+
+class TestMetricsExit : public TestMetrics {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMetricsExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMetricsExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_METRICS_H
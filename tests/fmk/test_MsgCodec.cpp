@@ -0,0 +1,51 @@
+#include "test_MsgCodec.h"
+
+namespace TestMsgCodec {
+
+TEST_F(TestMsgCodec, Test_encode) {
+    json v;
+    JValue(std::string("{\"body\":{\"info\":{\"taskName\":\"QLA_VIS\",\"taskStatus\":-3,"
+           "\"taskProgress\":57,\"load\":0.25,\"flags\":true,\"inputs\":[],"
+           "\"big\":12345678901,\"none\":null}},"
+           "\"header\":{\"id\":\"TSKPROC\",\"type\":\"TSKREP\","
+           "\"version\":\"1.1\",\"source\":\"TskAgent_01_01\","
+           "\"target\":\"TskMng\"}}")).val().swap(v);
+
+    std::string bin;
+    MsgCodec::encode(v, MsgCodec::BINARY, bin);
+    EXPECT_TRUE(MsgCodec::isBinary(bin.data(), bin.size()));
+
+    json w;
+    EXPECT_TRUE(MsgCodec::decode(bin.data(), bin.size(), w));
+    EXPECT_EQ(JValue(w).str(), JValue(v).str());
+
+    std::string txt;
+    MsgCodec::encode(v, MsgCodec::JSON, txt);
+    EXPECT_FALSE(MsgCodec::isBinary(txt.data(), txt.size()));
+    EXPECT_LT(bin.size(), txt.size());
+}
+
+TEST_F(TestMsgCodec, Test_scanRouting) {
+    json v;
+    v["body"]["x"] = 1;
+    v["header"]["type"]    = "TSKRQST";
+    v["header"]["version"] = "1.1";
+    v["header"]["target"]  = "TskMng";
+    std::string bin;
+    MsgCodec::encode(v, MsgCodec::BINARY, bin);
+
+    MsgRouting r;
+    EXPECT_TRUE(MsgHeaderScanner::scan(bin.data(), bin.size(), r));
+    EXPECT_EQ(r.type,    "TSKRQST");
+    EXPECT_EQ(r.version, "1.1");
+    EXPECT_EQ(r.target,  "TskMng");
+}
+
+TEST_F(TestMsgCodec, Test_supportsBinary) {
+    EXPECT_FALSE(MsgCodec::supportsBinary("1.0"));
+    EXPECT_TRUE(MsgCodec::supportsBinary("1.1"));
+    EXPECT_TRUE(MsgCodec::supportsBinary("2.0"));
+    EXPECT_FALSE(MsgCodec::supportsBinary(""));
+}
+
+}
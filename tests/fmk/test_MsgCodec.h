@@ -0,0 +1,66 @@
+#ifndef TEST_MSGCODEC_H
+#define TEST_MSGCODEC_H
+
+#include "msgcodec.h"
+#include "gtest/gtest.h"
+
+//using namespace MsgCodec;
+
+namespace TestMsgCodec {
+
+class TestMsgCodec : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMsgCodec() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMsgCodec() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // MsgCodec::obj ev;
+};
+
+class TestMsgCodecExit : public TestMsgCodec {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMsgCodecExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMsgCodecExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_MSGCODEC_H
@@ -0,0 +1,25 @@
+#include "test_MsgHeaderScanner.h"
+
+namespace TestMsgHeaderScanner {
+
+TEST_F(TestMsgHeaderScanner, Test_scan) {
+    std::string s("{\"body\":{\"info\":{\"header\":{\"target\":\"X\"},"
+                  "\"s\":\"a}\\\"b\"},\"n\":[1,2,{}]},"
+                  "\"header\":{\"id\":\"TSKPROC\",\"path\":[],\"rc\":0,"
+                  "\"source\":\"TskMng\",\"target\":\"TskAgent_01_01\","
+                  "\"type\":\"TSKREP\"}}");
+    MsgRouting r;
+    EXPECT_TRUE(MsgHeaderScanner::scan(s.data(), s.size(), r));
+    EXPECT_EQ(r.id,     "TSKPROC");
+    EXPECT_EQ(r.type,   "TSKREP");
+    EXPECT_EQ(r.source, "TskMng");
+    EXPECT_EQ(r.target, "TskAgent_01_01");
+}
+
+TEST_F(TestMsgHeaderScanner, Test_scanNoHeader) {
+    std::string s("{\"body\":{}}");
+    MsgRouting r;
+    EXPECT_FALSE(MsgHeaderScanner::scan(s.data(), s.size(), r));
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef TEST_MSGHEADERSCANNER_H
+#define TEST_MSGHEADERSCANNER_H
+
+#include "msgscan.h"
+#include "gtest/gtest.h"
+
+//using namespace MsgHeaderScanner;
+
+namespace TestMsgHeaderScanner {
+
+class TestMsgHeaderScanner : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMsgHeaderScanner() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMsgHeaderScanner() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // MsgHeaderScanner::obj ev;
+};
+
+class TestMsgHeaderScannerExit : public TestMsgHeaderScanner {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMsgHeaderScannerExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMsgHeaderScannerExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_MSGHEADERSCANNER_H
@@ -0,0 +1,46 @@
+#include "test_MsgJournal.h"
+
+#include <cstdlib>
+#include <unistd.h>
+
+namespace TestMsgJournal {
+
+TEST_F(TestMsgJournal, Test_writeRead) {
+    char tmpl[] = "/tmp/test_MsgJournal_XXXXXX";
+    std::string dir(mkdtemp(tmpl));
+
+    const int NumMsgs = 200;
+    std::string msg(1000, 'x');
+    {
+        // Small segments, to force rotations
+        MsgJournal j(dir, "Comp", 64 * 1024);
+        for (int i = 0; i < NumMsgs; ++i) {
+            EXPECT_TRUE(j.append((i % 2) ? MsgJournal::Send : MsgJournal::Recv,
+                                 TX_ID_TSKPROC,
+                                 MessageBuffer(msg + std::to_string(i))));
+        }
+    }
+    EXPECT_GT(MsgJournal::listSegments(dir, "Comp").size(), 1);
+
+    MsgJournalReader rd(dir, "Comp");
+    MsgJournalReader::Record r;
+    int n = 0;
+    int64_t midTimeNs = 0;
+    while (rd.next(r)) {
+        EXPECT_EQ(r.chnl, "TSKPROC");
+        EXPECT_EQ(r.dir, (n % 2) ? 'S' : 'R');
+        EXPECT_EQ(std::string(r.data, r.length), msg + std::to_string(n));
+        if (n == NumMsgs / 2) { midTimeNs = r.timeNs; }
+        ++n;
+    }
+    EXPECT_EQ(n, NumMsgs);
+
+    // Seek by time
+    rd.seek(midTimeNs);
+    EXPECT_TRUE(rd.next(r));
+    EXPECT_GE(r.timeNs, midTimeNs);
+
+    system(("rm -rf " + dir).c_str());
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef TEST_MSGJOURNAL_H
+#define TEST_MSGJOURNAL_H
+
+#include "msgjournal.h"
+#include "gtest/gtest.h"
+
+//using namespace MsgJournal;
+
+namespace TestMsgJournal {
+
+class TestMsgJournal : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMsgJournal() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMsgJournal() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // MsgJournal::obj ev;
+};
+
+class TestMsgJournalExit : public TestMsgJournal {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMsgJournalExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMsgJournalExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_MSGJOURNAL_H
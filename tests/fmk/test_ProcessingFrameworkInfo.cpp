@@ -0,0 +1,77 @@
+#include "test_ProcessingFrameworkInfo.h"
+
+#include "datatypes.h"
+
+namespace TestProcessingFrameworkInfo {
+
+static void setupFmkInfo(ProcessingFrameworkInfo & p)
+{
+    for (auto & ip : {"10.0.0.1", "10.0.0.2"}) {
+        ProcessingHostInfo * ph = new ProcessingHostInfo;
+        ph->name = ip;
+        ph->numTasks = 0;
+        ph->hostInfo.fromStr("{}");
+        for (auto & ag : {"A1", "A2"}) {
+            AgentInfo agi;
+            agi.name = std::string(ip) + "_" + ag;
+            agi.load = 0.;
+            ph->agInfo.push_back(agi);
+        }
+        ph->numAgents = ph->agInfo.size();
+        p.hostsInfo[ip] = ph;
+    }
+}
+
+TEST_F(TestProcessingFrameworkInfo, Test_delta) {
+    ProcessingFrameworkInfo src, dst;
+    setupFmkInfo(src);
+    setupFmkInfo(dst);
+    ProcessingHostInfo * dstHost = dst.hostsInfo["10.0.0.2"];
+
+    EXPECT_FALSE(src.isDirty());
+    src.hostsInfo["10.0.0.2"]->agInfo[1].taskStatus =
+        TaskStatusSpectra(2, 1, 0, 0, 0, 3);
+    src.touchAgent("10.0.0.2", "10.0.0.2_A2");
+    EXPECT_TRUE(src.isDirty());
+
+    std::string delta = src.toDeltaJsonStr(false);
+    EXPECT_FALSE(src.isDirty());
+
+    // Only the modified agent is sent
+    JValue d(delta);
+    EXPECT_EQ(d["hostsInfo"].size(), 1);
+    EXPECT_EQ(d["hostsInfo"]["10.0.0.2"]["agentsInfo"].size(), 1);
+    EXPECT_FALSE(d["hostsInfo"]["10.0.0.2"].isMember("hostInfo"));
+
+    EXPECT_TRUE(dst.applyDelta(delta));
+    EXPECT_EQ(dst.version, src.version);
+    EXPECT_EQ(dst.hostsInfo["10.0.0.2"], dstHost);
+    EXPECT_EQ(dstHost->agInfo[1].taskStatus.running, 2);
+    EXPECT_EQ(dstHost->agInfo[1].taskStatus.finished, 3);
+    EXPECT_EQ(dstHost->agInfo[0].taskStatus.running, 0);
+}
+
+TEST_F(TestProcessingFrameworkInfo, Test_keyframe) {
+    ProcessingFrameworkInfo src, dst;
+    setupFmkInfo(src);
+    setupFmkInfo(dst);
+
+    // A lost delta makes the next one inapplicable
+    src.hostsInfo["10.0.0.1"]->agInfo[0].taskStatus =
+        TaskStatusSpectra(1, 0, 0, 0, 0, 0);
+    src.touchAgent("10.0.0.1", "10.0.0.1_A1");
+    src.toDeltaJsonStr(false);
+
+    src.hostsInfo["10.0.0.1"]->agInfo[1].taskStatus =
+        TaskStatusSpectra(0, 4, 0, 0, 0, 0);
+    src.touchAgent("10.0.0.1", "10.0.0.1_A2");
+    EXPECT_FALSE(dst.applyDelta(src.toDeltaJsonStr(false)));
+
+    // ... until the next keyframe
+    EXPECT_TRUE(dst.applyDelta(src.toDeltaJsonStr(true)));
+    EXPECT_EQ(dst.version, src.version);
+    EXPECT_EQ(dst.hostsInfo["10.0.0.1"]->agInfo[0].taskStatus.running, 1);
+    EXPECT_EQ(dst.hostsInfo["10.0.0.1"]->agInfo[1].taskStatus.scheduled, 4);
+}
+
+}
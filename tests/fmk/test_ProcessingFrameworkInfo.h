@@ -0,0 +1,66 @@
+#ifndef TEST_PROCESSINGFRAMEWORKINFO_H
+#define TEST_PROCESSINGFRAMEWORKINFO_H
+
+#include "procinfo.h"
+#include "gtest/gtest.h"
+
+//using namespace ProcessingFrameworkInfo;
+
+namespace TestProcessingFrameworkInfo {
+
+class TestProcessingFrameworkInfo : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestProcessingFrameworkInfo() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestProcessingFrameworkInfo() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // ProcessingFrameworkInfo::obj ev;
+};
+
+class TestProcessingFrameworkInfoExit : public TestProcessingFrameworkInfo {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestProcessingFrameworkInfoExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestProcessingFrameworkInfoExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_PROCESSINGFRAMEWORKINFO_H
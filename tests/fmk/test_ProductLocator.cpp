@@ -0,0 +1,32 @@
+#include "test_ProductLocator.h"
+
+namespace TestProductLocator {
+
+TEST_F(TestProductLocator, Test_count) {
+    ProductLocator locs;
+    locs.add("A", "h1");
+    locs.add("B", "h1");
+    locs.add("B", "h2");
+    std::map<std::string, int> n = locs.count({"A", "B", "C"});
+    EXPECT_EQ(n.size(), 2);
+    EXPECT_EQ(n["h1"], 2);
+    EXPECT_EQ(n["h2"], 1);
+    EXPECT_EQ(locs.hosts("B").size(), 2);
+    EXPECT_TRUE(locs.count({"C"}).empty());
+}
+
+TEST_F(TestProductLocator, Test_capacity) {
+    ProductLocator locs(2);
+    locs.add("A", "h1");
+    locs.add("B", "h1");
+    locs.add("A", "h1");   // A is now the newest one
+    locs.add("C", "h1");
+    EXPECT_TRUE(locs.hosts("B").empty());
+    EXPECT_EQ(locs.hosts("A").size(), 1);
+    EXPECT_EQ(locs.size(), 2);
+
+    locs.forget("h1");
+    EXPECT_EQ(locs.size(), 0);
+}
+
+}
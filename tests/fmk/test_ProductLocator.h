@@ -0,0 +1,66 @@
+#ifndef TEST_PRODUCTLOCATOR_H
+#define TEST_PRODUCTLOCATOR_H
+
+#include "prodloc.h"
+#include "gtest/gtest.h"
+
+//using namespace ProductLocator;
+
+namespace TestProductLocator {
+
+class TestProductLocator : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestProductLocator() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestProductLocator() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // ProductLocator::obj ev;
+};
+
+class TestProductLocatorExit : public TestProductLocator {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestProductLocatorExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestProductLocatorExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_PRODUCTLOCATOR_H
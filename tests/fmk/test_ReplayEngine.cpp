@@ -0,0 +1,67 @@
+#include "test_ReplayEngine.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace TestReplayEngine {
+
+// Component that answers each command with a message on the same channel
+class EchoComp : public Component {
+public:
+    EchoComp() : Component(std::string("Echo")), numCmds(0) {}
+    int numCmds;
+protected:
+    virtual void processCmdMsg(ScalabilityProtocolRole* c, MessageBase & m) {
+        ++numCmds;
+        send(ChnlCmd, m.str());
+    }
+};
+
+TEST_F(TestReplayEngine, Test_replayMsonDir) {
+    char tmpl[] = "/tmp/test_ReplayEngine_XXXXXX";
+    std::string dir(mkdtemp(tmpl));
+
+    const char * msg = "{\"body\":{\"cmd\":\"PING\"},"
+        "\"header\":{\"id\":\"CMD\",\"type\":\"CMD\",\"version\":\"1.0\","
+        "\"source\":\"EvtMng\",\"target\":\"Echo\"}}";
+    const char * files[] = { "1000.000000200_Echo_R_CMD.mson",
+                             "1000.000000100_Echo_R_CMD.mson",
+                             "1000.000000150_Echo_S_CMD.mson" };
+    for (auto f : files) { std::ofstream(dir + "/" + f) << msg; }
+
+    Log::setLogBaseDir(dir);
+    EchoComp comp;
+    {
+        ReplayEngine eng(&comp, dir);
+        EXPECT_EQ(eng.loadMsonDir(dir), 2);
+        eng.run(0);
+
+        std::stringstream ss;
+        eng.report(ss);
+        EXPECT_NE(ss.str().find("2 messages replayed, 2 messages sent"),
+                  std::string::npos);
+    }
+    EXPECT_EQ(comp.numCmds, 2);
+
+    // The answers are in the output journal
+    MsgJournalReader rd(dir, "Echo.out");
+    MsgJournalReader::Record r;
+    int n = 0;
+    while (rd.next(r)) {
+        EXPECT_EQ(r.chnl, "CMD");
+        EXPECT_EQ(r.dir, 'S');
+        ++n;
+    }
+    EXPECT_EQ(n, 2);
+
+    std::ifstream csv(dir + "/Echo.latency.csv");
+    std::string line;
+    n = 0;
+    while (std::getline(csv, line)) { ++n; }
+    EXPECT_EQ(n, 3);
+
+    system(("rm -rf " + dir).c_str());
+}
+
+}
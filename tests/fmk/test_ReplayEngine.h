@@ -0,0 +1,66 @@
+#ifndef TEST_REPLAYENGINE_H
+#define TEST_REPLAYENGINE_H
+
+#include "replay.h"
+#include "gtest/gtest.h"
+
+//using namespace ReplayEngine;
+
+namespace TestReplayEngine {
+
+class TestReplayEngine : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestReplayEngine() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestReplayEngine() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // ReplayEngine::obj ev;
+};
+
+class TestReplayEngineExit : public TestReplayEngine {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestReplayEngineExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestReplayEngineExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_REPLAYENGINE_H
@@ -0,0 +1,168 @@
+#include "test_TaskQueue.h"
+
+#include <thread>
+
+namespace TestTaskQueue {
+
+static TaskInfo mkTask(const std::string & name, const std::string & origin,
+                       const std::string & rule = "QLA")
+{
+    TaskInfo t;
+    t["taskName"]   = name;
+    t["taskRule"]   = rule;
+    t["taskOrigin"] = origin;
+    t["taskFlags"]  = 0;
+    return t;
+}
+
+static std::vector<TaskQueue::Class> classes()
+{
+    TaskQueue::Class nominal;
+    nominal.name   = "nominal";
+    nominal.weight = 10;
+    nominal.origin = "nominal";
+    TaskQueue::Class reproc;
+    reproc.name   = "reprocessing";
+    reproc.weight = 1;
+    reproc.origin = "reprocessing";
+    return {nominal, reproc};
+}
+
+TEST_F(TestTaskQueue, Test_classify) {
+    TaskQueue q("test.classify");
+    TaskQueue::Class le1;
+    le1.name   = "le1";
+    le1.weight = 20;
+    le1.rules  = {"LE1"};
+    std::vector<TaskQueue::Class> cls = classes();
+    cls.push_back(le1);
+    q.setClasses(cls, 60.);
+
+    TaskInfo a = mkTask("a", "reprocessing");
+    TaskInfo b = mkTask("b", "");
+    TaskInfo c = mkTask("c", "nominal", "LE1");
+    EXPECT_EQ(q.classify(a), "reprocessing");
+    EXPECT_EQ(q.classify(b), "nominal");
+    EXPECT_EQ(q.classify(c), "le1");
+}
+
+TEST_F(TestTaskQueue, Test_priority) {
+    TaskQueue q("test.priority");
+    q.setClasses(classes(), 3600.);
+    for (int i = 0; i < 100; ++i) {
+        q.push(mkTask("r" + std::to_string(i), "reprocessing"));
+    }
+    q.push(mkTask("n0", "nominal"));
+    q.push(mkTask("n1", "nominal"));
+    EXPECT_EQ(q.size(), 102);
+
+    TaskInfo t;
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "n0");
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "n1");
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "r0");
+}
+
+TEST_F(TestTaskQueue, Test_aging) {
+    TaskQueue q("test.aging");
+    q.setClasses(classes(), 0.01);
+    q.push(mkTask("r0", "reprocessing"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    q.push(mkTask("n0", "nominal"));
+
+    // The reprocessing task has waited long enough to go first
+    TaskInfo t;
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "r0");
+}
+
+TEST_F(TestTaskQueue, Test_overflow) {
+    TaskQueue q("test.overflow", 2, OverflowQueueBase::DropOldest);
+    q.setClasses(classes(), 3600.);
+    EXPECT_TRUE(q.push(mkTask("n0", "nominal")));
+    EXPECT_TRUE(q.push(mkTask("r0", "reprocessing")));
+    EXPECT_FALSE(q.push(mkTask("n1", "nominal")));
+
+    // The lowest priority task was dropped
+    TaskInfo t;
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "n0");
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "n1");
+    EXPECT_FALSE(q.pop(t));
+    EXPECT_EQ(q.stats().dropped, 1);
+}
+
+TEST_F(TestTaskQueue, Test_block) {
+    TaskQueue q("test.block", 1, OverflowQueueBase::Block, 0);
+    EXPECT_TRUE(q.push(mkTask("n0", "nominal")));
+    EXPECT_FALSE(q.push(mkTask("n1", "nominal")));
+
+    // The new task is rejected, nothing is dropped
+    TaskInfo t;
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "n0");
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.stats().dropped, 0);
+    EXPECT_EQ(q.stats().rejected, 1);
+    EXPECT_TRUE(q.push(mkTask("n1", "nominal")));
+}
+
+TEST_F(TestTaskQueue, Test_popAccepted) {
+    TaskQueue q("test.popAccepted");
+    q.setClasses(classes(), 3600.);
+    q.push(mkTask("r0", "reprocessing"));
+    q.push(mkTask("n0", "nominal"));
+    q.push(mkTask("n1", "nominal"));
+
+    // Tasks are looked at in priority order, skipping the rejected ones
+    std::vector<std::string> seen;
+    TaskInfo t;
+    ASSERT_TRUE(q.pop(t, [&] (TaskInfo & x, double waited) {
+                seen.push_back(x.taskName());
+                return x.taskName() == "r0"; }));
+    EXPECT_EQ(t.taskName(), "r0");
+    EXPECT_EQ(seen, std::vector<std::string>({"n0", "n1", "r0"}));
+    EXPECT_EQ(q.size(), 2);
+
+    // Not beyond the depth given
+    EXPECT_FALSE(q.pop(t, [] (TaskInfo & x, double waited) {
+                return x.taskName() == "n1"; }, 1));
+    EXPECT_EQ(q.size(), 2);
+}
+
+TEST_F(TestTaskQueue, Test_requeue) {
+    TaskQueue q("test.requeue");
+    q.setClasses(classes(), 3600.);
+    q.push(mkTask("n0", "nominal"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.push(mkTask("n1", "nominal"));
+
+    // A task put back is the next one taken
+    TaskInfo t;
+    double tWaited = -1.;
+    ASSERT_TRUE(q.pop(t, [&] (TaskInfo & x, double waited) {
+                tWaited = waited;
+                return true; }));
+    EXPECT_EQ(t.taskName(), "n0");
+    EXPECT_GE(tWaited, 0.);
+    q.requeue(t, tWaited);
+    EXPECT_EQ(q.size(), 2);
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "n0");
+
+    // And it keeps the time it had been waiting
+    q.requeue(t, 60.);
+    ASSERT_TRUE(q.pop(t, [&] (TaskInfo & x, double waited) {
+                tWaited = waited;
+                return true; }));
+    EXPECT_EQ(t.taskName(), "n0");
+    EXPECT_GE(tWaited, 60.);
+    ASSERT_TRUE(q.pop(t));
+    EXPECT_EQ(t.taskName(), "n1");
+    EXPECT_TRUE(q.empty());
+}
+
+}
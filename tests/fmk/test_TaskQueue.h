@@ -0,0 +1,66 @@
+#ifndef TEST_TASKQUEUE_H
+#define TEST_TASKQUEUE_H
+
+#include "taskqueue.h"
+#include "gtest/gtest.h"
+
+//using namespace TaskQueue;
+
+namespace TestTaskQueue {
+
+class TestTaskQueue : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestTaskQueue() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestTaskQueue() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // TaskQueue::obj ev;
+};
+
+class TestTaskQueueExit : public TestTaskQueue {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestTaskQueueExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestTaskQueueExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_TASKQUEUE_H
@@ -0,0 +1,73 @@
+#include "test_Tracer.h"
+
+namespace TestTracer {
+
+TEST_F(TestTracer, Test_takeAndMerge) {
+    Tracer & tr = Tracer::instance();
+    tr.clear();
+
+    std::string a = Tracer::newTraceId();
+    std::string b = Tracer::newTraceId();
+    EXPECT_NE(a, b);
+
+    tr.record(a, "ingest", "EvtMng", 100, 150);
+    tr.record(b, "ingest", "EvtMng", 120, 130);
+    tr.record(a, "queue", "TskMng", 150, 400);
+    tr.record("", "ignored", "TskMng", 0, 1);
+    EXPECT_EQ(tr.size(), 3);
+
+    // The spans of a trace travel as JSON, and are merged elsewhere
+    json spans = tr.take(a);
+    EXPECT_EQ(spans.size(), 2);
+    EXPECT_EQ(tr.size(), 1);
+    EXPECT_EQ(spans[1]["stage"].asString(), "queue");
+    EXPECT_EQ(spans[1]["end"].asInt64(), 400);
+
+    tr.merge(spans);
+    EXPECT_EQ(tr.size(), 3);
+    tr.clear();
+}
+
+TEST_F(TestTracer, Test_mark) {
+    Tracer & tr = Tracer::instance();
+    tr.clear();
+
+    ProductMetadata m;
+    m["traceId"] = Tracer::newTraceId();
+
+    // Without a mark there is no start for the span
+    tr.recordSinceMark(m.val(), "first", "EvtMng");
+    EXPECT_EQ(tr.size(), 0);
+    EXPECT_TRUE(m.val().isMember("traceMark"));
+
+    tr.recordSinceMark(m.val(), "second", "DatMng");
+    EXPECT_EQ(tr.size(), 1);
+    json spans = tr.take(m.traceId());
+    EXPECT_EQ(spans[0]["stage"].asString(), "second");
+    EXPECT_GE(spans[0]["end"].asInt64(), spans[0]["start"].asInt64());
+}
+
+TEST_F(TestTracer, Test_chromeTrace) {
+    Tracer & tr = Tracer::instance();
+    tr.clear();
+
+    tr.record("t1", "ingest", "EvtMng", 1000, 1500);
+    tr.record("t2", "ingest", "EvtMng", 1100, 1200);
+    tr.record("t1", "queue",  "TskMng", 1500, 4000);
+
+    JValue doc(tr.toChromeTrace());
+    json & ev = doc["traceEvents"];
+    // One metadata event naming each row, plus the spans
+    ASSERT_EQ(ev.size(), 5);
+    EXPECT_EQ(ev[0]["ph"].asString(), "M");
+    EXPECT_EQ(ev[0]["args"]["name"].asString(), "t1");
+    EXPECT_EQ(ev[1]["ph"].asString(), "X");
+    EXPECT_EQ(ev[1]["dur"].asInt64(), 500);
+    EXPECT_EQ(ev[4]["name"].asString(), "queue");
+    EXPECT_EQ(ev[4]["cat"].asString(), "TskMng");
+    EXPECT_EQ(ev[4]["tid"].asInt(), ev[1]["tid"].asInt());
+    EXPECT_NE(ev[3]["tid"].asInt(), ev[1]["tid"].asInt());
+    tr.clear();
+}
+
+}
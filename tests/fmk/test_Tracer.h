@@ -0,0 +1,66 @@
+#ifndef TEST_TRACER_H
+#define TEST_TRACER_H
+
+#include "tracer.h"
+#include "gtest/gtest.h"
+
+//using namespace Tracer;
+
+namespace TestTracer {
+
+class TestTracer : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestTracer() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestTracer() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // Tracer::obj ev;
+};
+
+class TestTracerExit : public TestTracer {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestTracerExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestTracerExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_TRACER_H
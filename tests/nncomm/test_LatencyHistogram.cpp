@@ -0,0 +1,37 @@
+#include "test_LatencyHistogram.h"
+
+namespace TestLatencyHistogram {
+
+TEST_F(TestLatencyHistogram, Test_percentile) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.count(), 0);
+    EXPECT_EQ(h.percentile(50.), 0);
+
+    for (uint64_t v = 1; v <= 10000; ++v) { h.record(v); }
+    EXPECT_EQ(h.count(), 10000);
+    EXPECT_EQ(h.min(), 1);
+    EXPECT_EQ(h.max(), 10000);
+    EXPECT_DOUBLE_EQ(h.mean(), 5000.5);
+
+    // Precision is 1/16 of the value
+    EXPECT_NEAR(h.percentile(50.), 5000, 5000 / 16);
+    EXPECT_NEAR(h.percentile(99.), 9900, 9900 / 16);
+    EXPECT_GE(h.percentile(50.), 5000);
+    EXPECT_EQ(h.percentile(100.), 10000);
+}
+
+TEST_F(TestLatencyHistogram, Test_smallAndLarge) {
+    LatencyHistogram h;
+    for (int i = 0; i < 99; ++i) { h.record(3); }
+    const uint64_t maxValue = LatencyHistogram::MaxValue;
+    h.record(maxValue + 1000);
+    EXPECT_EQ(h.percentile(50.), 3);
+    EXPECT_EQ(h.percentile(99.), 3);
+    EXPECT_EQ(h.max(), maxValue);
+
+    h.reset();
+    EXPECT_EQ(h.count(), 0);
+    EXPECT_EQ(h.max(), 0);
+}
+
+}
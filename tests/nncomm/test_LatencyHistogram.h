@@ -0,0 +1,66 @@
+#ifndef TEST_LATENCYHISTOGRAM_H
+#define TEST_LATENCYHISTOGRAM_H
+
+#include "latency.h"
+#include "gtest/gtest.h"
+
+//using namespace LatencyHistogram;
+
+namespace TestLatencyHistogram {
+
+class TestLatencyHistogram : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestLatencyHistogram() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestLatencyHistogram() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // LatencyHistogram::obj ev;
+};
+
+class TestLatencyHistogramExit : public TestLatencyHistogram {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestLatencyHistogramExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestLatencyHistogramExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_LATENCYHISTOGRAM_H
@@ -0,0 +1,25 @@
+#include "test_MessageBuffer.h"
+
+namespace TestMessageBuffer {
+
+TEST_F(TestMessageBuffer, Test_str) {
+    MessageBuffer b(std::string("{\"header\":{}}"));
+    EXPECT_EQ(b.size(), 13u);
+    EXPECT_EQ(b.str(), "{\"header\":{}}");
+}
+
+TEST_F(TestMessageBuffer, Test_move) {
+    MessageBuffer a(std::string("abc"));
+    MessageBuffer b(std::move(a));
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(b.str(), "abc");
+}
+
+TEST_F(TestMessageBuffer, Test_release) {
+    MessageBuffer b(std::string("abc"));
+    void * p = b.release();
+    EXPECT_TRUE(b.empty());
+    nn_freemsg(p);
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef TEST_MESSAGEBUFFER_H
+#define TEST_MESSAGEBUFFER_H
+
+#include "msgbuf.h"
+#include "gtest/gtest.h"
+
+//using namespace MessageBuffer;
+
+namespace TestMessageBuffer {
+
+class TestMessageBuffer : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMessageBuffer() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMessageBuffer() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // MessageBuffer::obj ev;
+};
+
+class TestMessageBufferExit : public TestMessageBuffer {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestMessageBufferExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestMessageBufferExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_MESSAGEBUFFER_H
@@ -1,5 +1,8 @@
 #include "test_Pipeline.h"
 
+#include <poll.h>
+#include <map>
+
 //#define CheckResultOf(s,r) do {                                         \
 //    ev.clear();                                                         \
 //    ev.set(std::string( #s ));                                          \
@@ -12,4 +15,57 @@ TEST_F(TestPipeline, Test_setMsgOut) {
     
 }
 
+TEST_F(TestPipeline, Test_ioThread) {
+    Pipeline push(NN_PUSH, "inproc://test_Pipeline_ioThread");
+    Pipeline pull(NN_PULL, "inproc://test_Pipeline_ioThread");
+    push.startIoThread();
+    pull.startIoThread();
+
+    const int NumMsgs = 1000;
+    for (int i = 0; i < NumMsgs; ++i) {
+        push.setMsgOut(MessageBuffer(std::to_string(i)));
+    }
+
+    int n = 0;
+    MessageBuffer m;
+    struct pollfd pfd = {pull.getRecvFd(), POLLIN, 0};
+    while ((n < NumMsgs) && (poll(&pfd, 1, 2000) > 0)) {
+        pull.update();
+        while (pull.next(m)) {
+            EXPECT_EQ(m.str(), std::to_string(n));
+            ++n;
+        }
+    }
+    EXPECT_EQ(n, NumMsgs);
+
+    pull.stopIoThread();
+    push.stopIoThread();
+}
+
+TEST_F(TestPipeline, Test_pullerBinds) {
+    // One puller collecting the messages of several pushers
+    Pipeline pull (NN_PULL, "inproc://test_Pipeline_pullerBinds",
+                   Pipeline::PullerBinds);
+    Pipeline push1(NN_PUSH, "inproc://test_Pipeline_pullerBinds",
+                   Pipeline::PullerBinds);
+    Pipeline push2(NN_PUSH, "inproc://test_Pipeline_pullerBinds",
+                   Pipeline::PullerBinds);
+
+    const int NumMsgs = 100;
+    for (int i = 0; i < NumMsgs; ++i) {
+        EXPECT_TRUE(push1.setMsgOut(MessageBuffer("1")));
+        EXPECT_TRUE(push2.setMsgOut(MessageBuffer("2")));
+    }
+
+    std::map<std::string, int> n;
+    MessageBuffer m;
+    struct pollfd pfd = {pull.getRecvFd(), POLLIN, 0};
+    while ((n["1"] + n["2"] < 2 * NumMsgs) && (poll(&pfd, 1, 2000) > 0)) {
+        pull.update();
+        while (pull.next(m)) { ++n[m.str()]; }
+    }
+    EXPECT_EQ(n["1"], NumMsgs);
+    EXPECT_EQ(n["2"], NumMsgs);
+}
+
 }           
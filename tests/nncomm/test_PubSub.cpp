@@ -1,5 +1,7 @@
 #include "test_PubSub.h"
 
+#include <poll.h>
+
 //#define CheckResultOf(s,r) do {                                         \
 //    ev.clear();                                                         \
 //    ev.set(std::string( #s ));                                          \
@@ -12,4 +14,26 @@ TEST_F(TestPubSub, Test_setMsgOut) {
     
 }
 
+TEST_F(TestPubSub, Test_addBinding) {
+    // Subscribers in this process and in other hosts, on the same socket
+    PubSub pub(NN_PUB, "tcp://127.0.0.1:27431");
+    pub.addBinding("inproc://test_PubSub_addBinding");
+    PubSub subTcp(NN_SUB, "tcp://127.0.0.1:27431");
+    PubSub subInProc(NN_SUB, "inproc://test_PubSub_addBinding");
+
+    pub.setMsgOut(MessageBuffer("hello"));
+
+    for (auto sub : {&subTcp, &subInProc}) {
+        MessageBuffer m;
+        struct pollfd pfd = {sub->getRecvFd(), POLLIN, 0};
+        bool received = false;
+        while ((!received) && (poll(&pfd, 1, 2000) > 0)) {
+            sub->update();
+            received = sub->next(m);
+        }
+        EXPECT_TRUE(received);
+        EXPECT_EQ(m.str(), "hello");
+    }
+}
+
 }           
@@ -1,5 +1,7 @@
 #include "test_ReqRep.h"
 
+#include <poll.h>
+
 //#define CheckResultOf(s,r) do {                                         \
 //    ev.clear();                                                         \
 //    ev.set(std::string( #s ));                                          \
@@ -8,4 +10,111 @@
 
 namespace TestReqRep {
 
-}           
+static bool receive(ReqRep & r, MessageBuffer & m)
+{
+    struct pollfd pfd = {r.getRecvFd(), POLLIN, 0};
+    while (poll(&pfd, 1, 2000) > 0) {
+        r.update();
+        if (r.next(m)) { return true; }
+    }
+    return false;
+}
+
+TEST_F(TestReqRep, Test_stats) {
+    ReqRep rep(NN_REP, "inproc://test_ReqRep_stats");
+    ReqRep req(NN_REQ, "inproc://test_ReqRep_stats");
+
+    MessageBuffer m;
+    req.setMsgOut(MessageBuffer("request"));
+    ASSERT_TRUE(receive(rep, m));
+    rep.setMsgOut(MessageBuffer("reply!"));
+    ASSERT_TRUE(receive(req, m));
+
+    ChannelStats & sq = req.getStats();
+    EXPECT_EQ(sq.msgsOut.load(), 1);
+    EXPECT_EQ(sq.bytesOut.load(), 7);
+    EXPECT_EQ(sq.msgsIn.load(), 1);
+    EXPECT_EQ(sq.bytesIn.load(), 6);
+    EXPECT_EQ(sq.rtt.count(), 1);
+
+    // Round trips are only measured by the requester
+    EXPECT_EQ(rep.getStats().msgsIn.load(), 1);
+    EXPECT_EQ(rep.getStats().rtt.count(), 0);
+}
+
+TEST_F(TestReqRep, Test_oneRequestAtATime) {
+    ReqRep rep(NN_REP, "inproc://test_ReqRep_one");
+    ReqRep req1(NN_REQ, "inproc://test_ReqRep_one");
+    ReqRep req2(NN_REQ, "inproc://test_ReqRep_one");
+    rep.setDrainBudget(64);
+
+    MessageBuffer m;
+    req1.setMsgOut(MessageBuffer("first"));
+    req2.setMsgOut(MessageBuffer("second"));
+    ASSERT_TRUE(receive(rep, m));
+    EXPECT_TRUE(rep.owesReply());
+    EXPECT_EQ(rep.getRecvFd(), -1);
+
+    // The second request stays in the socket until the first is answered
+    rep.update();
+    EXPECT_FALSE(rep.next(m));
+    rep.setMsgOut(MessageBuffer("reply"));
+    EXPECT_FALSE(rep.owesReply());
+    ASSERT_TRUE(receive(rep, m));
+
+    // Released without answer, the next reply has no request
+    rep.releaseRequest();
+    EXPECT_TRUE(rep.canReceive());
+    rep.setMsgOut(MessageBuffer("lost"));
+    EXPECT_EQ(rep.getStats().msgsOut.load(), 1);
+}
+
+TEST_F(TestReqRep, Test_ioThread) {
+    ReqRep rep(NN_REP, "inproc://test_ReqRep_io");
+    ReqRep req1(NN_REQ, "inproc://test_ReqRep_io");
+    ReqRep req2(NN_REQ, "inproc://test_ReqRep_io");
+    rep.startIoThread();
+
+    MessageBuffer m;
+    EXPECT_TRUE(req1.setMsgOut(MessageBuffer("first")));
+    EXPECT_TRUE(req2.setMsgOut(MessageBuffer("second")));
+    ASSERT_TRUE(receive(rep, m));
+
+    // The I/O thread leaves the second request in the socket
+    usleep(100000);
+    rep.update();
+    EXPECT_FALSE(rep.next(m));
+
+    // One reply per request
+    EXPECT_TRUE(rep.setMsgOut(MessageBuffer("reply")));
+    EXPECT_FALSE(rep.setMsgOut(MessageBuffer("again")));
+    ASSERT_TRUE(receive(rep, m));
+    EXPECT_EQ(m.str(), "second");
+    rep.stopIoThread();
+}
+
+TEST_F(TestReqRep, Test_replyAtOnce) {
+    // The reply may be queued as soon as the request is seen, while the
+    // I/O thread is still returning from its receive
+    ReqRep rep(NN_REP, "inproc://test_ReqRep_atOnce");
+    ReqRep req(NN_REQ, "inproc://test_ReqRep_atOnce");
+    rep.startIoThread();
+
+    MessageBuffer m;
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(req.setMsgOut(MessageBuffer("request")));
+        struct pollfd pfd = {rep.getRecvFd(), POLLIN, 0};
+        bool got = false;
+        while (!got && (poll(&pfd, 1, 2000) > 0)) {
+            rep.update();
+            got = rep.next(m);
+        }
+        ASSERT_TRUE(got);
+        ASSERT_TRUE(rep.setMsgOut(MessageBuffer("reply")));
+        ASSERT_TRUE(receive(req, m));
+        EXPECT_EQ(m.str(), "reply");
+    }
+    rep.stopIoThread();
+}
+
+}
@@ -0,0 +1,69 @@
+#include "test_ShmRing.h"
+
+#include <poll.h>
+
+namespace TestShmRing {
+
+static int receive(ShmRing & r, int numMsgs, std::vector<std::string> & msgs)
+{
+    MessageBuffer m;
+    struct pollfd pfd = {r.getRecvFd(), POLLIN, 0};
+    while ((msgs.size() < numMsgs) && (poll(&pfd, 1, 2000) > 0)) {
+        r.update();
+        while (r.next(m)) { msgs.push_back(m.str()); }
+    }
+    return msgs.size();
+}
+
+TEST_F(TestShmRing, Test_pipeline) {
+    // The attaching end may come first; messages wrap around the ring
+    ShmRing pull(NN_PULL, "shm://test_ShmRing_pipeline", 4096);
+    ShmRing push(NN_PUSH, "shm://test_ShmRing_pipeline", 4096);
+    EXPECT_TRUE(push.isAttached());
+
+    const int NumMsgs = 1000;
+    for (int i = 0; i < NumMsgs; ++i) {
+        push.setMsgOut(MessageBuffer(std::string(100, 'a' + (i % 26)) +
+                                     std::to_string(i)));
+    }
+
+    std::vector<std::string> msgs;
+    EXPECT_EQ(receive(pull, NumMsgs, msgs), NumMsgs);
+    for (int i = 0; i < msgs.size(); ++i) {
+        EXPECT_EQ(msgs.at(i), std::string(100, 'a' + (i % 26)) +
+                  std::to_string(i));
+    }
+}
+
+TEST_F(TestShmRing, Test_largeMessages) {
+    // Messages larger than the ring go in pieces, and keep their order
+    ShmRing push(NN_PUSH, "shm://test_ShmRing_large", 4096);
+    ShmRing pull(NN_PULL, "shm://test_ShmRing_large", 4096);
+
+    std::vector<std::string> sent;
+    for (int i = 0; i < 20; ++i) {
+        sent.push_back(std::string((i % 2) ? 100 : 10000 + i, 'a' + i));
+        EXPECT_TRUE(push.setMsgOut(MessageBuffer(sent.back())));
+    }
+
+    std::vector<std::string> msgs;
+    EXPECT_EQ(receive(pull, sent.size(), msgs), sent.size());
+    EXPECT_EQ(msgs, sent);
+}
+
+TEST_F(TestShmRing, Test_reqRep) {
+    ShmRing rep(NN_REP, "shm://test_ShmRing_reqRep");
+    ShmRing req(NN_REQ, "shm://test_ShmRing_reqRep");
+
+    std::vector<std::string> msgs;
+    req.setMsgOut(MessageBuffer("request"));
+    ASSERT_EQ(receive(rep, 1, msgs), 1);
+    EXPECT_EQ(msgs.at(0), "request");
+
+    msgs.clear();
+    rep.setMsgOut(MessageBuffer("reply"));
+    ASSERT_EQ(receive(req, 1, msgs), 1);
+    EXPECT_EQ(msgs.at(0), "reply");
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef TEST_SHMRING_H
+#define TEST_SHMRING_H
+
+#include "shmring.h"
+#include "gtest/gtest.h"
+
+//using namespace ShmRing;
+
+namespace TestShmRing {
+
+class TestShmRing : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestShmRing() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestShmRing() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // ShmRing::obj ev;
+};
+
+class TestShmRingExit : public TestShmRing {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestShmRingExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestShmRingExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_SHMRING_H
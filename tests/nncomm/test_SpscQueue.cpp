@@ -0,0 +1,57 @@
+#include "test_SpscQueue.h"
+
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace TestSpscQueue {
+
+TEST_F(TestSpscQueue, Test_pushPop) {
+    SpscQueue<int> q(3);
+    EXPECT_EQ(q.capacity(), 4);
+
+    int x;
+    EXPECT_FALSE(q.pop(x));
+    for (int i = 0; i < 4; ++i) { EXPECT_TRUE(q.push(int(i))); }
+    EXPECT_TRUE(q.full());
+    EXPECT_FALSE(q.push(4));
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(q.pop(x));
+        EXPECT_EQ(x, i);
+    }
+    EXPECT_TRUE(q.empty());
+}
+
+TEST_F(TestSpscQueue, Test_threads) {
+    const int NumItems = 100000;
+    SpscQueue<int> q(64);
+
+    std::thread producer([&q, NumItems]() {
+            for (int i = 0; i < NumItems; ++i) {
+                while (!q.push(int(i))) { std::this_thread::yield(); }
+            }
+        });
+
+    int x;
+    for (int i = 0; i < NumItems; ++i) {
+        while (!q.pop(x)) { std::this_thread::yield(); }
+        EXPECT_EQ(x, i);
+    }
+    producer.join();
+    EXPECT_TRUE(q.empty());
+}
+
+TEST_F(TestSpscQueue, Test_cacheAligned) {
+    struct Holder : public CacheAligned {
+        char           c;
+        SpscQueue<int> q;
+    };
+    std::vector<Holder *> hs;
+    for (int i = 0; i < 8; ++i) {
+        hs.push_back(new Holder);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(hs.back()) % CACHE_LINE_SIZE, 0u);
+    }
+    for (auto h : hs) { delete h; }
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef TEST_SPSCQUEUE_H
+#define TEST_SPSCQUEUE_H
+
+#include "spscq.h"
+#include "gtest/gtest.h"
+
+//using namespace SpscQueue;
+
+namespace TestSpscQueue {
+
+class TestSpscQueue : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestSpscQueue() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestSpscQueue() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // SpscQueue::obj ev;
+};
+
+class TestSpscQueueExit : public TestSpscQueue {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestSpscQueueExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestSpscQueueExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_SPSCQUEUE_H
@@ -1,5 +1,7 @@
 #include "test_Survey.h"
 
+#include <poll.h>
+
 //#define CheckResultOf(s,r) do {                                         \
 //    ev.clear();                                                         \
 //    ev.set(std::string( #s ));                                          \
@@ -16,4 +18,73 @@ TEST_F(TestSurvey, Test_setNumOfRespondents) {
     
 }
 
+// Answers the pending survey, if any
+static void answer(Survey & r, std::string s)
+{
+    MessageBuffer m;
+    r.update();
+    if (r.next(m)) { r.setMsgOut(MessageBuffer(s)); }
+}
+
+// Waits on the surveyor descriptor, as the component loop does
+static bool waitResult(Survey & s, SurveyResult & res, int ms)
+{
+    int fd = s.getRecvFd();
+    struct pollfd pfd = {fd, POLLIN, 0};
+    while ((fd >= 0) && (poll(&pfd, 1, ms) > 0)) {
+        s.update();
+        if (s.nextResult(res)) { return true; }
+        fd = pfd.fd = s.getRecvFd();
+    }
+    return s.nextResult(res);
+}
+
+TEST_F(TestSurvey, Test_allAnswered) {
+    Survey surveyor(NN_SURVEYOR, "inproc://test_Survey_allAnswered");
+    Survey r1(NN_RESPONDENT, "inproc://test_Survey_allAnswered");
+    Survey r2(NN_RESPONDENT, "inproc://test_Survey_allAnswered");
+    surveyor.setNumOfRespondents(2);
+    surveyor.setDeadline(5000);
+
+    auto t0 = std::chrono::steady_clock::now();
+    surveyor.setMsgOut(MessageBuffer("who?"));
+    EXPECT_GE(surveyor.getRecvFd(), 0);
+    answer(r1, "r1");
+    answer(r2, "r2");
+
+    SurveyResult res;
+    ASSERT_TRUE(waitResult(surveyor, res, 2000));
+    EXPECT_TRUE(res.complete);
+    EXPECT_EQ(res.responses.size(), 2);
+    EXPECT_LT(std::chrono::steady_clock::now() - t0, std::chrono::seconds(2));
+    EXPECT_LT(surveyor.getRecvFd(), 0);
+}
+
+TEST_F(TestSurvey, Test_deadline) {
+    Survey surveyor(NN_SURVEYOR, "inproc://test_Survey_deadline");
+    Survey r1(NN_RESPONDENT, "inproc://test_Survey_deadline");
+    Survey r2(NN_RESPONDENT, "inproc://test_Survey_deadline");
+    surveyor.setNumOfRespondents(2);
+    surveyor.setDeadline(200);
+
+    int delivered = 0;
+    surveyor.setResultHandler([&](SurveyResult & r) {
+            ++delivered;
+            EXPECT_FALSE(r.complete);
+            EXPECT_EQ(r.responses.size(), 1);
+        });
+
+    surveyor.setMsgOut(MessageBuffer("who?"));
+    answer(r1, "r1");
+
+    // Nothing else arrives: the deadline alone wakes the surveyor up
+    int fd = surveyor.getRecvFd();
+    struct pollfd pfd = {fd, POLLIN, 0};
+    while ((delivered == 0) && (fd >= 0) && (poll(&pfd, 1, 1000) > 0)) {
+        surveyor.update();
+        fd = pfd.fd = surveyor.getRecvFd();
+    }
+    EXPECT_EQ(delivered, 1);
+}
+
 }           
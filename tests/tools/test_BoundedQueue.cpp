@@ -0,0 +1,48 @@
+#include "test_BoundedQueue.h"
+
+#include <thread>
+#include <vector>
+
+namespace TestBoundedQueue {
+
+TEST_F(TestBoundedQueue, Test_pushPop) {
+    BoundedQueue<int> q(3);
+    EXPECT_EQ(q.capacity(), 4);
+
+    int x;
+    EXPECT_FALSE(q.pop(x));
+    for (int i = 0; i < 4; ++i) { EXPECT_TRUE(q.push(i)); }
+    EXPECT_FALSE(q.push(4));
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(q.pop(x));
+        EXPECT_EQ(x, i);
+    }
+    EXPECT_FALSE(q.pop(x));
+}
+
+TEST_F(TestBoundedQueue, Test_producers) {
+    const int NumProducers = 4;
+    const int NumItems = 10000;
+    BoundedQueue<int> q(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < NumProducers; ++p) {
+        producers.push_back(std::thread([&q, NumItems]() {
+                    for (int i = 1; i <= NumItems; ++i) {
+                        while (! q.push(i)) { std::this_thread::yield(); }
+                    }
+                }));
+    }
+
+    long long sum = 0;
+    int x, n = 0;
+    while (n < NumProducers * NumItems) {
+        if (q.pop(x)) { sum += x; ++n; } else { std::this_thread::yield(); }
+    }
+    for (auto & t : producers) { t.join(); }
+
+    EXPECT_EQ(sum, (long long)NumProducers * NumItems * (NumItems + 1) / 2);
+    EXPECT_FALSE(q.pop(x));
+}
+
+}
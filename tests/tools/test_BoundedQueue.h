@@ -0,0 +1,66 @@
+#ifndef TEST_BOUNDEDQUEUE_H
+#define TEST_BOUNDEDQUEUE_H
+
+#include "bndqueue.h"
+#include "gtest/gtest.h"
+
+//using namespace BoundedQueue;
+
+namespace TestBoundedQueue {
+
+class TestBoundedQueue : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestBoundedQueue() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestBoundedQueue() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // BoundedQueue::obj ev;
+};
+
+class TestBoundedQueueExit : public TestBoundedQueue {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestBoundedQueueExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestBoundedQueueExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_BOUNDEDQUEUE_H
@@ -0,0 +1,80 @@
+#include "test_OverflowQueue.h"
+
+#include <thread>
+
+namespace TestOverflowQueue {
+
+TEST_F(TestOverflowQueue, Test_dropOldest) {
+    OverflowQueue<int> q("test.dropOldest", 3, OverflowQueueBase::DropOldest);
+    for (int i = 0; i < 5; ++i) { q.push(i); }
+    EXPECT_EQ(q.size(), 3);
+
+    int x;
+    for (int i = 2; i < 5; ++i) {
+        EXPECT_TRUE(q.pop(x));
+        EXPECT_EQ(x, i);
+    }
+    EXPECT_FALSE(q.pop(x));
+
+    OverflowQueueBase::Stats st = q.stats();
+    EXPECT_EQ(st.pushed, 5);
+    EXPECT_EQ(st.dropped, 2);
+    EXPECT_EQ(st.highWater, 3);
+}
+
+TEST_F(TestOverflowQueue, Test_coalesce) {
+    OverflowQueue<int> q("test.coalesce", 0, OverflowQueueBase::Coalesce);
+    q.push(1, "a");
+    q.push(2, "b");
+    q.push(3, "a");
+    q.push(4);
+    q.push(5);
+
+    std::list<std::pair<std::string, int>> v;
+    q.takeAll(v);
+    ASSERT_EQ(v.size(), 4);
+    auto it = v.begin();
+    EXPECT_EQ(it->first, "a"); EXPECT_EQ(it->second, 3); ++it;
+    EXPECT_EQ(it->first, "b"); EXPECT_EQ(it->second, 2); ++it;
+    EXPECT_EQ(it->second, 4); ++it;
+    EXPECT_EQ(it->second, 5);
+    EXPECT_EQ(q.stats().coalesced, 1);
+
+    // Once taken, a key starts a new element
+    q.push(6, "a");
+    EXPECT_EQ(q.size(), 1);
+}
+
+TEST_F(TestOverflowQueue, Test_block) {
+    OverflowQueue<int> q("test.block", 1, OverflowQueueBase::Block, 1000);
+    q.push(1);
+    std::thread consumer([&q]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            int x;
+            q.pop(x);
+        });
+    // Waits for the consumer, nothing is dropped
+    EXPECT_TRUE(q.push(2));
+    consumer.join();
+    EXPECT_EQ(q.stats().dropped, 0);
+
+    // Without a consumer the new element is rejected, and the queued
+    // one kept
+    OverflowQueue<int> r("test.reject", 1, OverflowQueueBase::Block, 10);
+    EXPECT_TRUE(r.push(1));
+    EXPECT_FALSE(r.push(2));
+    int x;
+    EXPECT_TRUE(r.pop(x));
+    EXPECT_EQ(x, 1);
+    EXPECT_FALSE(r.pop(x));
+    EXPECT_EQ(r.stats().dropped, 0);
+    EXPECT_EQ(r.stats().rejected, 1);
+
+    bool found = false;
+    for (auto & st : OverflowQueueBase::allStats()) {
+        if (st.name == "test.block") { found = true; }
+    }
+    EXPECT_TRUE(found);
+}
+
+}
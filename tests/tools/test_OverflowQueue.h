@@ -0,0 +1,66 @@
+#ifndef TEST_OVERFLOWQUEUE_H
+#define TEST_OVERFLOWQUEUE_H
+
+#include "ovfqueue.h"
+#include "gtest/gtest.h"
+
+//using namespace OverflowQueue;
+
+namespace TestOverflowQueue {
+
+class TestOverflowQueue : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestOverflowQueue() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestOverflowQueue() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // OverflowQueue::obj ev;
+};
+
+class TestOverflowQueueExit : public TestOverflowQueue {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestOverflowQueueExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestOverflowQueueExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_OVERFLOWQUEUE_H
@@ -0,0 +1,78 @@
+#include "test_TimerWheel.h"
+
+#include <atomic>
+
+namespace TestTimerWheel {
+
+TEST_F(TestTimerWheel, Test_oneShot) {
+    TimerWheel w;
+    std::atomic<int> n(0);
+    auto t0 = std::chrono::steady_clock::now();
+    std::atomic<long> elapsed(0);
+    w.schedule(50, [&]() {
+            elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+            ++n;
+        });
+    EXPECT_EQ(w.size(), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_EQ(n, 1);
+    EXPECT_GE(elapsed, 40);
+    EXPECT_EQ(w.size(), 0);
+}
+
+TEST_F(TestTimerWheel, Test_periodicAndCancel) {
+    TimerWheel w;
+    std::atomic<int> n(0);
+    TimerWheel::TimerId id = w.schedule(20, [&]() { ++n; }, 20);
+    std::this_thread::sleep_for(std::chrono::milliseconds(210));
+    EXPECT_TRUE(w.cancel(id));
+    int fired = n;
+    EXPECT_GE(fired, 5);
+    EXPECT_LE(fired, 11);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(n, fired);
+    EXPECT_FALSE(w.cancel(id));
+}
+
+TEST_F(TestTimerWheel, Test_cancelWaitsForCallback) {
+    TimerWheel w;
+    std::atomic<bool> started(false);
+    std::atomic<bool> done(false);
+    TimerWheel::TimerId id = w.schedule(10, [&]() {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            done = true;
+        }, 10);
+    while (! started) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    // The callback running is not interrupted, but is over on return
+    EXPECT_TRUE(w.cancel(id));
+    EXPECT_TRUE(done);
+
+    // A timer may cancel itself from its callback
+    std::atomic<int> n(0);
+    TimerWheel::TimerId self = TimerWheel::InvalidTimer;
+    std::atomic<bool> armed(false);
+    self = w.schedule(10, [&]() {
+            while (! armed) { std::this_thread::yield(); }
+            ++n;
+            w.cancel(self);
+        }, 10);
+    armed = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(n, 1);
+}
+
+TEST_F(TestTimerWheel, Test_cascade) {
+    // Beyond the span of the first level (256 ticks)
+    TimerWheel w;
+    std::atomic<int> n(0);
+    w.schedule(2700, [&]() { ++n; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+    EXPECT_EQ(n, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    EXPECT_EQ(n, 1);
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef TEST_TIMERWHEEL_H
+#define TEST_TIMERWHEEL_H
+
+#include "timer.h"
+#include "gtest/gtest.h"
+
+//using namespace TimerWheel;
+
+namespace TestTimerWheel {
+
+class TestTimerWheel : public ::testing::Test {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestTimerWheel() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestTimerWheel() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+    // TimerWheel::obj ev;
+};
+
+class TestTimerWheelExit : public TestTimerWheel {
+
+protected:
+    // You can remove any or all of the following functions if its body
+    // is empty.
+
+    // You can do set-up work for each test here.
+    TestTimerWheelExit() {}
+
+    // You can do clean-up work that doesn't throw exceptions here.
+    virtual ~TestTimerWheelExit() {}
+
+    // If the constructor and destructor are not enough for setting up
+    // and cleaning up each test, you can define the following methods:
+
+    // Code here will be called immediately after the constructor (right
+    // before each test).
+    virtual void SetUp() {}
+
+    // Code here will be called immediately after each test (right
+    // before the destructor).
+    virtual void TearDown() {}
+
+    // Objects declared here can be used by all tests in the test case for Foo.
+};
+
+}
+
+#endif // TEST_TIMERWHEEL_H
@@ -0,0 +1,158 @@
+/******************************************************************************
+ * File:    bndqueue.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.BoundedQueue
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declaration of BoundedQueue
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+#ifndef BNDQUEUE_H
+#define BNDQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+//======================================================================
+// Class: BoundedQueue
+// Bounded lock-free queue, for any number of producers and consumers.
+// Each cell carries a sequence number that tells whether it is free
+// for the next push or holds data for the next pop (D. Vyukov's
+// algorithm).  push() fails instead of waiting when the queue is full.
+//======================================================================
+template<class T>
+class BoundedQueue {
+public:
+    //----------------------------------------------------------------------
+    // Constructor
+    // The capacity is rounded up to the next power of 2
+    //----------------------------------------------------------------------
+    explicit BoundedQueue(size_t size) {
+        size_t n = 2;
+        while (n < size) { n <<= 1; }
+        mask = n - 1;
+        cells.reset(new Cell [n]);
+        for (size_t i = 0; i < n; ++i) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+        enqPos.store(0, std::memory_order_relaxed);
+        deqPos.store(0, std::memory_order_relaxed);
+    }
+
+    //----------------------------------------------------------------------
+    // Method: push
+    // Append an element, returns false if the queue is full
+    //----------------------------------------------------------------------
+    bool push(const T & x) {
+        Cell * c = claim(enqPos, 0);
+        if (c == 0) { return false; }
+        c->data = x;
+        c->seq.store(c->pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    //----------------------------------------------------------------------
+    // Method: push
+    // Append an element (moving it), returns false if the queue is full
+    //----------------------------------------------------------------------
+    bool push(T && x) {
+        Cell * c = claim(enqPos, 0);
+        if (c == 0) { return false; }
+        c->data = std::move(x);
+        c->seq.store(c->pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    //----------------------------------------------------------------------
+    // Method: pop
+    // Extract the oldest element, returns false if the queue is empty
+    //----------------------------------------------------------------------
+    bool pop(T & x) {
+        Cell * c = claim(deqPos, 1);
+        if (c == 0) { return false; }
+        x = std::move(c->data);
+        c->seq.store(c->pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    //----------------------------------------------------------------------
+    // Method: capacity
+    //----------------------------------------------------------------------
+    size_t capacity() const { return mask + 1; }
+
+private:
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue & operator=(const BoundedQueue &) = delete;
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        size_t              pos;
+        T                   data;
+    };
+
+    //----------------------------------------------------------------------
+    // Method: claim
+    // Reserve the cell at the position counter, if its sequence number
+    // is pos + lag (0 for push, 1 for pop); returns 0 otherwise
+    //----------------------------------------------------------------------
+    Cell * claim(std::atomic<size_t> & counter, size_t lag) {
+        size_t pos = counter.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell * c = &cells[pos & mask];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + lag);
+            if (dif == 0) {
+                if (counter.compare_exchange_weak(pos, pos + 1,
+                                                  std::memory_order_relaxed)) {
+                    c->pos = pos;
+                    return c;
+                }
+            } else if (dif < 0) {
+                return 0;
+            } else {
+                pos = counter.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::unique_ptr<Cell[]> cells;
+    size_t                  mask;
+
+    alignas(64) std::atomic<size_t> enqPos;
+    alignas(64) std::atomic<size_t> deqPos;
+};
+
+#endif // BNDQUEUE_H
@@ -0,0 +1,279 @@
+/******************************************************************************
+ * File:    ovfqueue.h
+ *          This file is part of QLA Processing Framework
+ *
+ * Domain:  QPF.OverflowQueue
+ *
+ * Version:  2.0
+ *
+ * Date:    2018/04/10
+ *
+ * Author:   J C Gonzalez
+ *
+ * Copyright (C) 2015-2018 Euclid SOC Team @ ESAC
+ *_____________________________________________________________________________
+ *
+ * Topic: General Information
+ *
+ * Purpose:
+ *   Declaration of OverflowQueue
+ *
+ * Created by:
+ *   J C Gonzalez
+ *
+ * Status:
+ *   Prototype
+ *
+ * Dependencies:
+ *   none
+ *
+ * Files read / modified:
+ *   none
+ *
+ * History:
+ *   See <Changelog>
+ *
+ * About: License Conditions
+ *   See <License>
+ *
+ ******************************************************************************/
+#ifndef OVFQUEUE_H
+#define OVFQUEUE_H
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <utility>
+#include <iterator>
+#include <cstdint>
+
+//======================================================================
+// Class: OverflowQueueBase
+// Name, policy and counters of a queue, and the registry of the queues
+// of the process, so that their depth and drops can be inspected
+//======================================================================
+class OverflowQueueBase {
+public:
+    // What to do with a new element when the queue is full:
+    //  - Block: wait (up to blockMs) for the consumer to make room, and
+    //    then reject the new element, which the producer keeps to push
+    //    it again later; nothing is dropped
+    //  - DropOldest: drop the oldest element
+    //  - Coalesce: replace the queued element with the same key, if any,
+    //    keeping its position; otherwise drop the oldest element
+    enum Policy { Block, DropOldest, Coalesce };
+
+    struct Stats {
+        std::string name;
+        size_t      depth;
+        size_t      capacity;
+        size_t      highWater;
+        uint64_t    pushed;
+        uint64_t    dropped;
+        uint64_t    coalesced;
+        uint64_t    rejected;
+    };
+
+    //----------------------------------------------------------------------
+    // Static Method: policyFromName
+    // "block", "dropOldest" or "coalesce" (default: dflt)
+    //----------------------------------------------------------------------
+    static Policy policyFromName(const std::string & s, Policy dflt) {
+        if (s == "block")      { return Block; }
+        if (s == "dropOldest") { return DropOldest; }
+        if (s == "coalesce")   { return Coalesce; }
+        return dflt;
+    }
+
+    //----------------------------------------------------------------------
+    // Static Method: allStats
+    // Return the counters of all the queues in the process
+    //----------------------------------------------------------------------
+    static std::vector<Stats> allStats() {
+        std::vector<Stats> v;
+        std::unique_lock<std::mutex> ulck(registryMutex());
+        for (auto q : registry()) { v.push_back(q->stats()); }
+        return v;
+    }
+
+    //----------------------------------------------------------------------
+    // Method: stats
+    //----------------------------------------------------------------------
+    virtual Stats stats() = 0;
+
+protected:
+    explicit OverflowQueueBase(const std::string & n) : name(n) {
+        std::unique_lock<std::mutex> ulck(registryMutex());
+        registry().insert(this);
+    }
+
+    virtual ~OverflowQueueBase() {
+        std::unique_lock<std::mutex> ulck(registryMutex());
+        registry().erase(this);
+    }
+
+    std::string name;
+
+private:
+    static std::set<OverflowQueueBase*> & registry() {
+        static std::set<OverflowQueueBase*> r;
+        return r;
+    }
+
+    static std::mutex & registryMutex() {
+        static std::mutex m;
+        return m;
+    }
+};
+
+//======================================================================
+// Class: OverflowQueue
+// FIFO queue with an optional capacity (0 means no limit) and an
+// overflow policy.  Elements may carry a key, used by the Coalesce
+// policy (elements with an empty key are never coalesced).  All methods
+// are thread safe.
+//======================================================================
+template<class T, class Key = std::string>
+class OverflowQueue : public OverflowQueueBase {
+public:
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    explicit OverflowQueue(const std::string & n, size_t cap = 0,
+                           Policy p = DropOldest, int blkMs = 100)
+        : OverflowQueueBase(n), capacity(cap), policy(p), blockMs(blkMs),
+          highWater(0), pushed(0), dropped(0), coalesced(0), rejected(0) {}
+
+    //----------------------------------------------------------------------
+    // Method: configure
+    //----------------------------------------------------------------------
+    void configure(size_t cap, Policy p) {
+        std::unique_lock<std::mutex> ulck(mtx);
+        capacity = cap;
+        policy   = p;
+        cvRoom.notify_all();
+    }
+
+    //----------------------------------------------------------------------
+    // Method: push
+    // Append an element; returns false if an element was dropped, or if
+    // the new one was rejected (Block)
+    //----------------------------------------------------------------------
+    bool push(T x, const Key & key = Key()) {
+        std::unique_lock<std::mutex> ulck(mtx);
+        ++pushed;
+
+        if ((policy == Coalesce) && (key != Key())) {
+            auto it = index.find(key);
+            if (it != index.end()) {
+                it->second->second = std::move(x);
+                ++coalesced;
+                return true;
+            }
+        }
+
+        if ((policy == Block) && (capacity > 0) && (items.size() >= capacity)) {
+            if ((blockMs <= 0) ||
+                (! cvRoom.wait_for(ulck, std::chrono::milliseconds(blockMs),
+                                   [this]() { return ((capacity == 0) ||
+                                                      (items.size() < capacity)); }))) {
+                ++rejected;
+                return false;
+            }
+        }
+
+        bool dropping = (capacity > 0) && (items.size() >= capacity);
+        if (dropping) {
+            unindex(items.front().first);
+            items.pop_front();
+            ++dropped;
+        }
+
+        items.push_back(std::make_pair(key, std::move(x)));
+        if ((policy == Coalesce) && (key != Key())) {
+            index[key] = std::prev(items.end());
+        }
+        if (items.size() > highWater) { highWater = items.size(); }
+        return !dropping;
+    }
+
+    //----------------------------------------------------------------------
+    // Method: pop
+    // Extract the oldest element, returns false if the queue is empty
+    //----------------------------------------------------------------------
+    bool pop(T & x) {
+        std::unique_lock<std::mutex> ulck(mtx);
+        if (items.empty()) { return false; }
+        x = std::move(items.front().second);
+        unindex(items.front().first);
+        items.pop_front();
+        cvRoom.notify_one();
+        return true;
+    }
+
+    //----------------------------------------------------------------------
+    // Method: takeAll
+    // Extract all the elements, in order, with their keys
+    //----------------------------------------------------------------------
+    void takeAll(std::list<std::pair<Key, T>> & v) {
+        std::unique_lock<std::mutex> ulck(mtx);
+        v.splice(v.end(), items);
+        index.clear();
+        cvRoom.notify_all();
+    }
+
+    //----------------------------------------------------------------------
+    // Method: size
+    //----------------------------------------------------------------------
+    size_t size() {
+        std::unique_lock<std::mutex> ulck(mtx);
+        return items.size();
+    }
+
+    //----------------------------------------------------------------------
+    // Method: empty
+    //----------------------------------------------------------------------
+    bool empty() { return size() == 0; }
+
+    //----------------------------------------------------------------------
+    // Method: stats
+    //----------------------------------------------------------------------
+    virtual Stats stats() {
+        std::unique_lock<std::mutex> ulck(mtx);
+        return Stats {name, items.size(), capacity, highWater,
+                      pushed, dropped, coalesced, rejected};
+    }
+
+private:
+    OverflowQueue(const OverflowQueue &) = delete;
+    OverflowQueue & operator=(const OverflowQueue &) = delete;
+
+    typedef std::list<std::pair<Key, T>> Items;
+
+    void unindex(const Key & key) {
+        if (key != Key()) { index.erase(key); }
+    }
+
+    Items                                        items;
+    std::map<Key, typename Items::iterator>      index;
+
+    size_t   capacity;
+    Policy   policy;
+    int      blockMs;
+
+    size_t   highWater;
+    uint64_t pushed;
+    uint64_t dropped;
+    uint64_t coalesced;
+    uint64_t rejected;
+
+    std::mutex              mtx;
+    std::condition_variable cvRoom;
+};
+
+#endif // OVFQUEUE_H
@@ -16,7 +16,7 @@
  * Topic: General Information
  *
  * Purpose:
- *   Instantiate Timer class
+ *   Implement TimerWheel class
  *
  * Created by:
  *   J C Gonzalez
@@ -39,3 +39,223 @@
  ******************************************************************************/
 
 #include "timer.h"
+
+#include <algorithm>
+
+const TimerWheel::TimerId TimerWheel::InvalidTimer = 0;
+const int                 TimerWheel::TickMs       = 10;
+
+//----------------------------------------------------------------------
+// Static Method: instance
+//----------------------------------------------------------------------
+TimerWheel & TimerWheel::instance()
+{
+    static TimerWheel wheel;
+    return wheel;
+}
+
+//----------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------
+TimerWheel::TimerWheel()
+    : epoch(std::chrono::steady_clock::now()),
+      currentTick(0), lastId(InvalidTimer), running(InvalidTimer), quit(false)
+{
+    levels[0].resize(1 << L0Bits);
+    for (int l = 1; l < NumLevels; ++l) { levels[l].resize(1 << LnBits); }
+    thr = std::thread(&TimerWheel::serve, this);
+}
+
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+TimerWheel::~TimerWheel()
+{
+    {
+        std::unique_lock<std::mutex> ulck(mtx);
+        quit = true;
+    }
+    cv.notify_one();
+    if (thr.joinable()) { thr.join(); }
+}
+
+//----------------------------------------------------------------------
+// Method: schedule
+//----------------------------------------------------------------------
+TimerWheel::TimerId TimerWheel::schedule(int afterMs, Callback cb, int periodMs)
+{
+    uint64_t after  = (afterMs  > 0) ? (afterMs  + TickMs - 1) / TickMs : 0;
+    uint64_t period = (periodMs > 0) ? (periodMs + TickMs - 1) / TickMs : 0;
+
+    TimerId id;
+    {
+        std::unique_lock<std::mutex> ulck(mtx);
+        id = ++lastId;
+        // The wheel may lag behind the clock, while its thread sleeps
+        uint64_t base = std::max(currentTick, nowTicks());
+        Slot pending;
+        pending.push_back({id, base + std::max(after, (uint64_t)(1)), period, cb});
+        place(pending, pending.begin());
+    }
+    cv.notify_one();
+    return id;
+}
+
+//----------------------------------------------------------------------
+// Method: cancel
+//----------------------------------------------------------------------
+bool TimerWheel::cancel(TimerId id)
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    auto it = index.find(id);
+    if (it == index.end()) {
+        // The callback may be about to run, or running right now
+        if (firing.count(id) == 0) { return false; }
+        cancelled.insert(id);
+        if (std::this_thread::get_id() != thr.get_id()) {
+            cvDone.wait(ulck, [this, id]() { return running != id; });
+        }
+        return true;
+    }
+    it->second.first->erase(it->second.second);
+    index.erase(it);
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Method: size
+//----------------------------------------------------------------------
+size_t TimerWheel::size()
+{
+    std::unique_lock<std::mutex> ulck(mtx);
+    return index.size();
+}
+
+//----------------------------------------------------------------------
+// Method: nowTicks
+//----------------------------------------------------------------------
+uint64_t TimerWheel::nowTicks()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - epoch).count() / TickMs;
+}
+
+//----------------------------------------------------------------------
+// Method: place
+//----------------------------------------------------------------------
+void TimerWheel::place(Slot & from, Slot::iterator it)
+{
+    uint64_t expires = it->expires;
+    if (expires <= currentTick) { expires = currentTick; }
+    uint64_t delta = expires - currentTick;
+
+    Slot * slot;
+    if (delta < (1 << L0Bits)) {
+        slot = &levels[0][expires & ((1 << L0Bits) - 1)];
+    } else {
+        int l = 1;
+        int shift = L0Bits;
+        while ((l < NumLevels - 1) && (delta >= (uint64_t(1) << (shift + LnBits)))) {
+            ++l;
+            shift += LnBits;
+        }
+        uint64_t maxDelta = (uint64_t(1) << (shift + LnBits)) - 1;
+        if (delta > maxDelta) {
+            // Beyond the wheel span: park it in the farthest slot, it
+            // will be placed again when cascaded
+            expires = currentTick + maxDelta;
+        }
+        slot = &levels[l][(expires >> shift) & ((1 << LnBits) - 1)];
+    }
+
+    slot->splice(slot->end(), from, it);
+    index[it->id] = std::make_pair(slot, it);
+}
+
+//----------------------------------------------------------------------
+// Method: tick
+//----------------------------------------------------------------------
+void TimerWheel::tick(Slot & fired)
+{
+    // Cascade the upper levels when the lower one wraps around
+    int shift = L0Bits;
+    for (int l = 1; l < NumLevels; ++l) {
+        if ((currentTick & ((uint64_t(1) << shift) - 1)) != 0) { break; }
+        Slot & s = levels[l][(currentTick >> shift) & ((1 << LnBits) - 1)];
+        while (! s.empty()) { place(s, s.begin()); }
+        shift += LnBits;
+    }
+
+    Slot & s = levels[0][currentTick & ((1 << L0Bits) - 1)];
+    while (! s.empty()) {
+        index.erase(s.front().id);
+        firing.insert(s.front().id);
+        fired.splice(fired.end(), s, s.begin());
+    }
+    ++currentTick;
+}
+
+//----------------------------------------------------------------------
+// Method: ticksToNextExpiry
+//----------------------------------------------------------------------
+uint64_t TimerWheel::ticksToNextExpiry()
+{
+    // Look for the next busy slot in the first level, up to the next
+    // cascade (which may bring timers down)
+    uint64_t pos = currentTick & ((1 << L0Bits) - 1);
+    uint64_t toCascade = (1 << L0Bits) - pos;
+    for (uint64_t d = 0; d < toCascade; ++d) {
+        if (! levels[0][pos + d].empty()) { return d; }
+    }
+    return toCascade;
+}
+
+//----------------------------------------------------------------------
+// Method: serve
+//----------------------------------------------------------------------
+void TimerWheel::serve()
+{
+    Slot fired;
+    std::unique_lock<std::mutex> ulck(mtx);
+    while (! quit) {
+        uint64_t now = nowTicks();
+        while (currentTick <= now) { tick(fired); }
+
+        if (! fired.empty()) {
+            // Callbacks are run without holding the lock, so they can
+            // schedule or cancel timers.  Those cancelled meanwhile are
+            // skipped, and cancel waits for the one running
+            for (auto & e : fired) {
+                if (cancelled.count(e.id) > 0) { continue; }
+                running = e.id;
+                ulck.unlock();
+                e.cb();
+                ulck.lock();
+                running = InvalidTimer;
+                cvDone.notify_all();
+            }
+
+            // Re-arm periodic timers, unless cancelled meanwhile
+            while (! fired.empty()) {
+                Entry & e = fired.front();
+                bool wasCancelled = (cancelled.erase(e.id) > 0);
+                firing.erase(e.id);
+                if ((e.period > 0) && (! wasCancelled)) {
+                    e.expires += e.period;
+                    if (e.expires < currentTick) { e.expires = currentTick; }
+                    place(fired, fired.begin());
+                } else {
+                    fired.pop_front();
+                }
+            }
+            continue;
+        }
+
+        if (index.empty()) {
+            cv.wait(ulck);
+        } else {
+            uint64_t due = currentTick + ticksToNextExpiry();
+            cv.wait_until(ulck, epoch + std::chrono::milliseconds(due * TickMs));
+        }
+    }
+}
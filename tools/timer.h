@@ -16,7 +16,7 @@
  * Topic: General Information
  *
  * Purpose:
- *   Declare timer class
+ *   Declare Timer and TimerWheel classes
  *
  * Created by:
  *   J C Gonzalez
@@ -50,10 +50,24 @@
 //   - functional
 //   - chrono
 //   - future
+//   - thread
+//   - mutex
+//   - condition_variable
+//   - list
+//   - map
+//   - set
 //------------------------------------------------------------
 #include <functional>
 #include <chrono>
 #include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+#include <cstdint>
 
 //------------------------------------------------------------
 // Topic: External packages
@@ -65,8 +79,127 @@
 //   none
 //------------------------------------------------------------
 
+//==========================================================================
+// Class: TimerWheel
+// Process-wide hierarchical timer wheel, served by a single thread.
+//
+// Timers are kept in four levels of slots: the first one covers the next
+// 256 ticks, one slot per tick, and each of the other levels covers 64
+// times the span of the previous one.  Timers in the upper levels are
+// cascaded down as time goes by, so adding, cancelling and expiring a
+// timer are O(1).  Callbacks run in the wheel thread, and must be short;
+// components marshal them onto their own thread (see Component::startTimer)
+//==========================================================================
+class TimerWheel {
+
+public:
+    typedef uint64_t              TimerId;
+    typedef std::function<void()> Callback;
+
+    static const TimerId InvalidTimer;
+    static const int     TickMs;
+
+    //----------------------------------------------------------------------
+    // Static Method: instance
+    // Return the process timer wheel, starting its thread on first use
+    //----------------------------------------------------------------------
+    static TimerWheel & instance();
+
+    //----------------------------------------------------------------------
+    // Constructor
+    //----------------------------------------------------------------------
+    TimerWheel();
+
+    //----------------------------------------------------------------------
+    // Destructor
+    //----------------------------------------------------------------------
+    ~TimerWheel();
+
+    //----------------------------------------------------------------------
+    // Method: schedule
+    // Call cb after afterMs ms, and then every periodMs ms if periodMs > 0
+    //----------------------------------------------------------------------
+    TimerId schedule(int afterMs, Callback cb, int periodMs = 0);
+
+    //----------------------------------------------------------------------
+    // Method: cancel
+    // Remove the timer; a callback already running is not interrupted,
+    // but will not be repeated, and cancel waits for it to end (unless
+    // called from the callback itself), so that what the callback uses
+    // may be released next.  Returns false if the timer was not found
+    // (expired or cancelled)
+    //----------------------------------------------------------------------
+    bool cancel(TimerId id);
+
+    //----------------------------------------------------------------------
+    // Method: size
+    // Number of active timers
+    //----------------------------------------------------------------------
+    size_t size();
+
+private:
+    struct Entry {
+        TimerId  id;
+        uint64_t expires;   // in ticks
+        uint64_t period;    // in ticks, 0 for one-shot timers
+        Callback cb;
+    };
+    typedef std::list<Entry> Slot;
+
+    static const int NumLevels = 4;
+    static const int L0Bits    = 8;
+    static const int LnBits    = 6;
+
+    //----------------------------------------------------------------------
+    // Method: serve
+    // Main loop of the wheel thread
+    //----------------------------------------------------------------------
+    void serve();
+
+    //----------------------------------------------------------------------
+    // Method: place
+    // Move the entry at it (in list from) to the slot for its expiry time
+    //----------------------------------------------------------------------
+    void place(Slot & from, Slot::iterator it);
+
+    //----------------------------------------------------------------------
+    // Method: tick
+    // Advance the wheel one tick, moving the expired entries to fired
+    //----------------------------------------------------------------------
+    void tick(Slot & fired);
+
+    //----------------------------------------------------------------------
+    // Method: ticksToNextExpiry
+    // Upper bound of the number of ticks until the wheel has work to do
+    //----------------------------------------------------------------------
+    uint64_t ticksToNextExpiry();
+
+    //----------------------------------------------------------------------
+    // Method: nowTicks
+    //----------------------------------------------------------------------
+    uint64_t nowTicks();
+
+    std::vector<Slot> levels[NumLevels];
+    std::map<TimerId, std::pair<Slot *, Slot::iterator>> index;
+    std::set<TimerId> firing;
+    std::set<TimerId> cancelled;
+
+    std::chrono::steady_clock::time_point epoch;
+    uint64_t currentTick;
+    TimerId  lastId;
+    TimerId  running;    // Timer whose callback is being run
+
+    std::mutex              mtx;
+    std::condition_variable cv;
+    std::condition_variable cvDone;
+    bool                    quit;
+    std::thread             thr;
+};
+
 //==========================================================================
 // Class: Timer
+// Call a function after some time.  Asynchronous timers are served by
+// the process TimerWheel, instead of by a thread of their own
 //==========================================================================
 
 class Timer {
@@ -80,10 +213,7 @@ public:
                            std::forward<arguments>(args)...));
 
         if (async) {
-            std::thread([after, task]() {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(after));
-                    task();
-                }).detach();
+            TimerWheel::instance().schedule(after, [task]() { task(); });
         } else {
             std::this_thread::sleep_for(std::chrono::milliseconds(after));
             task();